@@ -0,0 +1,72 @@
+/**
+ * @file AgrupadorTramas.cpp
+ * @brief Implementación de la clase AgrupadorTramas.
+ */
+
+#include "AgrupadorTramas.h"
+#include "Metricas.h"
+
+AgrupadorTramas::AgrupadorTramas(ListaDeCarga* carga, RotorDeMapeo* rotor)
+    : carga(carga), rotor(rotor), numPendientes(0), rotacionPendiente(0), lotes(0), cargas(0) {}
+
+AgrupadorTramas::~AgrupadorTramas() {
+    vaciar();
+}
+
+void AgrupadorTramas::vaciarCargas() {
+    rotor->mapearBloque(pendientes, pendientes, numPendientes);
+    carga->insertarBloque(pendientes, numPendientes);
+    numPendientes = 0;
+    lotes++;
+}
+
+TipoLinea AgrupadorTramas::agregar(const VistaLinea& linea) {
+    char dato;
+    int rotacion;
+    TipoLinea tipo = clasificarLinea(linea.datos, linea.longitud, &dato, &rotacion);
+    marcarEtapa(ETAPA_PARSEO);
+
+    if (tipo == LINEA_CARGA) {
+        // Termina una racha de MAP: girar el rotor una sola vez con la rotación neta
+        if (rotacionPendiente != 0) {
+            rotor->rotar(rotacionPendiente);
+            rotacionPendiente = 0;
+        }
+        pendientes[numPendientes++] = dato;
+        cargas++;
+        if (numPendientes == CAPACIDAD_LOTE) {
+            vaciarCargas();
+        }
+    } else if (tipo == LINEA_MAPA) {
+        // Termina una racha de LOAD: decodificarla con la rotación que tenía
+        if (numPendientes > 0) {
+            vaciarCargas();
+        }
+        rotacionPendiente += rotor->reducirRotacion(rotacion);
+        if (rotacionPendiente >= rotor->getTamano()) {
+            rotacionPendiente -= rotor->getTamano();
+        }
+    }
+    marcarEtapa(ETAPA_DECODIFICACION);
+    contarEvento(tipo == LINEA_CARGA ? CONTADOR_CARGAS : tipo == LINEA_MAPA ? CONTADOR_MAPAS
+                 : tipo == LINEA_INVALIDA ? CONTADOR_INVALIDAS : CONTADOR_INFORMATIVAS);
+    return tipo;
+}
+
+void AgrupadorTramas::vaciar() {
+    if (numPendientes > 0) {
+        vaciarCargas();
+    }
+    if (rotacionPendiente != 0) {
+        rotor->rotar(rotacionPendiente);
+        rotacionPendiente = 0;
+    }
+}
+
+unsigned long AgrupadorTramas::getLotes() const {
+    return lotes;
+}
+
+unsigned long AgrupadorTramas::getCargas() const {
+    return cargas;
+}
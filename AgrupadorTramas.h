@@ -0,0 +1,88 @@
+/**
+ * @file AgrupadorTramas.h
+ * @brief Define el agrupador que decodifica por bloques las rachas de tramas LOAD.
+ */
+
+#ifndef AGRUPADOR_TRAMAS_H
+#define AGRUPADOR_TRAMAS_H
+
+#include <cstddef>
+#include "FuenteTramas.h"
+#include "ListaDeCarga.h"
+#include "ParserTramas.h"
+#include "RotorDeMapeo.h"
+
+/**
+ * @class AgrupadorTramas
+ * @brief Junta las tramas consecutivas del mismo tipo en una sola trama de lote.
+ *
+ * - Una racha de tramas LOAD se guarda sin decodificar y, al terminar, se mapea con
+ *   una sola pasada de RotorDeMapeo::mapearBloque() y se agrega con un solo
+ *   ListaDeCarga::insertarBloque().
+ * - Una racha de tramas MAP se reduce a una rotación neta módulo el tamaño del
+ *   alfabeto, que se aplica al rotor justo antes de la siguiente trama LOAD.
+ *
+ * Los mensajes informativos y las tramas mal formadas no cambian el estado, así que
+ * no cortan las rachas. El mensaje y el rotor solo están al día después de vaciar():
+ * sirve para los modos sin salida por trama (`--quiet`, sesiones).
+ */
+class AgrupadorTramas {
+public:
+    static const size_t CAPACIDAD_LOTE = 512; /**< @brief Caracteres pendientes antes de decodificar forzosamente. */
+
+private:
+    ListaDeCarga* carga;         /**< @brief Lista donde se agregan los caracteres decodificados. */
+    RotorDeMapeo* rotor;         /**< @brief Rotor de mapeo. */
+    char pendientes[CAPACIDAD_LOTE]; /**< @brief Caracteres recibidos aún sin decodificar. */
+    size_t numPendientes;        /**< @brief Número de caracteres en `pendientes`. */
+    int rotacionPendiente;       /**< @brief Rotación neta (0..tamaño-1) aún no aplicada al rotor. */
+    unsigned long lotes;         /**< @brief Bloques de caracteres decodificados. */
+    unsigned long cargas;        /**< @brief Tramas LOAD recibidas. */
+
+    /**
+     * @brief Decodifica y agrega los caracteres pendientes.
+     */
+    void vaciarCargas();
+
+public:
+    /**
+     * @brief Constructor de AgrupadorTramas.
+     * @param carga Lista donde se ensambla el mensaje.
+     * @param rotor Rotor de mapeo.
+     */
+    AgrupadorTramas(ListaDeCarga* carga, RotorDeMapeo* rotor);
+
+    /**
+     * @brief Destructor de AgrupadorTramas. Aplica lo que haya quedado pendiente.
+     */
+    ~AgrupadorTramas();
+
+    AgrupadorTramas(const AgrupadorTramas&) = delete;
+    AgrupadorTramas& operator=(const AgrupadorTramas&) = delete;
+
+    /**
+     * @brief Clasifica una línea y la agrega a la racha que corresponda.
+     * @param linea Línea recibida; no se conserva ninguna referencia a ella.
+     * @return El tipo de la línea (LINEA_INVALIDA si está mal formada).
+     */
+    TipoLinea agregar(const VistaLinea& linea);
+
+    /**
+     * @brief Aplica las rachas pendientes, dejando el mensaje y el rotor al día.
+     */
+    void vaciar();
+
+    /**
+     * @brief Obtiene el número de bloques decodificados.
+     * @return Bloques pasados a mapearBloque().
+     */
+    unsigned long getLotes() const;
+
+    /**
+     * @brief Obtiene el número de tramas LOAD recibidas.
+     * @return Tramas LOAD agregadas.
+     */
+    unsigned long getCargas() const;
+};
+
+#endif // AGRUPADOR_TRAMAS_H
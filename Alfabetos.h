@@ -0,0 +1,102 @@
+/**
+ * @file Alfabetos.h
+ * @brief Define los alfabetos que puede usar un rotor (ver RotorAlfabeto).
+ *
+ * Un alfabeto es un tipo sin estado con:
+ * - `TAMANO`: número de símbolos (1..256).
+ * - `IGUALAR_MINUSCULAS`: si `true`, las letras ASCII minúsculas se mapean como su mayúscula.
+ * - `simbolo(i)`: el símbolo de índice absoluto `i` (0..TAMANO-1), sin repetir.
+ *
+ * Todo es `constexpr`, así que las tablas del rotor se generan al compilar. TipoAlfabeto
+ * enumera los alfabetos para elegirlos al ejecutar (opción `--alfabeto`).
+ */
+
+#ifndef ALFABETOS_H
+#define ALFABETOS_H
+
+/**
+ * @struct AlfabetoLatino
+ * @brief A-Z y espacio (A=0, ..., Z=25, ' '=26): el alfabeto del protocolo PRT-7.
+ */
+struct AlfabetoLatino {
+    static constexpr int TAMANO = 27;                /**< @brief Cantidad de símbolos. */
+    static constexpr bool IGUALAR_MINUSCULAS = true; /**< @brief 'a'..'z' se leen como 'A'..'Z'. */
+
+    /**
+     * @brief Símbolo de un índice absoluto.
+     * @param i Índice en 0..26.
+     * @return 'A' + i, o el espacio para 26.
+     */
+    static constexpr char simbolo(int i) {
+        return i < 26 ? (char)('A' + i) : ' ';
+    }
+};
+
+/**
+ * @struct AlfabetoDigitos
+ * @brief Los dígitos '0'..'9'.
+ */
+struct AlfabetoDigitos {
+    static constexpr int TAMANO = 10;                 /**< @brief Cantidad de símbolos. */
+    static constexpr bool IGUALAR_MINUSCULAS = false; /**< @brief No hay letras. */
+
+    /**
+     * @brief Símbolo de un índice absoluto.
+     * @param i Índice en 0..9.
+     * @return '0' + i.
+     */
+    static constexpr char simbolo(int i) {
+        return (char)('0' + i);
+    }
+};
+
+/**
+ * @struct AlfabetoImprimible
+ * @brief El ASCII imprimible, del espacio (0x20) a '~' (0x7E), en orden.
+ */
+struct AlfabetoImprimible {
+    static constexpr int TAMANO = 95;                 /**< @brief Cantidad de símbolos. */
+    static constexpr bool IGUALAR_MINUSCULAS = false; /**< @brief Las minúsculas son símbolos propios. */
+
+    /**
+     * @brief Símbolo de un índice absoluto.
+     * @param i Índice en 0..94.
+     * @return 0x20 + i.
+     */
+    static constexpr char simbolo(int i) {
+        return (char)(0x20 + i);
+    }
+};
+
+/**
+ * @struct AlfabetoBytes
+ * @brief Los 256 valores de un byte (índice absoluto = valor del byte).
+ */
+struct AlfabetoBytes {
+    static constexpr int TAMANO = 256;                /**< @brief Cantidad de símbolos. */
+    static constexpr bool IGUALAR_MINUSCULAS = false; /**< @brief Todo byte es un símbolo propio. */
+
+    /**
+     * @brief Símbolo de un índice absoluto.
+     * @param i Índice en 0..255.
+     * @return El byte de valor `i`.
+     */
+    static constexpr char simbolo(int i) {
+        return (char)(unsigned char)i;
+    }
+};
+
+/**
+ * @enum TipoAlfabeto
+ * @brief Alfabetos que se pueden elegir al ejecutar (ver describirAlfabeto()).
+ */
+enum TipoAlfabeto {
+    ALFABETO_LATINO,     /**< @brief AlfabetoLatino (por omisión). */
+    ALFABETO_DIGITOS,    /**< @brief AlfabetoDigitos. */
+    ALFABETO_IMPRIMIBLE, /**< @brief AlfabetoImprimible. */
+    ALFABETO_BYTES       /**< @brief AlfabetoBytes. */
+};
+
+const int NUM_ALFABETOS = 4; /**< @brief Cantidad de valores de TipoAlfabeto. */
+
+#endif // ALFABETOS_H
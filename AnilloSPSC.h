@@ -0,0 +1,175 @@
+/**
+ * @file AnilloSPSC.h
+ * @brief Define un buffer circular acotado sin bloqueos para un productor y un consumidor.
+ */
+
+#ifndef ANILLO_SPSC_H
+#define ANILLO_SPSC_H
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @class AnilloSPSC
+ * @brief Cola circular de capacidad fija entre exactamente dos hilos.
+ *
+ * Un único hilo productor llama a reservar()/publicar() y un único hilo consumidor
+ * a frente()/liberar(). Los elementos se escriben y leen en el lugar, sin copias
+ * adicionales, y la sincronización usa solo dos índices atómicos (adquirir/liberar),
+ * cada uno en su propia línea de caché.
+ *
+ * Además lleva métricas de ocupación, que el productor actualiza al publicar.
+ *
+ * @tparam T Tipo de los elementos.
+ * @tparam CAPACIDAD Número de elementos; debe ser potencia de 2.
+ */
+template <class T, size_t CAPACIDAD>
+class AnilloSPSC {
+    static_assert(CAPACIDAD >= 2 && (CAPACIDAD & (CAPACIDAD - 1)) == 0,
+                  "La capacidad de AnilloSPSC debe ser potencia de 2");
+
+private:
+    static const size_t MASCARA = CAPACIDAD - 1;
+
+    alignas(64) std::atomic<size_t> cabeza; /**< @brief Próximo elemento a consumir (lo escribe el consumidor). */
+    alignas(64) std::atomic<size_t> cola;   /**< @brief Próximo hueco a llenar (lo escribe el productor). */
+    size_t cabezaConocida;                  /**< @brief Copia de `cabeza` del productor (evita leer el atómico en cada reserva). */
+    size_t publicados;                      /**< @brief Elementos publicados (métrica). */
+    size_t sumaOcupacion;                   /**< @brief Suma de la ocupación tras cada publicación (métrica). */
+    size_t ocupacionMaxima;                 /**< @brief Mayor ocupación observada (métrica). */
+    size_t vecesLleno;                      /**< @brief Veces que reservar() encontró el anillo lleno (métrica). */
+    alignas(64) size_t colaConocida;        /**< @brief Copia de `cola` del consumidor. */
+    alignas(64) T elementos[CAPACIDAD];     /**< @brief Almacenamiento de los elementos. */
+
+public:
+    /**
+     * @brief Constructor de AnilloSPSC. El anillo empieza vacío.
+     */
+    AnilloSPSC()
+        : cabeza(0), cola(0), cabezaConocida(0), publicados(0), sumaOcupacion(0),
+          ocupacionMaxima(0), vecesLleno(0), colaConocida(0) {}
+
+    AnilloSPSC(const AnilloSPSC&) = delete;
+    AnilloSPSC& operator=(const AnilloSPSC&) = delete;
+
+    /**
+     * @brief (Productor) Obtiene el siguiente hueco libre para escribir en él.
+     * @return Puntero al hueco, o `nullptr` si el anillo está lleno.
+     */
+    T* reservar() {
+        size_t c = cola.load(std::memory_order_relaxed);
+        if (c - cabezaConocida == CAPACIDAD) {
+            cabezaConocida = cabeza.load(std::memory_order_acquire);
+            if (c - cabezaConocida == CAPACIDAD) {
+                vecesLleno++;
+                return nullptr;
+            }
+        }
+        return &elementos[c & MASCARA];
+    }
+
+    /**
+     * @brief (Productor) Obtiene cuántos huecos se pueden reservar seguidos sin que reservar() falle.
+     * @details Como reservar(), solo lee el índice del consumidor si la copia conocida no deja espacio.
+     * @return Huecos libres (el consumidor puede haber liberado más mientras tanto).
+     */
+    size_t getEspacioLibre() {
+        size_t c = cola.load(std::memory_order_relaxed);
+        if (c - cabezaConocida == CAPACIDAD) {
+            cabezaConocida = cabeza.load(std::memory_order_acquire);
+        }
+        return CAPACIDAD - (c - cabezaConocida);
+    }
+
+    /**
+     * @brief (Productor) Entrega al consumidor el hueco obtenido con reservar().
+     */
+    void publicar() {
+        size_t c = cola.load(std::memory_order_relaxed) + 1;
+        cola.store(c, std::memory_order_release);
+
+        // Para la métrica basta una lectura relajada: el consumidor solo puede haber avanzado
+        size_t ocupacion = c - cabeza.load(std::memory_order_relaxed);
+        publicados++;
+        sumaOcupacion += ocupacion;
+        if (ocupacion > ocupacionMaxima) {
+            ocupacionMaxima = ocupacion;
+        }
+    }
+
+    /**
+     * @brief (Consumidor) Obtiene el elemento más antiguo sin retirarlo.
+     * @return Puntero al elemento, o `nullptr` si el anillo está vacío.
+     */
+    T* frente() {
+        size_t h = cabeza.load(std::memory_order_relaxed);
+        if (h == colaConocida) {
+            colaConocida = cola.load(std::memory_order_acquire);
+            if (h == colaConocida) {
+                return nullptr;
+            }
+        }
+        return &elementos[h & MASCARA];
+    }
+
+    /**
+     * @brief (Consumidor) Retira el elemento obtenido con frente(); su hueco vuelve a estar libre.
+     */
+    void liberar() {
+        cabeza.store(cabeza.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief Indica si el anillo está vacío (aproximado si el otro hilo está activo).
+     * @return `true` si no hay elementos pendientes.
+     */
+    bool vacio() const {
+        return cabeza.load(std::memory_order_acquire) == cola.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Obtiene la capacidad del anillo.
+     * @return Número máximo de elementos.
+     */
+    static constexpr size_t getCapacidad() {
+        return CAPACIDAD;
+    }
+
+    /**
+     * @brief Obtiene la mayor ocupación observada por el productor.
+     * @details Leer solo cuando el productor terminó.
+     * @return Elementos pendientes en el peor momento.
+     */
+    size_t getOcupacionMaxima() const {
+        return ocupacionMaxima;
+    }
+
+    /**
+     * @brief Obtiene la ocupación promedio tras cada publicación.
+     * @details Leer solo cuando el productor terminó.
+     * @return Promedio de elementos pendientes (0 si no se publicó nada).
+     */
+    double getOcupacionMedia() const {
+        return publicados > 0 ? (double)sumaOcupacion / (double)publicados : 0.0;
+    }
+
+    /**
+     * @brief Obtiene cuántas veces el productor encontró el anillo lleno.
+     * @details Leer solo cuando el productor terminó.
+     * @return Número de reservas fallidas.
+     */
+    size_t getVecesLleno() const {
+        return vecesLleno;
+    }
+
+    /**
+     * @brief Obtiene el número de elementos publicados.
+     * @details Leer solo cuando el productor terminó.
+     * @return Elementos publicados desde la creación.
+     */
+    size_t getPublicados() const {
+        return publicados;
+    }
+};
+
+#endif // ANILLO_SPSC_H
@@ -0,0 +1,128 @@
+/**
+ * @file ArchivoMapeado.cpp
+ * @brief Implementación de la clase ArchivoMapeado.
+ */
+
+#include "ArchivoMapeado.h"
+#include <iostream>
+
+#ifndef _WIN32
+    #include <fcntl.h>     // Para open
+    #include <sys/mman.h>  // Para mmap, munmap, madvise
+    #include <sys/stat.h>  // Para fstat
+    #include <unistd.h>    // Para close
+#endif
+
+ArchivoMapeado::ArchivoMapeado() : datos(nullptr), longitud(0) {
+#ifdef _WIN32
+    hArchivo = INVALID_HANDLE_VALUE;
+    hMapeo = NULL;
+#else
+    fd = -1;
+#endif
+}
+
+ArchivoMapeado::~ArchivoMapeado() {
+    cerrar();
+}
+
+bool ArchivoMapeado::abrir(const char* ruta) {
+    cerrar();
+
+#ifdef _WIN32
+    hArchivo = CreateFileA(ruta, GENERIC_READ, FILE_SHARE_READ, NULL,
+                           OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (hArchivo == INVALID_HANDLE_VALUE) {
+        std::cerr << "Error: No se pudo abrir el archivo " << ruta << std::endl;
+        return false;
+    }
+
+    LARGE_INTEGER tamano;
+    if (!GetFileSizeEx(hArchivo, &tamano)) {
+        std::cerr << "Error: No se pudo obtener el tamaño de " << ruta << std::endl;
+        cerrar();
+        return false;
+    }
+    longitud = (size_t)tamano.QuadPart;
+    if (longitud == 0) {
+        return true; // No se puede proyectar un archivo vacío
+    }
+
+    hMapeo = CreateFileMappingA(hArchivo, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (hMapeo == NULL) {
+        std::cerr << "Error: No se pudo proyectar el archivo " << ruta << std::endl;
+        cerrar();
+        return false;
+    }
+    datos = (const char*)MapViewOfFile(hMapeo, FILE_MAP_READ, 0, 0, 0);
+    if (datos == nullptr) {
+        std::cerr << "Error: No se pudo proyectar el archivo " << ruta << std::endl;
+        cerrar();
+        return false;
+    }
+    return true;
+#else
+    fd = ::open(ruta, O_RDONLY);
+    if (fd == -1) {
+        std::cerr << "Error: No se pudo abrir el archivo " << ruta << std::endl;
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        std::cerr << "Error: No se pudo obtener el tamaño de " << ruta << std::endl;
+        cerrar();
+        return false;
+    }
+    longitud = (size_t)info.st_size;
+    if (longitud == 0) {
+        return true; // mmap no acepta longitud cero
+    }
+
+    void* proyeccion = mmap(nullptr, longitud, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (proyeccion == MAP_FAILED) {
+        std::cerr << "Error: No se pudo proyectar el archivo " << ruta << std::endl;
+        longitud = 0;
+        cerrar();
+        return false;
+    }
+    // La captura se recorre de principio a fin: pedir lectura anticipada agresiva.
+    madvise(proyeccion, longitud, MADV_SEQUENTIAL);
+    datos = (const char*)proyeccion;
+    return true;
+#endif
+}
+
+void ArchivoMapeado::cerrar() {
+#ifdef _WIN32
+    if (datos != nullptr) {
+        UnmapViewOfFile(datos);
+    }
+    if (hMapeo != NULL) {
+        CloseHandle(hMapeo);
+        hMapeo = NULL;
+    }
+    if (hArchivo != INVALID_HANDLE_VALUE) {
+        CloseHandle(hArchivo);
+        hArchivo = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (datos != nullptr) {
+        munmap((void*)datos, longitud);
+    }
+    if (fd != -1) {
+        ::close(fd);
+        fd = -1;
+    }
+#endif
+    datos = nullptr;
+    longitud = 0;
+}
+
+const char* ArchivoMapeado::getDatos() const {
+    return datos;
+}
+
+size_t ArchivoMapeado::getLongitud() const {
+    return longitud;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file ArchivoMapeado.h
+ * @brief Define una clase para mapear en memoria (solo lectura) un archivo de captura.
+ */
+
+#ifndef ARCHIVO_MAPEADO_H
+#define ARCHIVO_MAPEADO_H
+
+#include <cstddef>
+
+#ifdef _WIN32
+    #include <windows.h>
+#endif
+
+/**
+ * @class ArchivoMapeado
+ * @brief Proyección en memoria de solo lectura de un archivo completo.
+ *
+ * Permite recorrer capturas grabadas de varios GB sin copiarlas a un buffer
+ * propio: el sistema operativo carga las páginas bajo demanda.
+ * - Windows: CreateFileMapping / MapViewOfFile.
+ * - Linux/macOS: mmap.
+ */
+class ArchivoMapeado {
+private:
+#ifdef _WIN32
+    HANDLE hArchivo; /**< @brief Handle del archivo en Windows. */
+    HANDLE hMapeo;   /**< @brief Handle del objeto de mapeo en Windows. */
+#else
+    int fd;          /**< @brief File descriptor del archivo en Linux/macOS. */
+#endif
+    const char* datos;  /**< @brief Inicio de la proyección, o `nullptr` si no hay archivo abierto. */
+    size_t longitud;    /**< @brief Tamaño del archivo en bytes. */
+
+public:
+    /**
+     * @brief Constructor de ArchivoMapeado.
+     * Inicializa el objeto sin ningún archivo abierto.
+     */
+    ArchivoMapeado();
+
+    /**
+     * @brief Destructor de ArchivoMapeado.
+     * Libera la proyección y cierra el archivo.
+     */
+    ~ArchivoMapeado();
+
+    /**
+     * @brief Abre y proyecta en memoria el archivo indicado.
+     * @param ruta Ruta del archivo a proyectar.
+     * @return `true` si el archivo se proyectó correctamente, `false` en caso contrario.
+     *         Un archivo vacío se considera válido (`getLongitud() == 0`).
+     */
+    bool abrir(const char* ruta);
+
+    /**
+     * @brief Libera la proyección y cierra el archivo.
+     */
+    void cerrar();
+
+    /**
+     * @brief Obtiene el inicio de los datos proyectados.
+     * @return Puntero al primer byte del archivo, o `nullptr` si está vacío o cerrado.
+     */
+    const char* getDatos() const;
+
+    /**
+     * @brief Obtiene el tamaño de los datos proyectados.
+     * @return Número de bytes del archivo.
+     */
+    size_t getLongitud() const;
+
+private:
+    ArchivoMapeado(const ArchivoMapeado&) = delete;
+    ArchivoMapeado& operator=(const ArchivoMapeado&) = delete;
+};
+
+#endif // ARCHIVO_MAPEADO_H
@@ -0,0 +1,59 @@
+/**
+ * @file ContadorAsignaciones.cpp
+ * @brief Implementación del conteo opcional de asignaciones de memoria.
+ */
+
+#include "ContadorAsignaciones.h"
+
+#ifdef PRT7_CONTAR_ASIGNACIONES
+
+#include <atomic>
+#include <cstdlib>  // Para malloc, free
+#include <new>      // Para std::bad_alloc
+
+static std::atomic<unsigned long> asignaciones(0); /**< @brief Contador global de asignaciones. */
+
+void* operator new(std::size_t tamano) {
+    asignaciones.fetch_add(1, std::memory_order_relaxed);
+    void* p = malloc(tamano > 0 ? tamano : 1);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    free(p);
+}
+
+bool asignacionesInstrumentadas() {
+    return true;
+}
+
+unsigned long getAsignaciones() {
+    return asignaciones.load(std::memory_order_relaxed);
+}
+
+void registrarAsignacion() {
+    asignaciones.fetch_add(1, std::memory_order_relaxed);
+}
+
+#else
+
+bool asignacionesInstrumentadas() {
+    return false;
+}
+
+unsigned long getAsignaciones() {
+    return 0;
+}
+
+void registrarAsignacion() {
+    // Sin instrumentación: no se cuenta nada.
+}
+
+#endif // PRT7_CONTAR_ASIGNACIONES
@@ -0,0 +1,31 @@
+/**
+ * @file ContadorAsignaciones.h
+ * @brief Instrumentación opcional que cuenta las asignaciones de memoria dinámica.
+ *
+ * Se activa compilando con `PRT7_CONTAR_ASIGNACIONES` (opción de CMake del mismo
+ * nombre). En ese caso se reemplazan `operator new`/`operator delete` globales para
+ * contar cada asignación. Sin la opción, las funciones existen pero no cuentan nada
+ * y no hay ningún costo en el bucle de decodificación.
+ */
+
+#ifndef CONTADOR_ASIGNACIONES_H
+#define CONTADOR_ASIGNACIONES_H
+
+/**
+ * @brief Indica si el programa se compiló con el conteo de asignaciones.
+ * @return `true` si getAsignaciones() refleja las asignaciones reales.
+ */
+bool asignacionesInstrumentadas();
+
+/**
+ * @brief Obtiene el número de asignaciones dinámicas realizadas hasta el momento.
+ * @return Total de llamadas a `operator new` más las registradas con registrarAsignacion().
+ */
+unsigned long getAsignaciones();
+
+/**
+ * @brief Registra una asignación hecha con `malloc` (que no pasa por `operator new`).
+ */
+void registrarAsignacion();
+
+#endif // CONTADOR_ASIGNACIONES_H
@@ -0,0 +1,34 @@
+/**
+ * @file Crc8.cpp
+ * @brief Implementación del CRC-8 de las tramas binarias.
+ */
+
+#include "Crc8.h"
+
+/**
+ * @struct TablaCrc8
+ * @brief CRC-8 de cada byte posible, calculado en tiempo de compilación.
+ */
+struct TablaCrc8 {
+    uint8_t valores[256]; /**< @brief CRC-8 del byte i partiendo de 0. */
+
+    constexpr TablaCrc8() : valores() {
+        for (int i = 0; i < 256; ++i) {
+            uint8_t crc = (uint8_t)i;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ POLINOMIO_CRC8) : (uint8_t)(crc << 1);
+            }
+            valores[i] = crc;
+        }
+    }
+};
+
+static constexpr TablaCrc8 TABLA_CRC8;
+
+uint8_t calcularCrc8(const unsigned char* datos, size_t longitud, uint8_t inicial) {
+    uint8_t crc = inicial;
+    for (size_t i = 0; i < longitud; ++i) {
+        crc = TABLA_CRC8.valores[crc ^ datos[i]];
+    }
+    return crc;
+}
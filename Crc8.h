@@ -0,0 +1,26 @@
+/**
+ * @file Crc8.h
+ * @brief Define el cálculo del CRC-8 que protege las tramas binarias PRT-7.
+ */
+
+#ifndef CRC8_H
+#define CRC8_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Polinomio del CRC-8 (x^8 + x^2 + x + 1, el de CRC-8/SMBUS), sin reflejar y con valor inicial 0.
+ */
+const uint8_t POLINOMIO_CRC8 = 0x07;
+
+/**
+ * @brief Calcula el CRC-8 de un bloque de bytes con una tabla de 256 entradas.
+ * @param datos Bytes a proteger.
+ * @param longitud Número de bytes.
+ * @param inicial Valor inicial; permite continuar un cálculo por partes.
+ * @return El CRC-8 del bloque.
+ */
+uint8_t calcularCrc8(const unsigned char* datos, size_t longitud, uint8_t inicial = 0);
+
+#endif // CRC8_H
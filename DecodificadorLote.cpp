@@ -0,0 +1,186 @@
+/**
+ * @file DecodificadorLote.cpp
+ * @brief Implementación de la clase DecodificadorLote.
+ */
+
+#include "DecodificadorLote.h"
+#include "ListaDeCarga.h"
+#include "ParserTramas.h"
+#include "DivisorTramas.h"
+#include "RotorDeMapeo.h"
+#include <cstdlib>  // Para malloc, free
+#include <thread>
+
+/**
+ * @brief Tamaño mínimo de fragmento; por debajo no compensa lanzar otro hilo.
+ */
+static const size_t TAMANO_MINIMO_FRAGMENTO = 1 << 20;
+
+/**
+ * @struct FragmentoLote
+ * @brief Porción de la captura asignada a un hilo, siempre alineada a inicio de línea.
+ */
+struct FragmentoLote {
+    const char* inicio;       /**< @brief Primer byte del fragmento. */
+    const char* fin;          /**< @brief Byte siguiente al último del fragmento. */
+    size_t cargas;            /**< @brief Número de tramas LOAD del fragmento (fase 1). */
+    int rotacion;             /**< @brief Rotación neta del fragmento, módulo el tamaño del alfabeto (fase 1). */
+    size_t posicionSalida;    /**< @brief Posición del primer carácter en el mensaje (prefijo). */
+    int desplazamientoInicial; /**< @brief Rotación del rotor al inicio del fragmento (prefijo). */
+};
+
+/**
+ * @brief Recorre las líneas de [inicio, fin) como lo haría SerialPort::readLine().
+ *
+ * Usa DivisorTramas, por lo que omite las líneas vacías y parte las líneas de más
+ * de LONGITUD_MAXIMA_LINEA bytes igual que las fuentes de tramas.
+ * Llama a `visitar(tipo, dato, rotacion)` por cada línea.
+ */
+template <class Visitante>
+static void recorrerLineas(const char* inicio, const char* fin, Visitante& visitar) {
+    DivisorTramas divisor(inicio, (size_t)(fin - inicio));
+    VistaLinea linea;
+    while (divisor.siguiente(&linea)) {
+        char dato;
+        int rotacion;
+        TipoLinea tipo = clasificarLinea(linea.datos, linea.longitud, &dato, &rotacion);
+        visitar(tipo, dato, rotacion);
+    }
+}
+
+/**
+ * @brief Fase 1: cuenta las tramas LOAD y la rotación neta de un fragmento.
+ */
+static void contarFragmento(FragmentoLote* fragmento, const RotorDeMapeo* rotor) {
+    struct Contador {
+        const RotorDeMapeo* rotor;
+        size_t cargas;
+        int rotacion;
+        void operator()(TipoLinea tipo, char, int rot) {
+            if (tipo == LINEA_CARGA) {
+                cargas++;
+            } else if (tipo == LINEA_MAPA) {
+                rotacion += rotor->reducirRotacion(rot);
+                if (rotacion >= rotor->getTamano()) {
+                    rotacion -= rotor->getTamano();
+                }
+            }
+        }
+    } contador{rotor, 0, 0};
+    recorrerLineas(fragmento->inicio, fragmento->fin, contador);
+    fragmento->cargas = contador.cargas;
+    fragmento->rotacion = contador.rotacion;
+}
+
+/**
+ * @brief Fase 3: decodifica un fragmento a partir de su rotación inicial.
+ */
+static void decodificarFragmento(const FragmentoLote* fragmento, const RotorDeMapeo* rotor, char* salida) {
+    struct Decodificador {
+        const RotorDeMapeo* rotor;
+        char* destino;
+        int desplazamiento;
+        void operator()(TipoLinea tipo, char dato, int rot) {
+            if (tipo == LINEA_CARGA) {
+                *destino++ = rotor->mapearConDesplazamiento(dato, desplazamiento);
+            } else if (tipo == LINEA_MAPA) {
+                desplazamiento += rotor->reducirRotacion(rot);
+                if (desplazamiento >= rotor->getTamano()) {
+                    desplazamiento -= rotor->getTamano();
+                }
+            }
+        }
+    } decodificador{rotor, salida + fragmento->posicionSalida, fragmento->desplazamientoInicial};
+    recorrerLineas(fragmento->inicio, fragmento->fin, decodificador);
+}
+
+DecodificadorLote::DecodificadorLote(int numHilos) : numHilos(numHilos) {
+    if (this->numHilos <= 0) {
+        this->numHilos = (int)std::thread::hardware_concurrency();
+        if (this->numHilos <= 0) {
+            this->numHilos = 1;
+        }
+    }
+}
+
+size_t DecodificadorLote::decodificar(const char* datos, size_t longitud, ListaDeCarga* carga, RotorDeMapeo* rotor) {
+    if (datos == nullptr || longitud == 0 || !carga || !rotor) {
+        return 0;
+    }
+
+    size_t numFragmentos = (size_t)numHilos;
+    if (longitud / numFragmentos < TAMANO_MINIMO_FRAGMENTO) {
+        numFragmentos = longitud / TAMANO_MINIMO_FRAGMENTO + 1;
+        if (numFragmentos > (size_t)numHilos) {
+            numFragmentos = (size_t)numHilos;
+        }
+    }
+
+    // Partir la captura en fragmentos que empiezan justo después de un fin de línea
+    FragmentoLote* fragmentos = new FragmentoLote[numFragmentos];
+    const char* fin = datos + longitud;
+    const char* inicio = datos;
+    for (size_t i = 0; i < numFragmentos; ++i) {
+        const char* corte = fin;
+        if (i + 1 < numFragmentos) {
+            corte = datos + longitud / numFragmentos * (i + 1);
+            if (corte < inicio) {
+                corte = inicio;
+            }
+            corte = buscarFinDeLinea(corte, fin);
+        }
+        fragmentos[i].inicio = inicio;
+        fragmentos[i].fin = corte;
+        inicio = corte;
+    }
+
+    std::thread* hilos = new std::thread[numFragmentos];
+
+    // Fase 1: contar en paralelo (el último fragmento lo procesa el hilo actual)
+    for (size_t i = 0; i + 1 < numFragmentos; ++i) {
+        hilos[i] = std::thread(contarFragmento, &fragmentos[i], rotor);
+    }
+    contarFragmento(&fragmentos[numFragmentos - 1], rotor);
+    for (size_t i = 0; i + 1 < numFragmentos; ++i) {
+        hilos[i].join();
+    }
+
+    // Fase 2: prefijo exclusivo de cargas y rotaciones
+    size_t totalCargas = 0;
+    int desplazamiento = rotor->getDesplazamiento();
+    int rotacionTotal = 0;
+    for (size_t i = 0; i < numFragmentos; ++i) {
+        fragmentos[i].posicionSalida = totalCargas;
+        fragmentos[i].desplazamientoInicial = desplazamiento;
+        totalCargas += fragmentos[i].cargas;
+        desplazamiento = rotor->reducirRotacion(desplazamiento + fragmentos[i].rotacion);
+        rotacionTotal = rotor->reducirRotacion(rotacionTotal + fragmentos[i].rotacion);
+    }
+
+    // Fase 3: decodificar en paralelo en un buffer común
+    char* salida = (char*)malloc(totalCargas > 0 ? totalCargas : 1);
+    if (salida == nullptr) {
+        delete[] hilos;
+        delete[] fragmentos;
+        return 0;
+    }
+    for (size_t i = 0; i + 1 < numFragmentos; ++i) {
+        hilos[i] = std::thread(decodificarFragmento, &fragmentos[i], rotor, salida);
+    }
+    decodificarFragmento(&fragmentos[numFragmentos - 1], rotor, salida);
+    for (size_t i = 0; i + 1 < numFragmentos; ++i) {
+        hilos[i].join();
+    }
+
+    carga->insertarBloque(salida, totalCargas);
+    rotor->rotar(rotacionTotal);
+
+    free(salida);
+    delete[] hilos;
+    delete[] fragmentos;
+    return totalCargas;
+}
+
+int DecodificadorLote::getNumHilos() const {
+    return numHilos;
+}
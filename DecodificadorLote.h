@@ -0,0 +1,60 @@
+/**
+ * @file DecodificadorLote.h
+ * @brief Define el decodificador por lotes (en paralelo) de capturas PRT-7 grabadas.
+ */
+
+#ifndef DECODIFICADOR_LOTE_H
+#define DECODIFICADOR_LOTE_H
+
+#include <cstddef>
+
+class ListaDeCarga;
+class RotorDeMapeo;
+
+/**
+ * @class DecodificadorLote
+ * @brief Decodifica una captura completa repartiendo el trabajo entre varios hilos.
+ *
+ * El significado de una trama LOAD depende solo de la suma (módulo el tamaño del
+ * alfabeto) de todas las rotaciones MAP anteriores. Por eso la captura se decodifica en tres fases:
+ * 1. Cada hilo recorre su fragmento y cuenta sus LOAD y su rotación neta.
+ * 2. Un prefijo exclusivo (secuencial, un valor por fragmento) da a cada fragmento
+ *    su rotación inicial y su posición en el mensaje.
+ * 3. Cada hilo decodifica su fragmento de forma independiente en un buffer común.
+ *
+ * El resultado se inserta en orden en la ListaDeCarga y el rotor queda en el mismo
+ * estado que si se hubiera llamado a `TramaBase::procesar` trama por trama.
+ */
+class DecodificadorLote {
+private:
+    int numHilos; /**< @brief Número de hilos a utilizar. */
+
+public:
+    /**
+     * @brief Constructor de DecodificadorLote.
+     * @param numHilos Número de hilos; 0 usa todos los núcleos disponibles.
+     */
+    explicit DecodificadorLote(int numHilos = 0);
+
+    /**
+     * @brief Decodifica una captura con el formato de líneas `L,X` / `M,N`.
+     *
+     * Las líneas se separan con '\n' o '\r' y se interpretan con las mismas reglas
+     * que el bucle interactivo (líneas informativas y mal formadas se ignoran).
+     *
+     * @param datos Inicio de la captura.
+     * @param longitud Tamaño de la captura en bytes.
+     * @param carga Lista donde se insertan los caracteres decodificados.
+     * @param rotor Rotor con el estado inicial; al terminar refleja todas las rotaciones.
+     * @return El número de caracteres decodificados.
+     */
+    size_t decodificar(const char* datos, size_t longitud, ListaDeCarga* carga, RotorDeMapeo* rotor);
+
+    /**
+     * @brief Obtiene el número de hilos configurado.
+     * @return Número de hilos que se usarán en la próxima decodificación.
+     */
+    int getNumHilos() const;
+};
+
+#endif // DECODIFICADOR_LOTE_H
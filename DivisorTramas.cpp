@@ -0,0 +1,168 @@
+/**
+ * @file DivisorTramas.cpp
+ * @brief Implementación del separador vectorizado de líneas.
+ */
+
+#include "DivisorTramas.h"
+#include "ParserTramas.h"
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define PRT7_DIVISOR_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define PRT7_DIVISOR_SSE2
+#endif
+
+#if defined(_MSC_VER)
+    #include <intrin.h>
+#endif
+
+/**
+ * @brief Índice del bit menos significativo encendido (`valor` no debe ser 0).
+ */
+static inline int bitMasBajo(uint64_t valor) {
+#if defined(_MSC_VER)
+    unsigned long indice;
+    _BitScanForward64(&indice, valor);
+    return (int)indice;
+#else
+    return __builtin_ctzll(valor);
+#endif
+}
+
+/**
+ * @brief Indica si un carácter termina una línea.
+ */
+static inline bool esFinDeLinea(char c) {
+    return c == '\n' || c == '\r';
+}
+
+/**
+ * @brief Calcula la máscara de terminadores de los (hasta) 64 bytes que empiezan en `p`.
+ * @param p Inicio del bloque.
+ * @param fin Fin del buffer: los bytes desde `fin` no se leen.
+ * @return Máscara con el bit i encendido si `p[i]` es '\n' o '\r'.
+ */
+static inline uint64_t mascaraBloque(const char* p, const char* fin) {
+#if defined(PRT7_DIVISOR_AVX2)
+    if (fin - p >= 64) {
+        const __m256i nl = _mm256_set1_epi8('\n');
+        const __m256i cr = _mm256_set1_epi8('\r');
+        __m256i a = _mm256_loadu_si256((const __m256i*)p);
+        __m256i b = _mm256_loadu_si256((const __m256i*)(p + 32));
+        uint32_t ma = (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(a, nl), _mm256_cmpeq_epi8(a, cr)));
+        uint32_t mb = (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(b, nl), _mm256_cmpeq_epi8(b, cr)));
+        return (uint64_t)ma | ((uint64_t)mb << 32);
+    }
+#elif defined(PRT7_DIVISOR_SSE2)
+    if (fin - p >= 64) {
+        const __m128i nl = _mm_set1_epi8('\n');
+        const __m128i cr = _mm_set1_epi8('\r');
+        uint64_t mascara = 0;
+        for (int i = 0; i < 4; ++i) {
+            __m128i v = _mm_loadu_si128((const __m128i*)(p + 16 * i));
+            uint32_t m = (uint32_t)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, nl), _mm_cmpeq_epi8(v, cr)));
+            mascara |= (uint64_t)m << (16 * i);
+        }
+        return mascara;
+    }
+#endif
+    // Versión escalar (también para el último bloque incompleto)
+    uint64_t mascara = 0;
+    int n = (fin - p < 64) ? (int)(fin - p) : 64;
+    for (int i = 0; i < n; ++i) {
+        if (esFinDeLinea(p[i])) {
+            mascara |= (uint64_t)1 << i;
+        }
+    }
+    return mascara;
+}
+
+const char* buscarFinDeLinea(const char* inicio, const char* fin) {
+    const char* p = inicio;
+#if defined(PRT7_DIVISOR_AVX2)
+    const __m256i nl = _mm256_set1_epi8('\n');
+    const __m256i cr = _mm256_set1_epi8('\r');
+    while (fin - p >= 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)p);
+        uint32_t m = (uint32_t)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(v, nl), _mm256_cmpeq_epi8(v, cr)));
+        if (m != 0) {
+            return p + bitMasBajo(m);
+        }
+        p += 32;
+    }
+#elif defined(PRT7_DIVISOR_SSE2)
+    const __m128i nl = _mm_set1_epi8('\n');
+    const __m128i cr = _mm_set1_epi8('\r');
+    while (fin - p >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i*)p);
+        uint32_t m = (uint32_t)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, nl), _mm_cmpeq_epi8(v, cr)));
+        if (m != 0) {
+            return p + bitMasBajo(m);
+        }
+        p += 16;
+    }
+#endif
+    while (p < fin && !esFinDeLinea(*p)) {
+        p++;
+    }
+    return p;
+}
+
+const char* implementacionDivisor() {
+#if defined(PRT7_DIVISOR_AVX2)
+    return "avx2";
+#elif defined(PRT7_DIVISOR_SSE2)
+    return "sse2";
+#else
+    return "escalar";
+#endif
+}
+
+DivisorTramas::DivisorTramas(const char* datos, size_t longitud)
+    : fin(datos + longitud), posicion(datos), bloque(datos), mascara(0), terminador(datos + longitud) {
+    if (longitud > 0) {
+        mascara = mascaraBloque(bloque, fin);
+        terminador = siguienteTerminador();
+    }
+}
+
+const char* DivisorTramas::siguienteTerminador() {
+    while (mascara == 0) {
+        if (fin - bloque <= 64) {
+            bloque = fin;
+            return fin; // No quedan bloques
+        }
+        bloque += 64;
+        mascara = mascaraBloque(bloque, fin);
+    }
+    int indice = bitMasBajo(mascara);
+    mascara &= mascara - 1; // Consumir el terminador
+    return bloque + indice;
+}
+
+bool DivisorTramas::siguiente(VistaLinea* linea) {
+    while (posicion < fin) {
+        size_t longitud = (size_t)(terminador - posicion);
+        if (longitud == 0) {
+            // Línea vacía (o terminador de la línea anterior): omitir
+            posicion++;
+            terminador = siguienteTerminador();
+            continue;
+        }
+
+        if (longitud > LONGITUD_MAXIMA_LINEA) {
+            longitud = LONGITUD_MAXIMA_LINEA; // El resto se entrega como otra línea
+        }
+        linea->datos = posicion;
+        linea->longitud = longitud;
+        posicion += longitud;
+        return true;
+    }
+    return false;
+}
+
+const char* DivisorTramas::getPosicion() const {
+    return posicion;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file DivisorTramas.h
+ * @brief Define un separador vectorizado de líneas para capturas en memoria.
+ */
+
+#ifndef DIVISOR_TRAMAS_H
+#define DIVISOR_TRAMAS_H
+
+#include <cstddef>
+#include <cstdint>
+#include "FuenteTramas.h"
+
+/**
+ * @brief Busca el primer '\n' o '\r' en [inicio, fin).
+ *
+ * Compara 16 o 32 bytes por instrucción con SSE2/AVX2 (según cómo se compile)
+ * y recurre a un recorrido byte a byte para el resto. Nunca lee fuera del rango.
+ *
+ * @param inicio Primer byte a examinar.
+ * @param fin Byte siguiente al último a examinar.
+ * @return Puntero al terminador encontrado, o `fin` si no hay ninguno.
+ */
+const char* buscarFinDeLinea(const char* inicio, const char* fin);
+
+/**
+ * @brief Indica qué implementación usa el separador en este binario.
+ * @return "avx2", "sse2" o "escalar".
+ */
+const char* implementacionDivisor();
+
+/**
+ * @class DivisorTramas
+ * @brief Recorre un buffer completo (p. ej. una captura proyectada) entregando sus líneas.
+ *
+ * En lugar de buscar el fin de cada línea por separado, calcula una máscara de
+ * 64 bits con la posición de todos los terminadores de un bloque de 64 bytes
+ * y extrae las líneas de la máscara con operaciones de bits. Las líneas se
+ * entregan como vistas sobre el buffer original, sin copias, con las mismas
+ * reglas que separarLinea(): se omiten las líneas vacías y las de más de
+ * LONGITUD_MAXIMA_LINEA caracteres se entregan en fragmentos.
+ */
+class DivisorTramas {
+private:
+    const char* fin;        /**< @brief Byte siguiente al último del buffer. */
+    const char* posicion;   /**< @brief Inicio de la próxima línea. */
+    const char* bloque;     /**< @brief Inicio del bloque de 64 bytes al que corresponde `mascara`. */
+    uint64_t mascara;       /**< @brief Terminadores del bloque aún no consumidos (bit i = byte `bloque + i`). */
+    const char* terminador; /**< @brief Próximo terminador en o después de `posicion` (o `fin`). */
+
+    /**
+     * @brief Avanza al siguiente terminador usando las máscaras de bloque.
+     * @return Puntero al siguiente terminador, o `fin` si no quedan.
+     */
+    const char* siguienteTerminador();
+
+public:
+    /**
+     * @brief Constructor de DivisorTramas.
+     * @param datos Inicio del buffer (por defecto, un buffer vacío).
+     * @param longitud Tamaño del buffer en bytes.
+     */
+    DivisorTramas(const char* datos = nullptr, size_t longitud = 0);
+
+    /**
+     * @brief Entrega la siguiente línea del buffer.
+     * @param linea Salida: vista de la línea (no terminada en '\0').
+     * @return `true` si se entregó una línea, `false` al llegar al final.
+     */
+    bool siguiente(VistaLinea* linea);
+
+    /**
+     * @brief Obtiene la posición del primer byte aún no consumido.
+     * @return Puntero dentro del buffer (o al final).
+     */
+    const char* getPosicion() const;
+};
+
+#endif // DIVISOR_TRAMAS_H
@@ -0,0 +1,283 @@
+/**
+ * @file EscritorAsincrono.cpp
+ * @brief Implementación de la clase EscritorAsincrono.
+ */
+
+#include "EscritorAsincrono.h"
+#include <cerrno>
+#include <cstdlib>  // Para malloc, free
+#include <cstring>  // Para memcpy, strcmp
+#include <iostream>
+
+#ifdef _WIN32
+    #include <io.h>     // Para _open, _write, _close
+    #include <fcntl.h>
+    #include <sys/stat.h>
+#else
+    #include <fcntl.h>
+    #include <sys/uio.h> // Para writev
+    #include <unistd.h>
+#endif
+
+EscritorAsincrono::EscritorAsincrono()
+    : fd(-1), cerrarAlTerminar(false), descartarSiLleno(false), memoria(nullptr), actual(nullptr),
+      bloquesLibres(0), detener(false), bytesEscritos(0), escrituras(0), fallo(false), descartados(0) {}
+
+EscritorAsincrono::~EscritorAsincrono() {
+    cerrar();
+}
+
+bool EscritorAsincrono::abrir(const char* ruta, bool descartarSiLleno) {
+    if (fd >= 0) {
+        return true;
+    }
+    if (strcmp(ruta, "-") == 0) {
+        return abrirDescriptor(1, descartarSiLleno);
+    }
+#ifdef _WIN32
+    fd = _open(ruta, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+    fd = ::open(ruta, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+    if (fd < 0) {
+        std::cerr << "Error: No se pudo crear la salida " << ruta << std::endl;
+        return false;
+    }
+    cerrarAlTerminar = true;
+    if (!iniciar(ruta, descartarSiLleno)) {
+#ifdef _WIN32
+        _close(fd);
+#else
+        ::close(fd);
+#endif
+        fd = -1;
+        return false;
+    }
+    return true;
+}
+
+bool EscritorAsincrono::abrirDescriptor(int descriptor, bool descartarSiLleno) {
+    if (fd >= 0) {
+        return true;
+    }
+    fd = descriptor;
+    cerrarAlTerminar = false;
+    if (!iniciar(descriptor == 1 ? "la salida estándar" : "el descriptor", descartarSiLleno)) {
+        fd = -1;
+        return false;
+    }
+    return true;
+}
+
+bool EscritorAsincrono::iniciar(const char* nombre, bool descartarSiLleno) {
+    memoria = (char*)malloc(TAMANO_BLOQUE * NUM_BLOQUES);
+    if (memoria == nullptr) {
+        std::cerr << "Error: No hay memoria para los buffers de " << nombre << std::endl;
+        return false;
+    }
+
+    // El primer bloque es el actual; los demás empiezan libres
+    for (size_t i = 0; i < NUM_BLOQUES; ++i) {
+        bloques[i].datos = memoria + i * TAMANO_BLOQUE;
+        bloques[i].usados = 0;
+    }
+    actual = &bloques[0];
+    for (size_t i = 1; i < NUM_BLOQUES; ++i) {
+        *libres.reservar() = &bloques[i];
+        libres.publicar();
+    }
+    bloquesLibres.store(NUM_BLOQUES - 1);
+    this->descartarSiLleno = descartarSiLleno;
+    detener = false;
+    hilo = std::thread(&EscritorAsincrono::ejecutar, this);
+    return true;
+}
+
+bool EscritorAsincrono::escribirPendientes() {
+    BloqueSalida* lote[NUM_BLOQUES];
+    size_t numLote = 0;
+    BloqueSalida** pendiente;
+    while (numLote < NUM_BLOQUES && (pendiente = llenos.frente()) != nullptr) {
+        lote[numLote++] = *pendiente;
+        llenos.liberar();
+    }
+    if (numLote == 0) {
+        return false;
+    }
+
+    if (!fallo.load(std::memory_order_relaxed)) {
+#ifdef _WIN32
+        for (size_t i = 0; i < numLote && !fallo.load(std::memory_order_relaxed); ++i) {
+            size_t hecho = 0;
+            while (hecho < lote[i]->usados) {
+                int n = _write(fd, lote[i]->datos + hecho, (unsigned int)(lote[i]->usados - hecho));
+                escrituras++;
+                if (n <= 0) {
+                    fallo.store(true, std::memory_order_relaxed);
+                    break;
+                }
+                hecho += (size_t)n;
+                bytesEscritos += (unsigned long long)n;
+            }
+        }
+#else
+        // Todos los bloques pendientes en una sola llamada; si se escribe solo una parte, seguir desde ahí
+        struct iovec vectores[NUM_BLOQUES];
+        for (size_t i = 0; i < numLote; ++i) {
+            vectores[i].iov_base = lote[i]->datos;
+            vectores[i].iov_len = lote[i]->usados;
+        }
+        struct iovec* siguiente = vectores;
+        int restantes = (int)numLote;
+        while (restantes > 0) {
+            ssize_t n = writev(fd, siguiente, restantes);
+            escrituras++;
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                fallo.store(true, std::memory_order_relaxed);
+                break;
+            }
+            bytesEscritos += (unsigned long long)n;
+            while (restantes > 0 && (size_t)n >= siguiente->iov_len) {
+                n -= (ssize_t)siguiente->iov_len;
+                siguiente++;
+                restantes--;
+            }
+            if (restantes > 0) {
+                siguiente->iov_base = (char*)siguiente->iov_base + n;
+                siguiente->iov_len -= (size_t)n;
+            }
+        }
+#endif
+        if (fallo.load(std::memory_order_relaxed)) {
+            std::cerr << "Error: No se pudo escribir la salida; se descarta el resto." << std::endl;
+        }
+    }
+
+    // Con el archivo fallido los bloques se devuelven igual: el productor nunca se queda esperando
+    for (size_t i = 0; i < numLote; ++i) {
+        lote[i]->usados = 0;
+        *libres.reservar() = lote[i];
+        libres.publicar();
+    }
+    bloquesLibres.fetch_add(numLote, std::memory_order_release);
+    std::lock_guard<std::mutex> cerrojo(mutex);
+    liberado.notify_one();
+    return true;
+}
+
+void EscritorAsincrono::ejecutar() {
+    std::unique_lock<std::mutex> cerrojo(mutex);
+    while (true) {
+        despertador.wait(cerrojo, [this] { return detener || !llenos.vacio(); });
+        bool terminar = detener;
+        cerrojo.unlock();
+        while (escribirPendientes()) {
+        }
+        cerrojo.lock();
+        if (terminar && llenos.vacio()) {
+            break;
+        }
+    }
+}
+
+void EscritorAsincrono::entregarActual() {
+    *llenos.reservar() = actual; // Nunca está lleno: hay tantos huecos como bloques
+    llenos.publicar();
+    actual = nullptr;
+    // Avisar con el cerrojo tomado: así el aviso no se pierde si el hilo estaba por dormirse
+    std::lock_guard<std::mutex> cerrojo(mutex);
+    despertador.notify_one();
+}
+
+void EscritorAsincrono::tomarLibre() {
+    BloqueSalida** libre = libres.frente();
+    if (libre == nullptr) {
+        std::unique_lock<std::mutex> cerrojo(mutex);
+        liberado.wait(cerrojo, [this, &libre] { return (libre = libres.frente()) != nullptr; });
+    }
+    actual = *libre;
+    libres.liberar();
+    bloquesLibres.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool EscritorAsincrono::comenzarRegistro(size_t maximo) {
+    if (!descartarSiLleno) {
+        return true;
+    }
+    // Un registro más grande que todos los bloques nunca cabría: se acepta cuando el
+    // escritor está al día (todos libres salvo el actual) y escribir() espera el resto
+    if (maximo > (NUM_BLOQUES - 1) * TAMANO_BLOQUE) {
+        maximo = (NUM_BLOQUES - 1) * TAMANO_BLOQUE;
+    }
+    size_t disponible = bloquesLibres.load(std::memory_order_acquire) * TAMANO_BLOQUE;
+    if (actual != nullptr) {
+        disponible += TAMANO_BLOQUE - actual->usados;
+    }
+    if (maximo > disponible) {
+        descartados++;
+        return false;
+    }
+    return true;
+}
+
+void EscritorAsincrono::escribir(const char* datos, size_t cantidad) {
+    while (cantidad > 0) {
+        if (actual == nullptr) {
+            tomarLibre();
+        }
+        size_t cabe = TAMANO_BLOQUE - actual->usados;
+        size_t n = cantidad < cabe ? cantidad : cabe;
+        memcpy(actual->datos + actual->usados, datos, n);
+        actual->usados += n;
+        datos += n;
+        cantidad -= n;
+        if (actual->usados == TAMANO_BLOQUE) {
+            entregarActual();
+        }
+    }
+}
+
+void EscritorAsincrono::vaciar() {
+    if (actual != nullptr && actual->usados > 0) {
+        entregarActual();
+    }
+}
+
+void EscritorAsincrono::cerrar() {
+    if (fd < 0) {
+        return;
+    }
+    vaciar();
+    {
+        std::lock_guard<std::mutex> cerrojo(mutex);
+        detener = true;
+    }
+    despertador.notify_one();
+    hilo.join();
+    if (cerrarAlTerminar) {
+#ifdef _WIN32
+        _close(fd);
+#else
+        ::close(fd);
+#endif
+    }
+    fd = -1;
+    free(memoria);
+    memoria = nullptr;
+    actual = nullptr;
+}
+
+unsigned long long EscritorAsincrono::getBytesEscritos() const {
+    return bytesEscritos;
+}
+
+unsigned long EscritorAsincrono::getEscrituras() const {
+    return escrituras;
+}
+
+unsigned long EscritorAsincrono::getDescartados() const {
+    return descartados;
+}
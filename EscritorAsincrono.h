@@ -0,0 +1,173 @@
+/**
+ * @file EscritorAsincrono.h
+ * @brief Define un escritor con buffers grandes que escribe en un archivo desde un hilo propio.
+ */
+
+#ifndef ESCRITOR_ASINCRONO_H
+#define ESCRITOR_ASINCRONO_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include "AnilloSPSC.h"
+
+/**
+ * @struct BloqueSalida
+ * @brief Uno de los buffers del escritor.
+ */
+struct BloqueSalida {
+    char* datos;   /**< @brief Memoria del bloque (EscritorAsincrono::TAMANO_BLOQUE bytes). */
+    size_t usados; /**< @brief Bytes escritos en `datos`. */
+};
+
+/**
+ * @class EscritorAsincrono
+ * @brief Acumula la salida en bloques y la escribe en segundo plano, varios bloques por llamada.
+ *
+ * Un único hilo productor llena el bloque actual con escribir(); al llenarse (o al
+ * llamar a vaciar()) el bloque pasa por un AnilloSPSC al hilo escritor, que junta
+ * todos los bloques pendientes en un solo `writev()` y los devuelve por otro anillo.
+ * El productor solo toca el sistema operativo si se queda sin bloques libres: con
+ * `descartarSiLleno` comenzarRegistro() rechaza lo que no cabe y solo se espera
+ * por registros más grandes que todos los bloques juntos.
+ */
+class EscritorAsincrono {
+public:
+    static const size_t TAMANO_BLOQUE = 256 * 1024; /**< @brief Bytes por bloque. */
+    static const size_t NUM_BLOQUES = 16;           /**< @brief Bloques del escritor (potencia de 2). */
+
+private:
+    int fd;                    /**< @brief Descriptor del archivo, o -1. */
+    bool cerrarAlTerminar;     /**< @brief `false` si el descriptor es la salida estándar. */
+    bool descartarSiLleno;     /**< @brief Rechazar registros en lugar de esperar bloques libres. */
+    char* memoria;             /**< @brief Memoria de todos los bloques. */
+    BloqueSalida bloques[NUM_BLOQUES]; /**< @brief Los bloques. */
+    BloqueSalida* actual;      /**< @brief Bloque que está llenando el productor, o `nullptr`. */
+
+    AnilloSPSC<BloqueSalida*, NUM_BLOQUES> llenos;  /**< @brief Productor → hilo escritor. */
+    AnilloSPSC<BloqueSalida*, NUM_BLOQUES> libres;  /**< @brief Hilo escritor → productor. */
+    std::atomic<size_t> bloquesLibres;              /**< @brief Bloques publicados en `libres` y aún no tomados. */
+
+    std::thread hilo;                       /**< @brief Hilo escritor. */
+    std::mutex mutex;                       /**< @brief Protege las esperas de ambos hilos. */
+    std::condition_variable despertador;    /**< @brief Avisa al hilo escritor de un bloque lleno o de detener. */
+    std::condition_variable liberado;       /**< @brief Avisa al productor de un bloque libre. */
+    bool detener;                           /**< @brief Pide al hilo que escriba lo pendiente y termine. */
+
+    unsigned long long bytesEscritos;  /**< @brief Bytes escritos en el archivo (solo el hilo escritor). */
+    unsigned long escrituras;          /**< @brief Llamadas a `writev()` (solo el hilo escritor). */
+    std::atomic<bool> fallo;           /**< @brief Una escritura falló; el resto se descarta. */
+    unsigned long descartados;         /**< @brief Registros rechazados por comenzarRegistro() (solo el productor). */
+
+    /**
+     * @brief Cuerpo del hilo escritor.
+     */
+    void ejecutar();
+
+    /**
+     * @brief Reserva los bloques y lanza el hilo escritor sobre `fd`.
+     * @param nombre Archivo o descriptor, para el mensaje de error.
+     * @param descartarSiLleno `true` para rechazar registros cuando no quedan bloques libres.
+     * @return `false` si no hay memoria para los bloques.
+     */
+    bool iniciar(const char* nombre, bool descartarSiLleno);
+
+    /**
+     * @brief (Hilo escritor) Escribe todos los bloques llenos pendientes y los devuelve.
+     * @return `true` si había al menos uno.
+     */
+    bool escribirPendientes();
+
+    /**
+     * @brief (Productor) Pasa el bloque actual al hilo escritor.
+     */
+    void entregarActual();
+
+    /**
+     * @brief (Productor) Toma un bloque libre como bloque actual, esperando si no hay.
+     */
+    void tomarLibre();
+
+public:
+    /**
+     * @brief Constructor de EscritorAsincrono. No abre ningún archivo.
+     */
+    EscritorAsincrono();
+
+    /**
+     * @brief Destructor de EscritorAsincrono. Escribe lo pendiente y cierra el archivo.
+     */
+    ~EscritorAsincrono();
+
+    EscritorAsincrono(const EscritorAsincrono&) = delete;
+    EscritorAsincrono& operator=(const EscritorAsincrono&) = delete;
+
+    /**
+     * @brief Abre (o crea) el archivo, reserva los bloques y lanza el hilo escritor.
+     * @details Cada escritor se abre una sola vez.
+     * @param ruta Archivo de destino ("-" = salida estándar).
+     * @param descartarSiLleno `true` para rechazar registros cuando no quedan bloques libres.
+     * @return `true` si el archivo quedó abierto.
+     */
+    bool abrir(const char* ruta, bool descartarSiLleno);
+
+    /**
+     * @brief Escribe en un descriptor ya abierto (p. ej. 2, el error estándar), que no se cierra al terminar.
+     * @details Cada escritor se abre una sola vez.
+     * @param descriptor Descriptor de destino.
+     * @param descartarSiLleno `true` para rechazar registros cuando no quedan bloques libres.
+     * @return `true` si el escritor quedó listo.
+     */
+    bool abrirDescriptor(int descriptor, bool descartarSiLleno);
+
+    /**
+     * @brief (Productor) Comprueba si un registro de hasta `maximo` bytes cabe sin esperar.
+     * @details Sin `descartarSiLleno` siempre acepta (escribir() esperará si hace falta). Un
+     *          registro que no cabe ni con todos los bloques libres se acepta solo cuando el
+     *          hilo escritor está al día, y escribir() espera a que libere el resto.
+     * @param maximo Cota superior del tamaño del registro.
+     * @return `false` si el registro se debe omitir; se cuenta como descartado.
+     */
+    bool comenzarRegistro(size_t maximo);
+
+    /**
+     * @brief (Productor) Agrega bytes a la salida.
+     * @param datos Bytes a escribir.
+     * @param cantidad Número de bytes.
+     */
+    void escribir(const char* datos, size_t cantidad);
+
+    /**
+     * @brief (Productor) Pasa al hilo escritor lo acumulado aunque el bloque no esté lleno.
+     */
+    void vaciar();
+
+    /**
+     * @brief Escribe todo lo pendiente, detiene el hilo y cierra el archivo.
+     */
+    void cerrar();
+
+    /**
+     * @brief Obtiene los bytes escritos en el archivo.
+     * @details Leer después de cerrar().
+     * @return Bytes escritos.
+     */
+    unsigned long long getBytesEscritos() const;
+
+    /**
+     * @brief Obtiene el número de llamadas al sistema de escritura.
+     * @details Leer después de cerrar().
+     * @return Llamadas a `writev()`.
+     */
+    unsigned long getEscrituras() const;
+
+    /**
+     * @brief Obtiene el número de registros rechazados por falta de bloques libres.
+     * @return Registros descartados.
+     */
+    unsigned long getDescartados() const;
+};
+
+#endif // ESCRITOR_ASINCRONO_H
@@ -0,0 +1,164 @@
+/**
+ * @file FuenteArchivo.cpp
+ * @brief Implementación de la clase FuenteArchivo.
+ */
+
+#include "FuenteArchivo.h"
+#include "Metricas.h"
+#include "ParserTramas.h"
+#include <cstdlib>  // Para malloc, free
+#include <cstring>  // Para strcmp, memmove
+
+#ifdef _WIN32
+    #include <io.h>     // Para _read
+#else
+    #include <unistd.h> // Para read
+#endif
+
+/**
+ * @brief Tamaño del buffer de lectura de la entrada estándar.
+ */
+static const size_t TAMANO_BUFFER_ENTRADA = 64 * 1024;
+
+FuenteArchivo::FuenteArchivo()
+    : datos(nullptr), longitud(0), posicion(0), abierta(false),
+      desdeEntrada(false), finDeEntrada(false), descartados(0), buffer(nullptr) {}
+
+FuenteArchivo::~FuenteArchivo() {
+    cerrar();
+}
+
+bool FuenteArchivo::abrir(const char* ruta) {
+    cerrar();
+
+    if (strcmp(ruta, "-") == 0) {
+        buffer = (char*)malloc(TAMANO_BUFFER_ENTRADA);
+        if (buffer == nullptr) {
+            return false;
+        }
+        desdeEntrada = true;
+        finDeEntrada = false;
+        datos = buffer;
+    } else {
+        if (!archivo.abrir(ruta)) {
+            return false;
+        }
+        datos = archivo.getDatos();
+        longitud = archivo.getLongitud();
+        divisor = DivisorTramas(datos, longitud);
+    }
+
+    abierta = true;
+    return true;
+}
+
+void FuenteArchivo::cerrar() {
+    archivo.cerrar();
+    divisor = DivisorTramas();
+    free(buffer);
+    buffer = nullptr;
+    datos = nullptr;
+    longitud = 0;
+    posicion = 0;
+    abierta = false;
+    desdeEntrada = false;
+    finDeEntrada = false;
+    descartados = 0;
+}
+
+bool FuenteArchivo::rellenarBuffer() {
+    if (finDeEntrada) {
+        return false;
+    }
+
+    // Compactar: mover al inicio la línea parcial pendiente
+    size_t pendientes = longitud - posicion;
+    if (pendientes > 0 && posicion > 0) {
+        memmove(buffer, buffer + posicion, pendientes);
+    }
+    descartados += posicion;
+    longitud = pendientes;
+    posicion = 0;
+
+#ifdef _WIN32
+    int n = _read(0, buffer + longitud, (unsigned int)(TAMANO_BUFFER_ENTRADA - longitud));
+#else
+    ssize_t n = read(0, buffer + longitud, TAMANO_BUFFER_ENTRADA - longitud);
+#endif
+    if (n <= 0) {
+        finDeEntrada = true;
+        return false;
+    }
+    longitud += (size_t)n;
+    marcarLlegada((size_t)n);
+    return true;
+}
+
+bool FuenteArchivo::leerLinea(VistaLinea* linea) {
+    if (!abierta || linea == nullptr) {
+        return false;
+    }
+
+    if (!desdeEntrada) {
+        return divisor.siguiente(linea);
+    }
+
+    while (true) {
+        size_t inicio, longitudLinea, consumidos;
+        bool finDeDatos = finDeEntrada;
+        bool completa = separarLinea(datos + posicion, longitud - posicion, finDeDatos,
+                                     &inicio, &longitudLinea, &consumidos);
+        if (completa) {
+            linea->datos = datos + posicion + inicio;
+            linea->longitud = longitudLinea;
+            posicion += consumidos;
+            return true;
+        }
+        posicion += consumidos;
+
+        if (!rellenarBuffer()) {
+            if (!finDeDatos) {
+                continue; // Recién se llegó al fin: entregar la última línea sin terminador
+            }
+            return false;
+        }
+    }
+}
+
+bool FuenteArchivo::agotada() const {
+    if (!abierta) {
+        return true;
+    }
+    if (desdeEntrada) {
+        return finDeEntrada && posicion >= longitud;
+    }
+    return divisor.getPosicion() >= datos + longitud;
+}
+
+size_t FuenteArchivo::getPosicion() const {
+    if (desdeEntrada) {
+        return descartados + posicion;
+    }
+    return (size_t)(divisor.getPosicion() - datos);
+}
+
+bool FuenteArchivo::saltarHasta(size_t desplazamiento) {
+    if (!abierta) {
+        return false;
+    }
+    if (!desdeEntrada) {
+        if (desplazamiento > longitud) {
+            return false;
+        }
+        divisor = DivisorTramas(datos + desplazamiento, longitud - desplazamiento);
+        return true;
+    }
+    while (descartados + longitud < desplazamiento) {
+        posicion = longitud; // Todo lo que hay en el buffer queda antes del destino
+        if (!rellenarBuffer()) {
+            return false;
+        }
+    }
+    posicion = desplazamiento - descartados;
+    return true;
+}
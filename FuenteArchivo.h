@@ -0,0 +1,100 @@
+/**
+ * @file FuenteArchivo.h
+ * @brief Define una fuente de tramas que lee una captura grabada (archivo o entrada estándar).
+ */
+
+#ifndef FUENTE_ARCHIVO_H
+#define FUENTE_ARCHIVO_H
+
+#include "FuenteTramas.h"
+#include "ArchivoMapeado.h"
+#include "DivisorTramas.h"
+
+/**
+ * @class FuenteArchivo
+ * @brief Fuente de tramas para reproducir capturas sin hardware.
+ *
+ * - Un archivo se proyecta en memoria y un DivisorTramas entrega las líneas
+ *   apuntando directamente a la proyección (sin copias ni llamadas al sistema por línea).
+ * - La ruta "-" lee de la entrada estándar en bloques, para poder encadenar
+ *   el decodificador con otras herramientas mediante tuberías.
+ *
+ * A diferencia de SerialPort, abrir la fuente no espera el reinicio del Arduino.
+ */
+class FuenteArchivo : public FuenteTramas {
+private:
+    ArchivoMapeado archivo; /**< @brief Proyección del archivo (no se usa con la entrada estándar). */
+    const char* datos;      /**< @brief Bytes a recorrer: la proyección o el buffer de entrada. */
+    size_t longitud;        /**< @brief Bytes válidos en `datos`. */
+    size_t posicion;        /**< @brief Primer byte aún no consumido. */
+    bool abierta;           /**< @brief Indica si hay una captura abierta. */
+    bool desdeEntrada;      /**< @brief `true` si se lee de la entrada estándar. */
+    bool finDeEntrada;      /**< @brief `true` cuando la entrada estándar llegó a su fin. */
+    size_t descartados;     /**< @brief Bytes de la entrada estándar que ya salieron del buffer. */
+    char* buffer;           /**< @brief Buffer de lectura de la entrada estándar. */
+    DivisorTramas divisor;  /**< @brief Separador vectorizado de las líneas del archivo proyectado. */
+
+    /**
+     * @brief Lee otro bloque de la entrada estándar, conservando la línea parcial pendiente.
+     * @return `true` si se recibieron bytes, `false` al llegar al fin de la entrada.
+     */
+    bool rellenarBuffer();
+
+public:
+    /**
+     * @brief Constructor de FuenteArchivo.
+     * Inicializa la fuente sin ninguna captura abierta.
+     */
+    FuenteArchivo();
+
+    /**
+     * @brief Destructor de FuenteArchivo.
+     * Libera la proyección o el buffer de lectura.
+     */
+    ~FuenteArchivo() override;
+
+    /**
+     * @brief Abre una captura.
+     * @param ruta Ruta del archivo, o "-" para la entrada estándar.
+     * @return `true` si la captura se abrió correctamente, `false` en caso contrario.
+     */
+    bool abrir(const char* ruta);
+
+    /**
+     * @brief Cierra la captura.
+     */
+    void cerrar();
+
+    /**
+     * @brief Lee la siguiente línea de la captura sin copiarla.
+     * @details La vista no está terminada en '\0'; use `linea->longitud`.
+     * @param linea Salida: vista de la línea leída.
+     * @return `true` si se leyó una línea, `false` al llegar al final de la captura.
+     */
+    bool leerLinea(VistaLinea* linea) override;
+
+    /**
+     * @brief Indica si la captura ya se recorrió por completo.
+     * @return `true` si no quedan líneas por leer.
+     */
+    bool agotada() const override;
+
+    /**
+     * @brief Obtiene cuántos bytes de la captura se consumieron (hasta el final de la última línea leída).
+     * @return Desplazamiento desde el inicio de la captura.
+     */
+    size_t getPosicion() const;
+
+    /**
+     * @brief Continúa la lectura en un desplazamiento guardado con getPosicion().
+     *
+     * Con un archivo es inmediato; con la entrada estándar se leen y descartan los
+     * bytes intermedios.
+     *
+     * @param desplazamiento Bytes desde el inicio de la captura.
+     * @return `true` si la captura llega hasta ese desplazamiento.
+     */
+    bool saltarHasta(size_t desplazamiento);
+};
+
+#endif // FUENTE_ARCHIVO_H
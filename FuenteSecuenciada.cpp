@@ -0,0 +1,329 @@
+/**
+ * @file FuenteSecuenciada.cpp
+ * @brief Implementación de la validación y el reordenamiento de tramas secuenciadas.
+ */
+
+#include "FuenteSecuenciada.h"
+#include "Crc8.h"
+#include <cstring>  // Para memcpy
+#include <iostream>
+
+/**
+ * @brief Valor de un dígito hexadecimal.
+ * @param c Carácter a convertir.
+ * @return El valor (0..15), o -1 si no es un dígito hexadecimal.
+ */
+static int valorHexadecimal(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'A' && c <= 'F') {
+        return c - 'A' + 10;
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+
+bool validarTramaSecuenciada(const VistaLinea& linea, uint16_t* secuencia, VistaLinea* cuerpo) {
+    const char* datos = linea.datos;
+    size_t longitud = linea.longitud;
+    // Lo mínimo es "F,0,L,X,CC"
+    if (longitud < 10 || datos[0] != 'F' || datos[1] != ',' || datos[longitud - 3] != ',') {
+        return false;
+    }
+    int alto = valorHexadecimal(datos[longitud - 2]);
+    int bajo = valorHexadecimal(datos[longitud - 1]);
+    if (alto < 0 || bajo < 0) {
+        return false;
+    }
+    size_t protegidos = longitud - 3;
+    if (calcularCrc8((const unsigned char*)datos, protegidos) != (uint8_t)(alto * 16 + bajo)) {
+        return false;
+    }
+
+    size_t i = 2;
+    unsigned long valor = 0;
+    while (i < protegidos && datos[i] >= '0' && datos[i] <= '9' && i < 7) {
+        valor = valor * 10 + (unsigned long)(datos[i] - '0');
+        ++i;
+    }
+    if (i == 2 || i >= protegidos || datos[i] != ',' || valor > 65535) {
+        return false;
+    }
+    ++i;
+    if (protegidos - i > MAXIMO_CUERPO_SECUENCIADO) {
+        return false;
+    }
+    *secuencia = (uint16_t)valor;
+    cuerpo->datos = datos + i;
+    cuerpo->longitud = protegidos - i;
+    return true;
+}
+
+size_t codificarTramaSecuenciada(uint16_t secuencia, const char* cuerpo, size_t longitud, char* salida) {
+    static const char HEXADECIMAL[] = "0123456789ABCDEF";
+    if (longitud > MAXIMO_CUERPO_SECUENCIADO) {
+        return 0;
+    }
+    char digitos[5];
+    int numDigitos = 0;
+    unsigned int valor = secuencia;
+    do {
+        digitos[numDigitos++] = (char)('0' + valor % 10);
+        valor /= 10;
+    } while (valor > 0);
+
+    size_t n = 0;
+    salida[n++] = 'F';
+    salida[n++] = ',';
+    while (numDigitos > 0) {
+        salida[n++] = digitos[--numDigitos];
+    }
+    salida[n++] = ',';
+    memcpy(salida + n, cuerpo, longitud);
+    n += longitud;
+    uint8_t crc = calcularCrc8((const unsigned char*)salida, n);
+    salida[n++] = ',';
+    salida[n++] = HEXADECIMAL[crc >> 4];
+    salida[n++] = HEXADECIMAL[crc & 0x0F];
+    return n;
+}
+
+FuenteSecuenciada::FuenteSecuenciada(FuenteTramas* interna, bool propietaria)
+    : interna(interna), propietaria(propietaria), sincronizada(false), esperada(0), ocupadas(0),
+      inicioSalida(0), finSalida(0), recibidas(0), corruptas(0), duplicadas(0), perdidas(0),
+      reordenadas(0), tardias(0), resincronizaciones(0), hayCandidata(false) {
+    candidata.secuencia = 0;
+    for (size_t i = 0; i < VENTANA_REORDEN; ++i) {
+        ranuras[i].ocupada = false;
+    }
+}
+
+FuenteSecuenciada::~FuenteSecuenciada() {
+    if (propietaria) {
+        delete interna;
+    }
+}
+
+void FuenteSecuenciada::encolar(const char* cuerpo, size_t longitud) {
+    Ranura& destino = salida[finSalida++];
+    destino.longitud = (uint8_t)longitud;
+    memcpy(destino.cuerpo, cuerpo, longitud);
+}
+
+void FuenteSecuenciada::avanzarVentana() {
+    Ranura& primera = ranuras[esperada % VENTANA_REORDEN];
+    if (primera.ocupada) {
+        encolar(primera.cuerpo, primera.longitud);
+        primera.ocupada = false;
+        ocupadas--;
+    } else {
+        perdidas++;
+    }
+    esperada++;
+}
+
+void FuenteSecuenciada::vaciarVentana() {
+    while (ocupadas > 0) {
+        avanzarVentana();
+    }
+}
+
+bool FuenteSecuenciada::admitir(uint16_t secuencia, const VistaLinea& cuerpo) {
+    if (!sincronizada) {
+        // El Arduino pudo empezar a transmitir antes de que abriéramos el puerto
+        sincronizada = true;
+        esperada = secuencia;
+    }
+    int distancia = (int16_t)(uint16_t)(secuencia - esperada);
+    bool lejana = distancia < -(int)VENTANA_REORDEN || distancia >= (int)MAXIMO_SALTO_SECUENCIA;
+    if (lejana) {
+        // Una trama suelta muy atrasada o muy adelantada se descarta; si la siguiente la
+        // continúa (salvo alguna perdida), es que el Arduino se reinició o la conexión
+        // estuvo caída mucho tiempo
+        int desdeCandidata = (int16_t)(uint16_t)(secuencia - candidata.secuencia);
+        if (!hayCandidata || desdeCandidata <= 0 || desdeCandidata > (int)MAXIMO_HUECO_REINICIO) {
+            if (hayCandidata) {
+                tardias++;
+            }
+            hayCandidata = true;
+            candidata.secuencia = secuencia;
+            candidata.longitud = (uint8_t)cuerpo.longitud;
+            memcpy(candidata.cuerpo, cuerpo.datos, cuerpo.longitud);
+            return false;
+        }
+        vaciarVentana();
+        resincronizaciones++;
+        hayCandidata = false;
+        encolar(candidata.cuerpo, candidata.longitud);
+        esperada = (uint16_t)(candidata.secuencia + 1);
+        distancia = desdeCandidata - 1;
+    } else if (hayCandidata) {
+        hayCandidata = false;
+        tardias++;
+    }
+
+    if (distancia < 0) {
+        duplicadas++;
+        return false;
+    }
+    // Algo adelantada: dar por perdidas las más viejas hasta que quepa en la ventana
+    while (distancia >= (int)VENTANA_REORDEN) {
+        avanzarVentana();
+        distancia--;
+    }
+    while (distancia > 0 && ranuras[esperada % VENTANA_REORDEN].ocupada) {
+        avanzarVentana(); // Las que seguían al último hueco ya se pueden entregar
+        distancia--;
+    }
+
+    if (distancia > 0) {
+        Ranura& ranura = ranuras[secuencia % VENTANA_REORDEN];
+        if (ranura.ocupada) {
+            duplicadas++;
+        } else {
+            ranura.ocupada = true;
+            ranura.longitud = (uint8_t)cuerpo.longitud;
+            memcpy(ranura.cuerpo, cuerpo.datos, cuerpo.longitud);
+            ocupadas++;
+            reordenadas++;
+        }
+        return false;
+    }
+
+    // Es la esperada: va directo si no hay nada antes en la cola, y libera las que la seguían
+    esperada++;
+    bool directa = inicioSalida == finSalida;
+    if (!directa) {
+        encolar(cuerpo.datos, cuerpo.longitud);
+    }
+    while (ocupadas > 0 && ranuras[esperada % VENTANA_REORDEN].ocupada) {
+        avanzarVentana();
+    }
+    return directa;
+}
+
+bool FuenteSecuenciada::entregarSalida(VistaLinea* linea) {
+    if (inicioSalida == finSalida) {
+        return false;
+    }
+    const Ranura& siguiente = salida[inicioSalida++];
+    linea->datos = siguiente.cuerpo;
+    linea->longitud = siguiente.longitud;
+    return true;
+}
+
+bool FuenteSecuenciada::leerLinea(VistaLinea* linea) {
+    if (entregarSalida(linea)) {
+        return true;
+    }
+    inicioSalida = 0;
+    finSalida = 0;
+
+    VistaLinea entrada;
+    while (interna->leerLinea(&entrada)) {
+        if (entrada.longitud < 2 || entrada.datos[0] != 'F' || entrada.datos[1] != ',') {
+            *linea = entrada; // Mensaje del Arduino o trama sin secuencia
+            return true;
+        }
+        uint16_t secuencia;
+        VistaLinea cuerpo;
+        if (!validarTramaSecuenciada(entrada, &secuencia, &cuerpo)) {
+            corruptas++;
+            continue;
+        }
+        recibidas++;
+        if (admitir(secuencia, cuerpo)) {
+            *linea = cuerpo; // Apunta al buffer de la fuente interna, igual que sin secuencia
+            return true;
+        }
+        if (entregarSalida(linea)) {
+            return true;
+        }
+    }
+
+    if (interna->agotada()) {
+        vaciarVentana();
+        return entregarSalida(linea);
+    }
+    return false;
+}
+
+bool FuenteSecuenciada::agotada() const {
+    return interna->agotada() && ocupadas == 0 && inicioSalida == finSalida;
+}
+
+bool FuenteSecuenciada::esperarDatos(int milisegundos) {
+    if (ocupadas == 0) {
+        return interna->esperarDatos(milisegundos);
+    }
+    int plazo = (milisegundos < 0 || milisegundos > PLAZO_REORDEN_MS) ? PLAZO_REORDEN_MS : milisegundos;
+    if (interna->esperarDatos(plazo)) {
+        return true;
+    }
+    if (plazo == PLAZO_REORDEN_MS && inicioSalida == finSalida) {
+        // La trama que falta ya no va a llegar: entregar las retenidas
+        inicioSalida = 0;
+        finSalida = 0;
+        vaciarVentana();
+        return true;
+    }
+    return false;
+}
+
+void FuenteSecuenciada::despertar() {
+    interna->despertar();
+}
+
+int FuenteSecuenciada::descriptor() const {
+    return interna->descriptor();
+}
+
+bool FuenteSecuenciada::sinRetenidas() const {
+    return ocupadas == 0 && inicioSalida == finSalida;
+}
+
+int FuenteSecuenciada::getSiguiente() const {
+    return sincronizada ? (int)esperada : -1;
+}
+
+void FuenteSecuenciada::reanudarEn(uint16_t siguiente) {
+    sincronizada = true;
+    esperada = siguiente;
+}
+
+void FuenteSecuenciada::imprimirContadores() const {
+    std::cout << "Tramas secuenciadas: " << recibidas << " (perdidas: " << perdidas
+              << ", duplicadas: " << duplicadas << ", corruptas: " << corruptas
+              << ", reordenadas: " << reordenadas << ", tardías: " << tardias;
+    if (resincronizaciones > 0) {
+        std::cout << ", reinicios: " << resincronizaciones;
+    }
+    std::cout << ")." << std::endl;
+}
+
+unsigned long FuenteSecuenciada::getRecibidas() const {
+    return recibidas;
+}
+
+unsigned long FuenteSecuenciada::getCorruptas() const {
+    return corruptas;
+}
+
+unsigned long FuenteSecuenciada::getDuplicadas() const {
+    return duplicadas;
+}
+
+unsigned long FuenteSecuenciada::getPerdidas() const {
+    return perdidas;
+}
+
+unsigned long FuenteSecuenciada::getReordenadas() const {
+    return reordenadas;
+}
+
+unsigned long FuenteSecuenciada::getTardias() const {
+    return tardias;
+}
@@ -0,0 +1,258 @@
+/**
+ * @file FuenteSecuenciada.h
+ * @brief Define la fuente que valida y reordena las tramas con número de secuencia y CRC.
+ */
+
+#ifndef FUENTE_SECUENCIADA_H
+#define FUENTE_SECUENCIADA_H
+
+#include <cstddef>
+#include <cstdint>
+#include "FuenteTramas.h"
+
+/**
+ * @brief Número de tramas que la ventana de reordenamiento puede retener.
+ *
+ * Debe dividir a 65536 para que el índice de ranura siga siendo válido cuando la
+ * secuencia da la vuelta.
+ */
+const size_t VENTANA_REORDEN = 64;
+
+/**
+ * @brief Adelanto a partir del cual una trama se trata como tardía o como reinicio, en lugar de dar por perdidas las intermedias.
+ */
+const size_t MAXIMO_SALTO_SECUENCIA = 4 * VENTANA_REORDEN;
+
+/**
+ * @brief Distancia máxima entre dos tramas lejanas seguidas para tomarlas como un reinicio.
+ */
+const int MAXIMO_HUECO_REINICIO = 3;
+
+/**
+ * @brief Longitud máxima del cuerpo (`L,X` / `M,<rotor>,N`) de una trama secuenciada.
+ */
+const size_t MAXIMO_CUERPO_SECUENCIADO = 32;
+
+/**
+ * @brief Tiempo que se espera una trama faltante antes de darla por perdida, con tramas retenidas.
+ */
+const int PLAZO_REORDEN_MS = 250;
+
+/**
+ * @brief Valida una línea `F,<seq>,<cuerpo>,<crc>` y extrae sus partes sin copiarlas.
+ *
+ * - `seq`: número de secuencia decimal de 0 a 65535; después de 65535 sigue 0.
+ * - `cuerpo`: una línea normal del protocolo (`L,X`, `M,N` o `M,<rotor>,N`).
+ * - `crc`: dos dígitos hexadecimales con el CRC-8 (ver Crc8.h) de todos los bytes
+ *   anteriores a la última coma, es decir, de `F,<seq>,<cuerpo>`.
+ *
+ * @param linea Línea recibida.
+ * @param secuencia Salida: número de secuencia.
+ * @param cuerpo Salida: vista del cuerpo dentro de `linea`.
+ * @return `true` si la trama está bien formada y su CRC coincide.
+ */
+bool validarTramaSecuenciada(const VistaLinea& linea, uint16_t* secuencia, VistaLinea* cuerpo);
+
+/**
+ * @brief Escribe una línea `F,<seq>,<cuerpo>,<crc>` (sin terminador de línea).
+ * @param secuencia Número de secuencia.
+ * @param cuerpo Línea del protocolo a transportar.
+ * @param longitud Longitud del cuerpo (hasta MAXIMO_CUERPO_SECUENCIADO).
+ * @param salida Buffer de al menos MAXIMO_CUERPO_SECUENCIADO + 12 bytes.
+ * @return Bytes escritos, o 0 si el cuerpo es demasiado largo.
+ */
+size_t codificarTramaSecuenciada(uint16_t secuencia, const char* cuerpo, size_t longitud, char* salida);
+
+/**
+ * @class FuenteSecuenciada
+ * @brief Fuente que se coloca delante de otra y entrega en orden los cuerpos de las tramas secuenciadas.
+ *
+ * Las tramas con CRC incorrecto se descartan. Las que llegan adelantadas se retienen
+ * en una ventana de VENTANA_REORDEN ranuras hasta que llegan las que faltan; si la
+ * ventana se llena, o no llega nada durante PLAZO_REORDEN_MS, los huecos se dan por
+ * perdidos. Las tramas repetidas se descartan. Una trama más atrasada que la ventana,
+ * o adelantada MAXIMO_SALTO_SECUENCIA o más, se descarta como tardía, salvo que la
+ * siguiente la continúe: entonces se toma como un reinicio del Arduino y se vuelve a
+ * sincronizar desde ella.
+ *
+ * Las líneas que no empiezan con `F,` (mensajes del Arduino, tramas sin secuencia)
+ * pasan sin cambios, así que el resto del programa no distingue los dos modos. Una
+ * trama que llega en orden se entrega sin copiarla.
+ */
+class FuenteSecuenciada : public FuenteTramas {
+private:
+    /**
+     * @struct Ranura
+     * @brief Cuerpo de una trama retenida o pendiente de entrega.
+     */
+    struct Ranura {
+        bool ocupada;                         /**< @brief La ranura tiene una trama retenida. */
+        uint16_t secuencia;                   /**< @brief Número de secuencia (solo en `candidata`). */
+        uint8_t longitud;                     /**< @brief Longitud del cuerpo. */
+        char cuerpo[MAXIMO_CUERPO_SECUENCIADO]; /**< @brief Copia del cuerpo. */
+    };
+
+    FuenteTramas* interna;       /**< @brief Fuente de donde se leen las líneas. */
+    bool propietaria;            /**< @brief Liberar `interna` en el destructor. */
+    bool sincronizada;           /**< @brief Ya se recibió la primera trama secuenciada. */
+    uint16_t esperada;           /**< @brief Siguiente secuencia a entregar. */
+    size_t ocupadas;             /**< @brief Ranuras ocupadas de la ventana. */
+    Ranura ranuras[VENTANA_REORDEN];      /**< @brief Ventana indexada por secuencia % VENTANA_REORDEN. */
+    Ranura salida[VENTANA_REORDEN + 1];   /**< @brief Cuerpos liberados de la ventana, en orden de entrega. */
+    size_t inicioSalida;         /**< @brief Siguiente cuerpo de `salida` a entregar. */
+    size_t finSalida;            /**< @brief Número de cuerpos en `salida`. */
+
+    unsigned long recibidas;     /**< @brief Tramas secuenciadas con CRC correcto. */
+    unsigned long corruptas;     /**< @brief Tramas mal formadas o con CRC incorrecto. */
+    unsigned long duplicadas;    /**< @brief Tramas ya entregadas o ya retenidas. */
+    unsigned long perdidas;      /**< @brief Secuencias que nunca llegaron. */
+    unsigned long reordenadas;   /**< @brief Tramas que llegaron adelantadas y se retuvieron. */
+    unsigned long tardias;       /**< @brief Tramas sueltas fuera de la ventana, descartadas. */
+    unsigned long resincronizaciones; /**< @brief Saltos tomados como reinicio del Arduino. */
+    bool hayCandidata;           /**< @brief `candidata` guarda una trama fuera de la ventana. */
+    Ranura candidata;            /**< @brief Trama lejana que, si la siguiente la continúa, marca un reinicio. */
+
+    /**
+     * @brief Agrega un cuerpo a la cola de entrega.
+     * @param cuerpo Cuerpo a copiar.
+     * @param longitud Longitud del cuerpo.
+     */
+    void encolar(const char* cuerpo, size_t longitud);
+
+    /**
+     * @brief Libera la primera posición de la ventana (a la cola, o como perdida si está vacía).
+     */
+    void avanzarVentana();
+
+    /**
+     * @brief Libera todas las tramas retenidas, dando por perdidos los huecos entre ellas.
+     */
+    void vaciarVentana();
+
+    /**
+     * @brief Ubica una trama válida en la ventana.
+     * @param secuencia Número de secuencia de la trama.
+     * @param cuerpo Cuerpo de la trama.
+     * @return `true` si la trama se debe entregar ya, sin copia (antes que la cola).
+     */
+    bool admitir(uint16_t secuencia, const VistaLinea& cuerpo);
+
+    /**
+     * @brief Entrega el siguiente cuerpo de la cola, si lo hay.
+     * @param linea Salida: vista del cuerpo (válida hasta la siguiente lectura).
+     * @return `true` si la cola tenía algún cuerpo.
+     */
+    bool entregarSalida(VistaLinea* linea);
+
+public:
+    /**
+     * @brief Constructor de FuenteSecuenciada.
+     * @param interna Fuente ya abierta de donde leer las líneas.
+     * @param propietaria `true` si esta fuente debe liberar `interna` (creada con `new`).
+     */
+    FuenteSecuenciada(FuenteTramas* interna, bool propietaria);
+
+    /**
+     * @brief Destructor de FuenteSecuenciada.
+     */
+    ~FuenteSecuenciada() override;
+
+    FuenteSecuenciada(const FuenteSecuenciada&) = delete;
+    FuenteSecuenciada& operator=(const FuenteSecuenciada&) = delete;
+
+    /**
+     * @brief Lee la siguiente línea en orden de secuencia.
+     *
+     * Al agotarse la fuente interna se entregan las tramas que quedaban retenidas.
+     *
+     * @param linea Salida: cuerpo de la trama (o la línea sin secuencia tal cual).
+     * @return `true` si se leyó una línea, `false` si no hay datos disponibles ahora.
+     */
+    bool leerLinea(VistaLinea* linea) override;
+
+    /**
+     * @brief Indica si ya no quedan líneas ni en la fuente interna ni en la ventana.
+     * @return `true` si la fuente se agotó.
+     */
+    bool agotada() const override;
+
+    /**
+     * @brief Espera datos de la fuente interna; con tramas retenidas, como mucho PLAZO_REORDEN_MS.
+     * @param milisegundos Plazo máximo, o -1 para esperar sin límite.
+     * @return `true` si puede haber datos nuevos o se liberaron tramas retenidas.
+     */
+    bool esperarDatos(int milisegundos) override;
+
+    /**
+     * @brief Interrumpe la espera de la fuente interna.
+     */
+    void despertar() override;
+
+    /**
+     * @brief Descriptor de la fuente interna.
+     * @return El descriptor, o -1 si la fuente interna no tiene.
+     */
+    int descriptor() const override;
+
+    /**
+     * @brief Indica si no hay tramas retenidas ni pendientes de entrega.
+     * @details Solo entonces getSiguiente() marca exactamente hasta dónde se procesó el flujo.
+     * @return `true` si la ventana y la cola de entrega están vacías.
+     */
+    bool sinRetenidas() const;
+
+    /**
+     * @brief Obtiene la siguiente secuencia que se espera entregar.
+     * @return La secuencia (0..65535), o -1 si aún no llegó ninguna trama secuenciada.
+     */
+    int getSiguiente() const;
+
+    /**
+     * @brief Continúa un flujo ya empezado (p. ej. al reanudar desde un punto de control).
+     * @param siguiente Siguiente secuencia a entregar; las anteriores se tratan como duplicadas.
+     */
+    void reanudarEn(uint16_t siguiente);
+
+    /**
+     * @brief Muestra en consola los contadores de integridad.
+     */
+    void imprimirContadores() const;
+
+    /**
+     * @brief Obtiene el número de tramas secuenciadas válidas recibidas.
+     * @return Tramas con CRC correcto.
+     */
+    unsigned long getRecibidas() const;
+
+    /**
+     * @brief Obtiene el número de tramas descartadas por estar dañadas.
+     * @return Tramas mal formadas o con CRC incorrecto.
+     */
+    unsigned long getCorruptas() const;
+
+    /**
+     * @brief Obtiene el número de tramas repetidas descartadas.
+     * @return Tramas duplicadas.
+     */
+    unsigned long getDuplicadas() const;
+
+    /**
+     * @brief Obtiene el número de secuencias que nunca llegaron.
+     * @return Tramas perdidas.
+     */
+    unsigned long getPerdidas() const;
+
+    /**
+     * @brief Obtiene el número de tramas que llegaron adelantadas y se retuvieron.
+     * @return Tramas reordenadas.
+     */
+    unsigned long getReordenadas() const;
+
+    /**
+     * @brief Obtiene el número de tramas sueltas descartadas por llegar fuera de la ventana.
+     * @return Tramas tardías.
+     */
+    unsigned long getTardias() const;
+};
+
+#endif // FUENTE_SECUENCIADA_H
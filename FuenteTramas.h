@@ -0,0 +1,81 @@
+/**
+ * @file FuenteTramas.h
+ * @brief Define la interfaz abstracta de las fuentes de líneas de tramas PRT-7.
+ */
+
+#ifndef FUENTE_TRAMAS_H
+#define FUENTE_TRAMAS_H
+
+#include <cstddef>
+
+/**
+ * @struct VistaLinea
+ * @brief Referencia (sin copia) a una línea dentro de un buffer de la fuente.
+ *
+ * Solo es válida hasta la siguiente lectura de la misma fuente. Use siempre
+ * `longitud`: según la fuente, la línea puede no estar terminada en '\0'
+ * (p. ej. cuando apunta a un archivo proyectado en memoria de solo lectura).
+ */
+struct VistaLinea {
+    const char* datos; /**< @brief Primer carácter de la línea. */
+    size_t longitud;   /**< @brief Número de caracteres, sin terminadores de línea. */
+};
+
+/**
+ * @class FuenteTramas
+ * @brief Interfaz común para todo origen de líneas `L,X` / `M,N`.
+ *
+ * Permite que el mismo bucle de parseo y `procesar` funcione con un puerto serial
+ * en vivo (SerialPort) o con una captura grabada (FuenteArchivo).
+ */
+class FuenteTramas {
+public:
+    /**
+     * @brief Lee la siguiente línea sin copiarla.
+     *
+     * Las líneas vacías se omiten y las de más de LONGITUD_MAXIMA_LINEA caracteres
+     * se entregan en fragmentos, igual en todas las fuentes.
+     *
+     * @param linea Salida: vista de la línea leída.
+     * @return `true` si se leyó una línea, `false` si no hay datos disponibles ahora.
+     */
+    virtual bool leerLinea(VistaLinea* linea) = 0;
+
+    /**
+     * @brief Indica si la fuente ya no entregará más líneas (fin de archivo o desconexión).
+     * @return `true` si la fuente se agotó.
+     */
+    virtual bool agotada() const = 0;
+
+    /**
+     * @brief Duerme hasta que haya bytes nuevos, se llame a despertar() o venza el plazo.
+     * @details La implementación por defecto no espera: la fuente siempre tiene datos listos.
+     * @param milisegundos Plazo máximo, o -1 para esperar sin límite.
+     * @return `true` si puede haber datos nuevos, `false` si venció el plazo o se interrumpió la espera.
+     */
+    virtual bool esperarDatos(int milisegundos) {
+        (void)milisegundos;
+        return true;
+    }
+
+    /**
+     * @brief Interrumpe una llamada en curso (o la próxima) a esperarDatos().
+     * @details Debe ser seguro llamarla desde un manejador de señales.
+     */
+    virtual void despertar() {}
+
+    /**
+     * @brief Descriptor que se puede vigilar con poll()/epoll para saber si hay datos.
+     * @return El descriptor, o -1 si la fuente siempre tiene datos listos (p. ej. un archivo).
+     */
+    virtual int descriptor() const {
+        return -1;
+    }
+
+    /**
+     * @brief Destructor virtual obligatorio.
+     */
+    virtual ~FuenteTramas() {}
+};
+
+#endif // FUENTE_TRAMAS_H
@@ -0,0 +1,109 @@
+/**
+ * @file GeneradorTramas.cpp
+ * @brief Implementación del generador de flujos PRT-7 sintéticos.
+ */
+
+#include "GeneradorTramas.h"
+#include <cstdio>   // Para snprintf
+#include <cstdlib>  // Para malloc
+#include <cstring>  // Para memcpy
+
+/**
+ * @brief Líneas informativas que el Arduino intercala en el flujo.
+ */
+static const char* const LINEAS_RUIDO[] = {
+    "Iniciando transmision PRT-7",
+    "L,",
+    "M,x",
+    "L;A",
+    "M,2,",
+};
+
+static const size_t NUM_LINEAS_RUIDO = sizeof(LINEAS_RUIDO) / sizeof(LINEAS_RUIDO[0]);
+
+ConfiguracionGenerador::ConfiguracionGenerador()
+    : semilla(1), bytes(8 * 1024 * 1024), proporcionCargas(0.9), distribucion(ROTACION_UNIFORME),
+      rotacionMaxima(13), finDeLinea(FIN_LF), proporcionRuido(0.0) {}
+
+GeneradorTramas::GeneradorTramas(uint64_t semilla) : estado(semilla != 0 ? semilla : 0x9E3779B97F4A7C15ULL) {}
+
+uint64_t GeneradorTramas::siguiente() {
+    estado ^= estado >> 12;
+    estado ^= estado << 25;
+    estado ^= estado >> 27;
+    return estado * 0x2545F4914F6CDD1DULL;
+}
+
+uint32_t GeneradorTramas::siguienteMenorQue(uint32_t n) {
+    return (uint32_t)(((siguiente() >> 32) * n) >> 32);
+}
+
+double GeneradorTramas::siguienteUniforme() {
+    return (double)(siguiente() >> 11) * (1.0 / 9007199254740992.0);
+}
+
+size_t GeneradorTramas::generarLinea(const ConfiguracionGenerador& configuracion, char* salida) {
+    size_t n = 0;
+    if (configuracion.proporcionRuido > 0.0 && siguienteUniforme() < configuracion.proporcionRuido) {
+        const char* ruido = LINEAS_RUIDO[siguienteMenorQue((uint32_t)NUM_LINEAS_RUIDO)];
+        n = strlen(ruido);
+        memcpy(salida, ruido, n);
+    } else if (siguienteUniforme() < configuracion.proporcionCargas) {
+        // Sobre todo mayúsculas y espacios; algunas minúsculas y algún símbolo fuera del alfabeto
+        uint32_t r = siguienteMenorQue(100);
+        char dato;
+        if (r < 85) {
+            dato = (char)('A' + siguienteMenorQue(26));
+        } else if (r < 93) {
+            dato = ' ';
+        } else if (r < 98) {
+            dato = (char)('a' + siguienteMenorQue(26));
+        } else {
+            dato = '#';
+        }
+        salida[n++] = 'L';
+        salida[n++] = ',';
+        salida[n++] = dato;
+    } else {
+        int rotacion;
+        if (configuracion.distribucion == ROTACION_EXTREMA) {
+            rotacion = (int)siguienteMenorQue(2000001) - 1000000;
+        } else if (configuracion.distribucion == ROTACION_PEQUENA) {
+            int magnitud = 1;
+            while (magnitud < configuracion.rotacionMaxima && (siguiente() & 1) != 0) {
+                magnitud++;
+            }
+            rotacion = (siguiente() & 1) != 0 ? magnitud : -magnitud;
+        } else {
+            int maximo = configuracion.rotacionMaxima > 0 ? configuracion.rotacionMaxima : 1;
+            rotacion = (int)siguienteMenorQue((uint32_t)(2 * maximo + 1)) - maximo;
+        }
+        n = (size_t)snprintf(salida, 24, "M,%d", rotacion);
+    }
+
+    FinDeLinea fin = configuracion.finDeLinea;
+    if (fin == FIN_MIXTO) {
+        fin = (FinDeLinea)siguienteMenorQue(3);
+    }
+    if (fin == FIN_CRLF || fin == FIN_CR) {
+        salida[n++] = '\r';
+    }
+    if (fin == FIN_CRLF || fin == FIN_LF) {
+        salida[n++] = '\n';
+    }
+    return n;
+}
+
+char* GeneradorTramas::generar(const ConfiguracionGenerador& configuracion, size_t* longitud) {
+    char* flujo = (char*)malloc(configuracion.bytes + 64);
+    if (flujo == nullptr) {
+        return nullptr;
+    }
+    GeneradorTramas generador(configuracion.semilla);
+    size_t n = 0;
+    while (n < configuracion.bytes) {
+        n += generador.generarLinea(configuracion, flujo + n);
+    }
+    *longitud = n;
+    return flujo;
+}
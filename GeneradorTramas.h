@@ -0,0 +1,107 @@
+/**
+ * @file GeneradorTramas.h
+ * @brief Define un generador determinista de flujos PRT-7 sintéticos para las pruebas de rendimiento.
+ */
+
+#ifndef GENERADOR_TRAMAS_H
+#define GENERADOR_TRAMAS_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @enum DistribucionRotacion
+ * @brief Cómo se eligen los valores de las tramas MAP.
+ */
+enum DistribucionRotacion {
+    ROTACION_UNIFORME, /**< @brief Uniforme en [-máximo, máximo]. */
+    ROTACION_PEQUENA,  /**< @brief Magnitud geométrica (1 la mitad de las veces, 2 un cuarto...), hasta el máximo. */
+    ROTACION_EXTREMA   /**< @brief Uniforme en ±1 000 000: obliga a reducir módulo 27. */
+};
+
+/**
+ * @enum FinDeLinea
+ * @brief Terminador de las líneas generadas.
+ */
+enum FinDeLinea {
+    FIN_LF,   /**< @brief `\n` (Linux, capturas grabadas). */
+    FIN_CRLF, /**< @brief `\r\n` (Serial.println del Arduino). */
+    FIN_CR,   /**< @brief `\r` solo. */
+    FIN_MIXTO /**< @brief Uno de los tres al azar en cada línea. */
+};
+
+/**
+ * @struct ConfiguracionGenerador
+ * @brief Parámetros de un flujo sintético.
+ */
+struct ConfiguracionGenerador {
+    uint64_t semilla;          /**< @brief Semilla: la misma configuración produce siempre los mismos bytes. */
+    size_t bytes;              /**< @brief Tamaño aproximado del flujo (se completa la última línea). */
+    double proporcionCargas;   /**< @brief Fracción de tramas LOAD entre las tramas válidas (el resto son MAP). */
+    DistribucionRotacion distribucion; /**< @brief Distribución de las rotaciones. */
+    int rotacionMaxima;        /**< @brief Magnitud máxima de las rotaciones uniformes y pequeñas. */
+    FinDeLinea finDeLinea;     /**< @brief Terminador de línea. */
+    double proporcionRuido;    /**< @brief Fracción de líneas informativas o mal formadas. */
+
+    /**
+     * @brief Constructor con la mezcla típica de una captura: 90 % LOAD, rotaciones de ±13, `\n`.
+     */
+    ConfiguracionGenerador();
+};
+
+/**
+ * @class GeneradorTramas
+ * @brief Genera flujos PRT-7 reproducibles a partir de una semilla.
+ *
+ * Usa su propio xorshift64* en lugar de las distribuciones de `<random>`, cuyo
+ * resultado cambia entre bibliotecas estándar: así un mismo flujo sirve para comparar
+ * corridas en Windows, Linux y macOS.
+ */
+class GeneradorTramas {
+private:
+    uint64_t estado; /**< @brief Estado del xorshift64* (nunca 0). */
+
+public:
+    /**
+     * @brief Constructor de GeneradorTramas.
+     * @param semilla Semilla (0 se reemplaza por una constante).
+     */
+    explicit GeneradorTramas(uint64_t semilla);
+
+    /**
+     * @brief Obtiene el siguiente número pseudoaleatorio de 64 bits.
+     * @return El número.
+     */
+    uint64_t siguiente();
+
+    /**
+     * @brief Obtiene un número en [0, n).
+     * @param n Cota superior (mayor que 0).
+     * @return El número.
+     */
+    uint32_t siguienteMenorQue(uint32_t n);
+
+    /**
+     * @brief Obtiene un número en [0, 1).
+     * @return El número.
+     */
+    double siguienteUniforme();
+
+    /**
+     * @brief Escribe una línea del flujo con su terminador.
+     * @param configuracion Parámetros del flujo.
+     * @param salida Buffer de al menos 32 bytes.
+     * @return Bytes escritos.
+     */
+    size_t generarLinea(const ConfiguracionGenerador& configuracion, char* salida);
+
+    /**
+     * @brief Genera un flujo completo.
+     * @param configuracion Parámetros del flujo (se usa su semilla, no el estado actual).
+     * @param longitud Salida: bytes generados.
+     * @return Buffer con el flujo (liberar con free()), o `nullptr` si no hay memoria.
+     */
+    static char* generar(const ConfiguracionGenerador& configuracion, size_t* longitud);
+};
+
+#endif // GENERADOR_TRAMAS_H
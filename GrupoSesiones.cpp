@@ -0,0 +1,435 @@
+/**
+ * @file GrupoSesiones.cpp
+ * @brief Implementación de SesionDecodificacion y GrupoSesiones.
+ */
+
+#include "GrupoSesiones.h"
+#include "Metricas.h"
+#include <cstdlib>  // Para malloc, realloc, free
+#include <thread>
+
+#ifdef _WIN32
+    #include <windows.h>    // Para Sleep
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #ifdef __linux__
+        #include <sys/epoll.h>
+    #else
+        #include <poll.h>
+    #endif
+#endif
+
+/**
+ * @brief Líneas que un trabajador procesa de una sesión antes de pasar a la siguiente.
+ */
+static const size_t LINEAS_POR_TURNO = 1024;
+
+// ==================== SesionDecodificacion ====================
+
+SesionDecodificacion::SesionDecodificacion(const char* nombre, FuenteTramas* fuente, TipoAlfabeto alfabeto)
+    : nombre(nombre), fuente(fuente), rotor(alfabeto), agrupador(&carga, &rotor), tramas(0), errores(0), terminada(false) {}
+
+SesionDecodificacion::~SesionDecodificacion() {
+    delete fuente;
+}
+
+bool SesionDecodificacion::procesarDisponibles(size_t maximo) {
+    if (terminada) {
+        return false;
+    }
+
+    VistaLinea linea;
+    bool quedanLineas = true;
+    for (size_t i = 0; i < maximo; ++i) {
+        if (!fuente->leerLinea(&linea)) {
+            if (fuente->agotada()) {
+                terminada = true;
+            }
+            quedanLineas = false;
+            break;
+        }
+        marcarInicioTrama();
+        tramas++;
+        if (agrupador.agregar(linea) == LINEA_INVALIDA) {
+            errores++;
+        }
+    }
+    agrupador.vaciar();
+    return quedanLineas;
+}
+
+const char* SesionDecodificacion::getNombre() const {
+    return nombre;
+}
+
+FuenteTramas* SesionDecodificacion::getFuente() const {
+    return fuente;
+}
+
+ListaDeCarga* SesionDecodificacion::getCarga() {
+    return &carga;
+}
+
+unsigned long SesionDecodificacion::getTramas() const {
+    return tramas;
+}
+
+unsigned long SesionDecodificacion::getErrores() const {
+    return errores;
+}
+
+bool SesionDecodificacion::estaTerminada() const {
+    return terminada;
+}
+
+// ==================== TrabajadorSesiones ====================
+
+/**
+ * @class TrabajadorSesiones
+ * @brief Hilo que atiende un subconjunto fijo de sesiones con su propio bucle de eventos.
+ */
+class TrabajadorSesiones {
+private:
+    SesionDecodificacion** sesiones; /**< @brief Sesiones asignadas (no es su dueño). */
+    bool* listas;                    /**< @brief Sesiones que pueden tener datos sin leer. */
+    size_t numSesiones;              /**< @brief Número de sesiones asignadas. */
+    size_t capacidad;                /**< @brief Capacidad de los arreglos. */
+#ifndef _WIN32
+    int despertador[2];              /**< @brief Pipe para interrumpir la espera (lectura, escritura). */
+#endif
+
+#if defined(_WIN32) || !defined(__linux__)
+    /**
+     * @brief Espera a que alguna sesión tenga datos o a que despierten al trabajador.
+     * @param milisegundos Plazo máximo (0 = no esperar, -1 = sin límite).
+     */
+    void esperarEventos(int milisegundos);
+#endif
+
+public:
+    TrabajadorSesiones() : sesiones(nullptr), listas(nullptr), numSesiones(0), capacidad(0) {
+#ifndef _WIN32
+        despertador[0] = -1;
+        despertador[1] = -1;
+#endif
+    }
+
+    ~TrabajadorSesiones() {
+        free(sesiones);
+        free(listas);
+#ifndef _WIN32
+        for (int i = 0; i < 2; ++i) {
+            if (despertador[i] != -1) {
+                ::close(despertador[i]);
+            }
+        }
+#endif
+    }
+
+    /**
+     * @brief Asigna una sesión a este trabajador.
+     * @return `false` si no hubo memoria.
+     */
+    bool asignar(SesionDecodificacion* sesion) {
+        if (numSesiones == capacidad) {
+            size_t nueva = capacidad == 0 ? 8 : capacidad * 2;
+            SesionDecodificacion** s = (SesionDecodificacion**)realloc(sesiones, nueva * sizeof(*s));
+            if (s == nullptr) {
+                return false;
+            }
+            sesiones = s;
+            bool* l = (bool*)realloc(listas, nueva * sizeof(*l));
+            if (l == nullptr) {
+                return false;
+            }
+            listas = l;
+            capacidad = nueva;
+        }
+        sesiones[numSesiones] = sesion;
+        listas[numSesiones] = true; // Al inicio se intenta leer de todas
+        numSesiones++;
+        return true;
+    }
+
+    /**
+     * @brief Crea el pipe de despertar. Llamar antes de lanzar el hilo.
+     */
+    void preparar() {
+#ifndef _WIN32
+        if (pipe(despertador) == 0) {
+            for (int i = 0; i < 2; ++i) {
+                fcntl(despertador[i], F_SETFL, fcntl(despertador[i], F_GETFL) | O_NONBLOCK);
+                fcntl(despertador[i], F_SETFD, FD_CLOEXEC);
+            }
+        } else {
+            despertador[0] = -1;
+            despertador[1] = -1;
+        }
+#endif
+    }
+
+    /**
+     * @brief Interrumpe la espera del trabajador. Segura en un manejador de señales.
+     */
+    void despertar() {
+#ifndef _WIN32
+        int escritura = despertador[1];
+        if (escritura != -1) {
+            char aviso = 1;
+            ssize_t escritos = write(escritura, &aviso, 1);
+            (void)escritos;
+        }
+#endif
+    }
+
+    /**
+     * @brief Bucle del trabajador: atiende sus sesiones hasta que terminan o se pide detener.
+     */
+    void ejecutar(volatile sig_atomic_t* detener);
+};
+
+#if !defined(_WIN32) && defined(__linux__)
+
+void TrabajadorSesiones::ejecutar(volatile sig_atomic_t* detener) {
+    int epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (epfd == -1) {
+        return;
+    }
+
+    // data.u64 = índice de la sesión; numSesiones identifica al pipe de despertar
+    struct epoll_event evento;
+    if (despertador[0] != -1) {
+        evento.events = EPOLLIN;
+        evento.data.u64 = numSesiones;
+        epoll_ctl(epfd, EPOLL_CTL_ADD, despertador[0], &evento);
+    }
+    for (size_t i = 0; i < numSesiones; ++i) {
+        int fd = sesiones[i]->getFuente()->descriptor();
+        if (fd != -1) {
+            evento.events = EPOLLIN;
+            evento.data.u64 = i;
+            epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &evento);
+        }
+    }
+
+    size_t activas = numSesiones;
+    struct epoll_event eventos[64];
+    while (activas > 0 && (detener == nullptr || !*detener)) {
+        // Atender por turnos a las sesiones que pueden tener datos
+        bool quedanListas = false;
+        for (size_t i = 0; i < numSesiones; ++i) {
+            if (!listas[i]) {
+                continue;
+            }
+            SesionDecodificacion* sesion = sesiones[i];
+            int fd = sesion->getFuente()->descriptor();
+            bool quedan = sesion->procesarDisponibles(LINEAS_POR_TURNO);
+            if (sesion->estaTerminada()) {
+                if (fd != -1 && sesion->getFuente()->descriptor() == fd) {
+                    epoll_ctl(epfd, EPOLL_CTL_DEL, fd, &evento); // Si se cerró, epoll ya lo quitó
+                }
+                listas[i] = false;
+                activas--;
+                continue;
+            }
+            // Sin descriptor (archivo) la sesión siempre está lista
+            listas[i] = quedan || fd == -1;
+            quedanListas = quedanListas || listas[i];
+        }
+        if (activas == 0) {
+            break;
+        }
+
+        int n = epoll_wait(epfd, eventos, 64, quedanListas ? 0 : -1);
+        for (int e = 0; e < n; ++e) {
+            size_t indice = (size_t)eventos[e].data.u64;
+            if (indice == numSesiones) {
+                char basura[64];
+                while (read(despertador[0], basura, sizeof(basura)) > 0) {
+                }
+            } else if (indice < numSesiones && !sesiones[indice]->estaTerminada()) {
+                if (eventos[e].events & (EPOLLHUP | EPOLLERR)) {
+                    // Que la fuente registre el cuelgue para cerrarse al agotar sus datos
+                    sesiones[indice]->getFuente()->esperarDatos(0);
+                }
+                listas[indice] = true;
+            }
+        }
+    }
+    ::close(epfd);
+}
+
+#elif !defined(_WIN32)
+
+void TrabajadorSesiones::esperarEventos(int milisegundos) {
+    // poll() para los sistemas sin epoll (macOS, BSD)
+    struct pollfd* fds = (struct pollfd*)malloc((numSesiones + 1) * sizeof(struct pollfd));
+    size_t* indices = (size_t*)malloc((numSesiones + 1) * sizeof(size_t));
+    if (fds == nullptr || indices == nullptr) {
+        free(fds);
+        free(indices);
+        return;
+    }
+    nfds_t n = 0;
+    if (despertador[0] != -1) {
+        fds[n].fd = despertador[0];
+        fds[n].events = POLLIN;
+        indices[n++] = numSesiones;
+    }
+    for (size_t i = 0; i < numSesiones; ++i) {
+        int fd = sesiones[i]->getFuente()->descriptor();
+        if (fd != -1 && !sesiones[i]->estaTerminada()) {
+            fds[n].fd = fd;
+            fds[n].events = POLLIN;
+            indices[n++] = i;
+        }
+    }
+    if (poll(fds, n, milisegundos) > 0) {
+        for (nfds_t k = 0; k < n; ++k) {
+            if (fds[k].revents == 0) {
+                continue;
+            }
+            if (indices[k] == numSesiones) {
+                char basura[64];
+                while (read(despertador[0], basura, sizeof(basura)) > 0) {
+                }
+            } else {
+                if (fds[k].revents & (POLLHUP | POLLERR)) {
+                    sesiones[indices[k]]->getFuente()->esperarDatos(0);
+                }
+                listas[indices[k]] = true;
+            }
+        }
+    }
+    free(fds);
+    free(indices);
+}
+
+#else
+
+void TrabajadorSesiones::esperarEventos(int milisegundos) {
+    // Windows: los puertos no ofrecen descriptor; se vuelve a intentar tras una pausa
+    if (milisegundos != 0) {
+        Sleep(1);
+    }
+    for (size_t i = 0; i < numSesiones; ++i) {
+        listas[i] = !sesiones[i]->estaTerminada();
+    }
+}
+
+#endif
+
+#if defined(_WIN32) || !defined(__linux__)
+
+void TrabajadorSesiones::ejecutar(volatile sig_atomic_t* detener) {
+    size_t activas = numSesiones;
+    while (activas > 0 && (detener == nullptr || !*detener)) {
+        bool quedanListas = false;
+        for (size_t i = 0; i < numSesiones; ++i) {
+            if (!listas[i]) {
+                continue;
+            }
+            SesionDecodificacion* sesion = sesiones[i];
+            bool quedan = sesion->procesarDisponibles(LINEAS_POR_TURNO);
+            if (sesion->estaTerminada()) {
+                listas[i] = false;
+                activas--;
+                continue;
+            }
+            listas[i] = quedan || sesion->getFuente()->descriptor() == -1;
+            quedanListas = quedanListas || listas[i];
+        }
+        if (activas > 0) {
+            esperarEventos(quedanListas ? 0 : -1);
+        }
+    }
+}
+
+#endif
+
+// ==================== GrupoSesiones ====================
+
+GrupoSesiones::GrupoSesiones(int numTrabajadores)
+    : sesiones(nullptr), numSesiones(0), capacidadSesiones(0), trabajadores(nullptr),
+      numTrabajadores(numTrabajadores) {
+    if (this->numTrabajadores <= 0) {
+        this->numTrabajadores = (int)std::thread::hardware_concurrency();
+        if (this->numTrabajadores <= 0) {
+            this->numTrabajadores = 1;
+        }
+    }
+}
+
+GrupoSesiones::~GrupoSesiones() {
+    delete[] trabajadores;
+    for (size_t i = 0; i < numSesiones; ++i) {
+        delete sesiones[i];
+    }
+    free(sesiones);
+}
+
+void GrupoSesiones::agregar(SesionDecodificacion* sesion) {
+    if (numSesiones == capacidadSesiones) {
+        size_t nueva = capacidadSesiones == 0 ? 8 : capacidadSesiones * 2;
+        SesionDecodificacion** s = (SesionDecodificacion**)realloc(sesiones, nueva * sizeof(*s));
+        if (s == nullptr) {
+            delete sesion;
+            return;
+        }
+        sesiones = s;
+        capacidadSesiones = nueva;
+    }
+    sesiones[numSesiones++] = sesion;
+}
+
+void GrupoSesiones::ejecutar(volatile sig_atomic_t* detener) {
+    if (numSesiones == 0) {
+        return;
+    }
+    if ((size_t)numTrabajadores > numSesiones) {
+        numTrabajadores = (int)numSesiones; // Un trabajador sin sesiones no tendría nada que hacer
+    }
+
+    TrabajadorSesiones* nuevos = new TrabajadorSesiones[numTrabajadores];
+    for (size_t i = 0; i < numSesiones; ++i) {
+        nuevos[i % (size_t)numTrabajadores].asignar(sesiones[i]);
+    }
+    for (int t = 0; t < numTrabajadores; ++t) {
+        nuevos[t].preparar();
+    }
+    trabajadores = nuevos; // A partir de aquí despertar() puede alcanzarlos
+
+    // El último trabajador usa el hilo actual
+    std::thread* hilos = new std::thread[numTrabajadores];
+    for (int t = 0; t + 1 < numTrabajadores; ++t) {
+        hilos[t] = std::thread(&TrabajadorSesiones::ejecutar, &trabajadores[t], detener);
+    }
+    trabajadores[numTrabajadores - 1].ejecutar(detener);
+    for (int t = 0; t + 1 < numTrabajadores; ++t) {
+        hilos[t].join();
+    }
+    delete[] hilos;
+}
+
+void GrupoSesiones::despertar() {
+    TrabajadorSesiones* actuales = trabajadores;
+    if (actuales == nullptr) {
+        return;
+    }
+    for (int t = 0; t < numTrabajadores; ++t) {
+        actuales[t].despertar();
+    }
+}
+
+size_t GrupoSesiones::getNumSesiones() const {
+    return numSesiones;
+}
+
+SesionDecodificacion* GrupoSesiones::getSesion(size_t indice) const {
+    return sesiones[indice];
+}
+
+int GrupoSesiones::getNumTrabajadores() const {
+    return numTrabajadores;
+}
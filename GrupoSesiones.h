@@ -0,0 +1,170 @@
+/**
+ * @file GrupoSesiones.h
+ * @brief Define las sesiones de decodificación independientes y el grupo de hilos que las atiende.
+ */
+
+#ifndef GRUPO_SESIONES_H
+#define GRUPO_SESIONES_H
+
+#include <csignal>
+#include <cstddef>
+#include "AgrupadorTramas.h"
+#include "FuenteTramas.h"
+#include "ListaDeCarga.h"
+#include "RotorDeMapeo.h"
+
+/**
+ * @class SesionDecodificacion
+ * @brief Una fuente de tramas con su propio rotor y su propio mensaje.
+ *
+ * Cada sesión pertenece a un único hilo trabajador, por lo que nada de lo que
+ * modifica al decodificar (rotor, lista, contadores) se comparte con otra sesión.
+ * Se alinea a la línea de caché para que sesiones vecinas no compartan líneas.
+ */
+class alignas(64) SesionDecodificacion {
+private:
+    const char* nombre;          /**< @brief Nombre para mostrar (ruta del puerto o archivo). */
+    FuenteTramas* fuente;        /**< @brief Origen de las líneas (la sesión es su dueña). */
+    RotorDeMapeo rotor;          /**< @brief Rotor propio de la sesión. */
+    ListaDeCarga carga;          /**< @brief Mensaje propio de la sesión. */
+    AgrupadorTramas agrupador;   /**< @brief Decodifica por rachas las tramas de la sesión. */
+    unsigned long tramas;        /**< @brief Líneas procesadas. */
+    unsigned long errores;       /**< @brief Tramas mal formadas. */
+    bool terminada;              /**< @brief La fuente se agotó o se desconectó. */
+
+public:
+    /**
+     * @brief Constructor de SesionDecodificacion.
+     * @param nombre Nombre para mostrar; debe seguir vigente mientras exista la sesión.
+     * @param fuente Fuente ya abierta, creada con `new`; la sesión la libera.
+     * @param alfabeto Alfabeto del rotor de la sesión.
+     */
+    SesionDecodificacion(const char* nombre, FuenteTramas* fuente, TipoAlfabeto alfabeto = ALFABETO_LATINO);
+
+    /**
+     * @brief Destructor de SesionDecodificacion. Libera la fuente.
+     */
+    ~SesionDecodificacion();
+
+    SesionDecodificacion(const SesionDecodificacion&) = delete;
+    SesionDecodificacion& operator=(const SesionDecodificacion&) = delete;
+
+    /**
+     * @brief Procesa las líneas que la fuente tenga disponibles, sin esperar.
+     * @details Las tramas se decodifican por rachas (ver AgrupadorTramas); al regresar,
+     *          el mensaje ya incluye todas las líneas procesadas.
+     * @param maximo Máximo de líneas a procesar, para repartir el hilo entre sesiones.
+     * @return `true` si se alcanzó el máximo (pueden quedar líneas), `false` si la fuente
+     *         ya no tenía datos o terminó.
+     */
+    bool procesarDisponibles(size_t maximo);
+
+    /**
+     * @brief Obtiene el nombre de la sesión.
+     * @return Nombre para mostrar.
+     */
+    const char* getNombre() const;
+
+    /**
+     * @brief Obtiene la fuente de la sesión.
+     * @return La fuente de tramas.
+     */
+    FuenteTramas* getFuente() const;
+
+    /**
+     * @brief Obtiene el mensaje ensamblado por la sesión.
+     * @return La lista de carga de la sesión.
+     */
+    ListaDeCarga* getCarga();
+
+    /**
+     * @brief Obtiene el número de líneas procesadas.
+     * @return Líneas procesadas.
+     */
+    unsigned long getTramas() const;
+
+    /**
+     * @brief Obtiene el número de tramas mal formadas.
+     * @return Tramas con error de parseo.
+     */
+    unsigned long getErrores() const;
+
+    /**
+     * @brief Indica si la fuente se agotó o se desconectó.
+     * @return `true` si la sesión terminó.
+     */
+    bool estaTerminada() const;
+};
+
+class TrabajadorSesiones;
+
+/**
+ * @class GrupoSesiones
+ * @brief Reparte muchas sesiones entre un número fijo de hilos trabajadores.
+ *
+ * La sesión i se asigna al trabajador `i % numTrabajadores`. Cada trabajador
+ * vigila los descriptores de sus sesiones con su propio bucle epoll (poll() fuera
+ * de Linux) y un pipe de despertar, y atiende por turnos a las que tienen datos.
+ */
+class GrupoSesiones {
+private:
+    SesionDecodificacion** sesiones;   /**< @brief Sesiones agregadas (el grupo es su dueño). */
+    size_t numSesiones;                /**< @brief Número de sesiones. */
+    size_t capacidadSesiones;          /**< @brief Capacidad del arreglo `sesiones`. */
+    TrabajadorSesiones* trabajadores;  /**< @brief Trabajadores, creados en ejecutar(). */
+    int numTrabajadores;               /**< @brief Número de hilos trabajadores. */
+
+public:
+    /**
+     * @brief Constructor de GrupoSesiones.
+     * @param numTrabajadores Número de hilos (0 = uno por núcleo).
+     */
+    explicit GrupoSesiones(int numTrabajadores = 0);
+
+    /**
+     * @brief Destructor de GrupoSesiones. Libera las sesiones y los trabajadores.
+     */
+    ~GrupoSesiones();
+
+    GrupoSesiones(const GrupoSesiones&) = delete;
+    GrupoSesiones& operator=(const GrupoSesiones&) = delete;
+
+    /**
+     * @brief Agrega una sesión al grupo, que pasa a ser su dueño.
+     * @param sesion Sesión creada con `new`.
+     */
+    void agregar(SesionDecodificacion* sesion);
+
+    /**
+     * @brief Atiende todas las sesiones hasta que terminan o se pide detener.
+     * @param detener Bandera que, al ponerse en 1, detiene a los trabajadores (o `nullptr`).
+     */
+    void ejecutar(volatile sig_atomic_t* detener);
+
+    /**
+     * @brief Despierta a todos los trabajadores para que revisen la bandera de detención.
+     * @details Solo llama a `write()`, por lo que es segura en un manejador de señales.
+     */
+    void despertar();
+
+    /**
+     * @brief Obtiene el número de sesiones.
+     * @return Sesiones agregadas.
+     */
+    size_t getNumSesiones() const;
+
+    /**
+     * @brief Obtiene una sesión.
+     * @param indice Índice de la sesión (0..getNumSesiones()-1).
+     * @return La sesión.
+     */
+    SesionDecodificacion* getSesion(size_t indice) const;
+
+    /**
+     * @brief Obtiene el número de hilos trabajadores.
+     * @return Número de trabajadores (nunca más que sesiones al ejecutar).
+     */
+    int getNumTrabajadores() const;
+};
+
+#endif // GRUPO_SESIONES_H
@@ -0,0 +1,205 @@
+/**
+ * @file IndiceCaptura.cpp
+ * @brief Implementación del índice disperso de capturas.
+ */
+
+#include "IndiceCaptura.h"
+#include "DivisorTramas.h"
+#include "ParserTramas.h"
+#include <cstdio>
+#include <cstring>  // Para memcmp, memcpy
+#include <iostream>
+
+/**
+ * @brief Identificador al inicio de todo archivo de índice.
+ */
+static const char FIRMA_INDICE[8] = {'P', 'R', 'T', '7', '-', 'I', 'D', 'X'};
+
+/**
+ * @brief Versión del formato del índice.
+ */
+static const uint32_t VERSION_INDICE = 1;
+
+/**
+ * @brief Tamaño del encabezado del índice.
+ */
+static const size_t TAMANO_ENCABEZADO = 40;
+
+/**
+ * @brief Tamaño de un registro de punto.
+ */
+static const size_t TAMANO_PUNTO = 17;
+
+/**
+ * @brief Escribe un entero en little-endian.
+ */
+static void escribirEntero(unsigned char* destino, uint64_t valor, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        destino[i] = (unsigned char)(valor >> (8 * i));
+    }
+}
+
+/**
+ * @brief Lee un entero en little-endian.
+ */
+static uint64_t leerEntero(const unsigned char* origen, int bytes) {
+    uint64_t valor = 0;
+    for (int i = 0; i < bytes; ++i) {
+        valor |= (uint64_t)origen[i] << (8 * i);
+    }
+    return valor;
+}
+
+IndiceCaptura::IndiceCaptura()
+    : puntos(nullptr), numPuntos(0), totalCaracteres(0), longitudCaptura(0) {}
+
+bool IndiceCaptura::construir(const char* datos, size_t longitud, const char* rutaIndice,
+                              uint64_t* caracteres, uint64_t* puntosEscritos) {
+    FILE* archivo = fopen(rutaIndice, "wb");
+    if (archivo == nullptr) {
+        std::cerr << "Error: No se pudo crear el índice " << rutaIndice << std::endl;
+        return false;
+    }
+    // El encabezado se completa al final, cuando se conocen los totales
+    unsigned char encabezado[TAMANO_ENCABEZADO] = {0};
+    bool correcto = fwrite(encabezado, 1, TAMANO_ENCABEZADO, archivo) == TAMANO_ENCABEZADO;
+
+    DivisorTramas divisor(datos, longitud);
+    VistaLinea linea;
+    uint64_t cargas = 0;
+    uint64_t numPuntos = 0;
+    uint32_t lineasHastaPunto = 0;
+    int desplazamiento = 0;
+    const char* inicioLinea = datos;
+    while (correcto) {
+        if (lineasHastaPunto == 0) {
+            unsigned char punto[TAMANO_PUNTO];
+            escribirEntero(punto, (uint64_t)(inicioLinea - datos), 8);
+            escribirEntero(punto + 8, cargas, 8);
+            punto[16] = (unsigned char)desplazamiento;
+            correcto = fwrite(punto, 1, TAMANO_PUNTO, archivo) == TAMANO_PUNTO;
+            numPuntos++;
+            lineasHastaPunto = INTERVALO_INDICE;
+        }
+        if (!divisor.siguiente(&linea)) {
+            break;
+        }
+        char dato;
+        int rotacion;
+        TipoLinea tipo = clasificarLinea(linea.datos, linea.longitud, &dato, &rotacion);
+        if (tipo == LINEA_CARGA) {
+            cargas++;
+        } else if (tipo == LINEA_MAPA) {
+            desplazamiento = (desplazamiento + rotacion % RotorDeMapeo::TAMANO_ALFABETO + RotorDeMapeo::TAMANO_ALFABETO) %
+                             RotorDeMapeo::TAMANO_ALFABETO;
+        }
+        inicioLinea = divisor.getPosicion();
+        lineasHastaPunto--;
+    }
+
+    memcpy(encabezado, FIRMA_INDICE, sizeof(FIRMA_INDICE));
+    escribirEntero(encabezado + 8, VERSION_INDICE, 4);
+    escribirEntero(encabezado + 12, INTERVALO_INDICE, 4);
+    escribirEntero(encabezado + 16, (uint64_t)longitud, 8);
+    escribirEntero(encabezado + 24, cargas, 8);
+    escribirEntero(encabezado + 32, numPuntos, 8);
+    correcto = correcto && fseek(archivo, 0, SEEK_SET) == 0 &&
+               fwrite(encabezado, 1, TAMANO_ENCABEZADO, archivo) == TAMANO_ENCABEZADO;
+    correcto = fclose(archivo) == 0 && correcto;
+    if (!correcto) {
+        std::cerr << "Error: No se pudo escribir el índice " << rutaIndice << std::endl;
+        return false;
+    }
+    if (caracteres != nullptr) {
+        *caracteres = cargas;
+    }
+    if (puntosEscritos != nullptr) {
+        *puntosEscritos = numPuntos;
+    }
+    return true;
+}
+
+bool IndiceCaptura::abrir(const char* rutaIndice, size_t longitudCaptura) {
+    if (!archivo.abrir(rutaIndice)) {
+        return false;
+    }
+    const unsigned char* encabezado = (const unsigned char*)archivo.getDatos();
+    if (archivo.getLongitud() < TAMANO_ENCABEZADO || memcmp(encabezado, FIRMA_INDICE, sizeof(FIRMA_INDICE)) != 0 ||
+        leerEntero(encabezado + 8, 4) != VERSION_INDICE) {
+        std::cerr << "Error: " << rutaIndice << " no es un índice PRT-7." << std::endl;
+        archivo.cerrar();
+        return false;
+    }
+    this->longitudCaptura = leerEntero(encabezado + 16, 8);
+    totalCaracteres = leerEntero(encabezado + 24, 8);
+    numPuntos = leerEntero(encabezado + 32, 8);
+    puntos = encabezado + TAMANO_ENCABEZADO;
+    if (numPuntos == 0 || (archivo.getLongitud() - TAMANO_ENCABEZADO) / TAMANO_PUNTO < numPuntos) {
+        std::cerr << "Error: El índice " << rutaIndice << " está incompleto." << std::endl;
+        archivo.cerrar();
+        return false;
+    }
+    if (this->longitudCaptura != (uint64_t)longitudCaptura) {
+        std::cerr << "Error: El índice " << rutaIndice << " corresponde a una captura de " << this->longitudCaptura
+                  << " bytes; vuelva a generarlo con --indexar." << std::endl;
+        archivo.cerrar();
+        return false;
+    }
+    return true;
+}
+
+uint64_t IndiceCaptura::buscarPunto(uint64_t caracter) const {
+    // El punto 0 (cero cargas) siempre cumple; buscar el último que cumpla
+    uint64_t bajo = 0;
+    uint64_t alto = numPuntos;
+    while (alto - bajo > 1) {
+        uint64_t medio = bajo + (alto - bajo) / 2;
+        if (leerEntero(puntos + medio * TAMANO_PUNTO + 8, 8) <= caracter) {
+            bajo = medio;
+        } else {
+            alto = medio;
+        }
+    }
+    return bajo;
+}
+
+size_t IndiceCaptura::consultar(const char* datos, uint64_t desde, uint64_t hasta, char* salida) const {
+    if (hasta > totalCaracteres) {
+        hasta = totalCaracteres;
+    }
+    if (puntos == nullptr || desde >= hasta) {
+        return 0;
+    }
+
+    const unsigned char* punto = puntos + buscarPunto(desde) * TAMANO_PUNTO;
+    uint64_t inicio = leerEntero(punto, 8);
+    uint64_t cargas = leerEntero(punto + 8, 8);
+    int desplazamiento = punto[16];
+
+    DivisorTramas divisor(datos + inicio, (size_t)(longitudCaptura - inicio));
+    VistaLinea linea;
+    size_t escritos = 0;
+    while (cargas < hasta && divisor.siguiente(&linea)) {
+        char dato;
+        int rotacion;
+        TipoLinea tipo = clasificarLinea(linea.datos, linea.longitud, &dato, &rotacion);
+        if (tipo == LINEA_CARGA) {
+            if (cargas >= desde) {
+                salida[escritos++] = rotor.mapearConDesplazamiento(dato, desplazamiento);
+            }
+            cargas++;
+        } else if (tipo == LINEA_MAPA) {
+            desplazamiento = (desplazamiento + rotacion % RotorDeMapeo::TAMANO_ALFABETO + RotorDeMapeo::TAMANO_ALFABETO) %
+                             RotorDeMapeo::TAMANO_ALFABETO;
+        }
+    }
+    return escritos;
+}
+
+uint64_t IndiceCaptura::getTotalCaracteres() const {
+    return totalCaracteres;
+}
+
+uint64_t IndiceCaptura::getNumPuntos() const {
+    return numPuntos;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file IndiceCaptura.h
+ * @brief Define el índice disperso que permite decodificar un rango del mensaje sin recorrer toda la captura.
+ */
+
+#ifndef INDICE_CAPTURA_H
+#define INDICE_CAPTURA_H
+
+#include <cstddef>
+#include <cstdint>
+#include "ArchivoMapeado.h"
+#include "RotorDeMapeo.h"
+
+/**
+ * @brief Líneas de la captura entre dos puntos del índice.
+ *
+ * Una consulta recorre como mucho esta cantidad de líneas antes de llegar al
+ * primer carácter pedido; con 4096, el índice ocupa unos 17 bytes cada ~20 KB de captura.
+ */
+const uint32_t INTERVALO_INDICE = 4096;
+
+/**
+ * @class IndiceCaptura
+ * @brief Suma de prefijos dispersa (rotación y cantidad de LOAD) de una captura grabada.
+ *
+ * El carácter que produce una trama LOAD depende solo de cuántas rotaciones MAP la
+ * precedieron (módulo 27), igual que en DecodificadorLote. Cada INTERVALO_INDICE
+ * líneas el índice guarda el byte donde empieza la línea, cuántas LOAD hubo antes y la
+ * rotación acumulada. Para decodificar los caracteres [desde, hasta) basta con buscar
+ * (binariamente) el último punto con a lo sumo `desde` cargas y decodificar desde allí:
+ * el costo no depende de la posición del rango dentro de la captura.
+ *
+ * El índice se guarda junto a la captura (`<captura>.idx`) con este formato, en
+ * little-endian:
+ * - Encabezado de 40 bytes: `PRT7-IDX`, versión (u32), intervalo (u32), longitud de
+ *   la captura (u64), caracteres del mensaje (u64) y cantidad de puntos (u64).
+ * - Un registro de 17 bytes por punto: byte de inicio (u64), cargas previas (u64)
+ *   y rotación acumulada (u8, 0..26).
+ *
+ * Se consulta proyectado en memoria, por lo que abrirlo no lo lee completo. Supone
+ * que el rotor empieza sin rotación, como al arrancar el decodificador.
+ */
+class IndiceCaptura {
+private:
+    ArchivoMapeado archivo;         /**< @brief Archivo del índice proyectado en memoria. */
+    const unsigned char* puntos;    /**< @brief Primer registro de punto dentro de `archivo`. */
+    uint64_t numPuntos;             /**< @brief Cantidad de puntos. */
+    uint64_t totalCaracteres;       /**< @brief Caracteres del mensaje completo (tramas LOAD). */
+    uint64_t longitudCaptura;       /**< @brief Tamaño de la captura indexada. */
+    RotorDeMapeo rotor;             /**< @brief Rotor sin estado usado con mapearConDesplazamiento(). */
+
+    /**
+     * @brief Busca el último punto desde el que se puede empezar a decodificar un carácter.
+     * @param caracter Posición del carácter en el mensaje.
+     * @return Índice del último punto con a lo sumo `caracter` cargas previas.
+     */
+    uint64_t buscarPunto(uint64_t caracter) const;
+
+public:
+    /**
+     * @brief Constructor de IndiceCaptura. No abre ningún índice.
+     */
+    IndiceCaptura();
+
+    /**
+     * @brief Recorre una captura y escribe su índice.
+     * @param datos Inicio de la captura.
+     * @param longitud Tamaño de la captura en bytes.
+     * @param rutaIndice Archivo de salida.
+     * @param caracteres Salida opcional: caracteres del mensaje completo.
+     * @param puntosEscritos Salida opcional: puntos del índice.
+     * @return `true` si el índice se escribió completo.
+     */
+    static bool construir(const char* datos, size_t longitud, const char* rutaIndice,
+                          uint64_t* caracteres = nullptr, uint64_t* puntosEscritos = nullptr);
+
+    /**
+     * @brief Abre un índice y comprueba que corresponda a la captura.
+     * @param rutaIndice Archivo del índice.
+     * @param longitudCaptura Tamaño de la captura que se va a consultar.
+     * @return `true` si el índice es válido para esa captura.
+     */
+    bool abrir(const char* rutaIndice, size_t longitudCaptura);
+
+    /**
+     * @brief Decodifica los caracteres [desde, hasta) del mensaje.
+     * @param datos Inicio de la captura (la misma que se indexó).
+     * @param desde Primer carácter (desde 0).
+     * @param hasta Carácter siguiente al último; se limita al total del mensaje.
+     * @param salida Buffer de al menos `hasta - desde` bytes.
+     * @return Caracteres escritos en `salida`.
+     */
+    size_t consultar(const char* datos, uint64_t desde, uint64_t hasta, char* salida) const;
+
+    /**
+     * @brief Obtiene la cantidad de caracteres del mensaje completo.
+     * @return Tramas LOAD de la captura.
+     */
+    uint64_t getTotalCaracteres() const;
+
+    /**
+     * @brief Obtiene la cantidad de puntos del índice.
+     * @return Puntos guardados.
+     */
+    uint64_t getNumPuntos() const;
+};
+
+#endif // INDICE_CAPTURA_H
@@ -5,22 +5,67 @@
 
 #include "ListaDeCarga.h"
 #include <iostream> // Necesario para std::cout
+#include <cstdlib>  // Para malloc, free
+#include <cstring>  // Para memcpy
+#include <new>      // Para placement new
 
-ListaDeCarga::ListaDeCarga() : head(nullptr), tail(nullptr) {}
+/**
+ * @brief Capacidad (en nodos) del primer bloque; cada bloque nuevo duplica la anterior.
+ */
+static const size_t CAPACIDAD_BLOQUE_INICIAL = 4;
+
+/**
+ * @brief Capacidad máxima (en nodos) de un bloque (4096 nodos = 256 KB de caracteres).
+ */
+static const size_t CAPACIDAD_BLOQUE_MAXIMA = 4096;
+
+ListaDeCarga::ListaDeCarga() : head(nullptr), tail(nullptr), bloqueActual(nullptr), longitud(0) {}
 
 ListaDeCarga::~ListaDeCarga() {
-    NodoDoble* current = head;
-    while (current != nullptr) {
-        NodoDoble* next = current->siguiente;
-        delete current;
-        current = next;
+    // NodoDoble no tiene destructor propio: basta con liberar los bloques
+    BloqueNodos* bloque = bloqueActual;
+    while (bloque != nullptr) {
+        BloqueNodos* anterior = bloque->anterior;
+        free(bloque);
+        bloque = anterior;
     }
+    bloqueActual = nullptr;
     head = nullptr;
     tail = nullptr;
+    longitud = 0;
+    cursorNuevos = CursorCarga();
 }
 
-void ListaDeCarga::insertarAlFinal(char dato) {
-    NodoDoble* nuevoNodo = new NodoDoble(dato);
+NodoDoble* ListaDeCarga::crearNodo() {
+    if (bloqueActual == nullptr || bloqueActual->usados == bloqueActual->capacidad) {
+        size_t capacidad = CAPACIDAD_BLOQUE_INICIAL;
+        if (bloqueActual != nullptr) {
+            capacidad = bloqueActual->capacidad * 2;
+            if (capacidad > CAPACIDAD_BLOQUE_MAXIMA) {
+                capacidad = CAPACIDAD_BLOQUE_MAXIMA;
+            }
+        }
+
+        // Cabecera y nodos en una sola asignación
+        BloqueNodos* bloque = (BloqueNodos*)malloc(sizeof(BloqueNodos) + capacidad * sizeof(NodoDoble));
+        if (bloque == nullptr) {
+            return nullptr;
+        }
+        bloque->anterior = bloqueActual;
+        bloque->usados = 0;
+        bloque->capacidad = capacidad;
+        bloque->nodos = (NodoDoble*)(bloque + 1);
+        bloqueActual = bloque;
+    }
+
+    return new (&bloqueActual->nodos[bloqueActual->usados++]) NodoDoble();
+}
+
+bool ListaDeCarga::agregarNodo() {
+    NodoDoble* nuevoNodo = crearNodo();
+    if (nuevoNodo == nullptr) {
+        return false;
+    }
     if (head == nullptr) {
         head = nuevoNodo;
         tail = nuevoNodo;
@@ -29,12 +74,112 @@ void ListaDeCarga::insertarAlFinal(char dato) {
         nuevoNodo->previo = tail;
         tail = nuevoNodo;
     }
+    return true;
+}
+
+void ListaDeCarga::insertarAlFinal(char dato) {
+    if (tail == nullptr || tail->cantidad == NodoDoble::CAPACIDAD) {
+        if (!agregarNodo()) {
+            return; // Sin memoria: se descarta el carácter
+        }
+    }
+    tail->datos[tail->cantidad++] = dato;
+    longitud++;
+}
+
+void ListaDeCarga::insertarBloque(const char* datos, size_t cantidad) {
+    while (cantidad > 0) {
+        if (tail == nullptr || tail->cantidad == NodoDoble::CAPACIDAD) {
+            if (!agregarNodo()) {
+                return; // Sin memoria: se descarta el resto del bloque
+            }
+        }
+        size_t libres = NodoDoble::CAPACIDAD - tail->cantidad;
+        size_t copiar = cantidad < libres ? cantidad : libres;
+        memcpy(tail->datos + tail->cantidad, datos, copiar);
+        tail->cantidad += copiar;
+        longitud += copiar;
+        datos += copiar;
+        cantidad -= copiar;
+    }
+}
+
+void ListaDeCarga::recorrerBloques(VisitanteBloque visitar, void* contexto) const {
+    NodoDoble* current = head;
+    while (current != nullptr) {
+        if (current->cantidad > 0) {
+            visitar(current->datos, current->cantidad, contexto);
+        }
+        current = current->siguiente;
+    }
+}
+
+size_t ListaDeCarga::recorrerNuevos(VisitanteBloque visitar, void* contexto) {
+    if (cursorNuevos.entregados == longitud) {
+        return 0; // Nada nuevo desde la última llamada
+    }
+
+    const NodoDoble* current = (cursorNuevos.nodo != nullptr) ? cursorNuevos.nodo : head;
+    size_t inicio = (cursorNuevos.nodo != nullptr) ? cursorNuevos.posicion : 0;
+    size_t visitados = 0;
+    while (current != nullptr) {
+        if (current->cantidad > inicio) {
+            visitar(current->datos + inicio, current->cantidad - inicio, contexto);
+            visitados += current->cantidad - inicio;
+        }
+        cursorNuevos.nodo = current;
+        cursorNuevos.posicion = current->cantidad;
+        current = current->siguiente;
+        inicio = 0;
+    }
+    cursorNuevos.entregados += visitados;
+    return visitados;
+}
+
+size_t ListaDeCarga::getLongitudNuevos() const {
+    return longitud - cursorNuevos.entregados;
+}
+
+size_t ListaDeCarga::copiarNuevos(CursorCarga* cursor, char* destino, size_t maximo) const {
+    const NodoDoble* current = (cursor->nodo != nullptr) ? cursor->nodo : head;
+    size_t inicio = (cursor->nodo != nullptr) ? cursor->posicion : 0;
+    size_t copiados = 0;
+    while (current != nullptr && copiados < maximo) {
+        size_t disponibles = current->cantidad - inicio;
+        size_t copiar = disponibles < maximo - copiados ? disponibles : maximo - copiados;
+        memcpy(destino + copiados, current->datos + inicio, copiar);
+        copiados += copiar;
+        cursor->nodo = current;
+        cursor->posicion = inicio + copiar;
+        if (cursor->posicion < current->cantidad || current->siguiente == nullptr) {
+            break; // Destino lleno, o se alcanzó el final del mensaje
+        }
+        current = current->siguiente;
+        inicio = 0;
+    }
+    cursor->entregados += copiados;
+    return copiados;
+}
+
+/**
+ * @brief Visitante que escribe un bloque en std::cout.
+ */
+static void escribirEnConsola(const char* datos, size_t cantidad, void*) {
+    std::cout.write(datos, (std::streamsize)cantidad);
+}
+
+size_t ListaDeCarga::imprimirNuevos() {
+    return recorrerNuevos(escribirEnConsola, nullptr);
+}
+
+size_t ListaDeCarga::getLongitud() const {
+    return longitud;
 }
 
 void ListaDeCarga::imprimirMensaje() {
     NodoDoble* current = head;
     while (current != nullptr) {
-        std::cout << current->dato;
+        std::cout.write(current->datos, (std::streamsize)current->cantidad);
         current = current->siguiente;
     }
-}
\ No newline at end of file
+}
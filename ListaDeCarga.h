@@ -6,20 +6,69 @@
 #ifndef LISTA_DE_CARGA_H
 #define LISTA_DE_CARGA_H
 
+#include <cstddef>
+
 /**
  * @struct NodoDoble
- * @brief Estructura de nodo para la lista doblemente enlazada.
+ * @brief Estructura de nodo para la lista doblemente enlazada "desenrollada".
+ *
+ * Cada nodo guarda un bloque contiguo de hasta `CAPACIDAD` caracteres, de modo que
+ * recorrer el mensaje sigue un puntero cada 64 caracteres y no uno por carácter.
  */
 struct NodoDoble {
-    char dato;          /**< @brief Carácter almacenado en el nodo. */
-    NodoDoble* siguiente; /**< @brief Puntero al siguiente nodo en la lista. */
-    NodoDoble* previo;    /**< @brief Puntero al nodo anterior en la lista. */
+    static const size_t CAPACIDAD = 64; /**< @brief Caracteres que caben en un nodo. */
+
+    char datos[CAPACIDAD]; /**< @brief Caracteres almacenados en el nodo, en orden. */
+    size_t cantidad;       /**< @brief Número de caracteres válidos en `datos`. */
+    NodoDoble* siguiente;  /**< @brief Puntero al siguiente nodo en la lista. */
+    NodoDoble* previo;     /**< @brief Puntero al nodo anterior en la lista. */
 
     /**
      * @brief Constructor de NodoDoble.
-     * @param d El carácter a almacenar en el nodo.
+     * Crea un nodo vacío y sin enlaces.
      */
-    NodoDoble(char d) : dato(d), siguiente(nullptr), previo(nullptr) {}
+    NodoDoble() : cantidad(0), siguiente(nullptr), previo(nullptr) {}
+};
+
+/**
+ * @brief Función que recibe cada bloque contiguo de caracteres durante un recorrido.
+ * @param datos Primer carácter del bloque.
+ * @param cantidad Número de caracteres del bloque.
+ * @param contexto Puntero opaco proporcionado por quien inicia el recorrido.
+ */
+typedef void (*VisitanteBloque)(const char* datos, size_t cantidad, void* contexto);
+
+/**
+ * @struct CursorCarga
+ * @brief Posición hasta la que un lector ya recorrió el mensaje.
+ *
+ * Permite que varios lectores (la consola, el punto de control) avancen cada uno
+ * a su ritmo sin volver a recorrer el mensaje desde el principio.
+ */
+struct CursorCarga {
+    const NodoDoble* nodo; /**< @brief Nodo hasta el que se leyó (`nullptr` = nada leído). */
+    size_t posicion;       /**< @brief Caracteres ya leídos dentro de `nodo`. */
+    size_t entregados;     /**< @brief Total de caracteres ya leídos. */
+
+    /**
+     * @brief Constructor de CursorCarga. Empieza al principio del mensaje.
+     */
+    CursorCarga() : nodo(nullptr), posicion(0), entregados(0) {}
+};
+
+/**
+ * @struct BloqueNodos
+ * @brief Bloque contiguo de memoria (slab) del que se toman los nodos de la lista.
+ *
+ * Los nodos se colocan uno tras otro dentro del bloque, en lugar de pedir cada
+ * uno por separado con `new`. Los bloques se encadenan para poder liberarlos
+ * todos de una vez en el destructor de ListaDeCarga.
+ */
+struct BloqueNodos {
+    BloqueNodos* anterior; /**< @brief Bloque asignado antes que este (o `nullptr`). */
+    size_t usados;         /**< @brief Nodos ya entregados de este bloque. */
+    size_t capacidad;      /**< @brief Nodos que caben en este bloque. */
+    NodoDoble* nodos;      /**< @brief Primer nodo del bloque (la memoria sigue a esta cabecera). */
 };
 
 /**
@@ -33,6 +82,21 @@ class ListaDeCarga {
 private:
     NodoDoble* head; /**< @brief Puntero al primer nodo de la lista. */
     NodoDoble* tail; /**< @brief Puntero al último nodo de la lista. */
+    BloqueNodos* bloqueActual; /**< @brief Bloque del que se toman los nodos nuevos. */
+    size_t longitud; /**< @brief Número total de caracteres almacenados. */
+    CursorCarga cursorNuevos; /**< @brief Hasta dónde entregó el mensaje recorrerNuevos(). */
+
+    /**
+     * @brief Obtiene un nodo vacío del bloque actual, reservando otro bloque si está lleno.
+     * @return Puntero al nodo inicializado, o `nullptr` si no hay memoria.
+     */
+    NodoDoble* crearNodo();
+
+    /**
+     * @brief Enlaza un nodo vacío nuevo al final de la lista.
+     * @return `true` si se pudo crear el nodo, `false` si no hay memoria.
+     */
+    bool agregarNodo();
 
 public:
     /**
@@ -43,19 +107,75 @@ public:
 
     /**
      * @brief Destructor de ListaDeCarga.
-     * Libera toda la memoria asignada dinámicamente para los nodos de la lista.
+     * Libera de una vez todos los bloques de los que se tomaron los nodos.
      */
     ~ListaDeCarga();
 
     /**
      * @brief Inserta un carácter al final de la lista.
+     * Solo crea un nodo nuevo cuando el último está lleno (costo O(1)).
      * @param dato El carácter a insertar.
      */
     void insertarAlFinal(char dato);
 
+    /**
+     * @brief Inserta un bloque de caracteres al final de la lista, en orden.
+     * Copia los caracteres con `memcpy`, llenando primero el espacio libre del último nodo.
+     * @param datos Puntero al primer carácter del bloque.
+     * @param cantidad Número de caracteres a insertar.
+     */
+    void insertarBloque(const char* datos, size_t cantidad);
+
+    /**
+     * @brief Recorre el mensaje en orden, un bloque contiguo (nodo) a la vez.
+     * @param visitar Función que se llama con cada bloque no vacío.
+     * @param contexto Puntero opaco que se pasa sin cambios a `visitar`.
+     */
+    void recorrerBloques(VisitanteBloque visitar, void* contexto) const;
+
+    /**
+     * @brief Recorre solo los caracteres insertados desde la última llamada.
+     *
+     * La lista mantiene un cursor con lo ya entregado; cada llamada visita el resto
+     * y deja el cursor al final. Así, mostrar el mensaje después de cada trama
+     * cuesta O(caracteres nuevos) y no O(longitud del mensaje).
+     *
+     * @param visitar Función que se llama con cada bloque nuevo no vacío.
+     * @param contexto Puntero opaco que se pasa sin cambios a `visitar`.
+     * @return Número de caracteres visitados.
+     */
+    size_t recorrerNuevos(VisitanteBloque visitar, void* contexto);
+
+    /**
+     * @brief Obtiene cuántos caracteres visitaría ahora recorrerNuevos().
+     * @return Caracteres insertados desde la última llamada a recorrerNuevos().
+     */
+    size_t getLongitudNuevos() const;
+
+    /**
+     * @brief Copia los caracteres que un cursor propio aún no leyó, hasta un máximo.
+     * @param cursor Cursor del lector; queda detrás del último carácter copiado.
+     * @param destino Buffer de salida.
+     * @param maximo Capacidad de `destino`.
+     * @return Número de caracteres copiados (0 si el cursor está al día).
+     */
+    size_t copiarNuevos(CursorCarga* cursor, char* destino, size_t maximo) const;
+
+    /**
+     * @brief Imprime solo los caracteres insertados desde la última llamada.
+     * @return Número de caracteres impresos.
+     */
+    size_t imprimirNuevos();
+
+    /**
+     * @brief Obtiene el número de caracteres almacenados.
+     * @return Longitud del mensaje ensamblado.
+     */
+    size_t getLongitud() const;
+
     /**
      * @brief Imprime el mensaje ensamblado contenido en la lista.
-     * Los caracteres se imprimen en el orden de la lista.
+     * Los caracteres se imprimen en el orden de la lista, un bloque por escritura.
      */
     void imprimirMensaje();
 };
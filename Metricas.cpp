@@ -0,0 +1,368 @@
+/**
+ * @file Metricas.cpp
+ * @brief Implementación del registro, el volcado y la exportación de las métricas.
+ */
+
+#include "Metricas.h"
+#include <iostream>
+
+#ifdef PRT7_METRICAS
+
+#include <csignal>
+#include <cstdio>   // Para fopen, fprintf, rename
+#include <cstring>  // Para strlen, memcpy
+#include <cstdlib>  // Para malloc, free
+
+/**
+ * @brief Máximo de hilos con bloque de métricas propio.
+ */
+static const int MAXIMO_HILOS_METRICAS = 256;
+
+thread_local constinit MetricasHilo* metricasDelHilo = nullptr;
+
+static std::atomic<MetricasHilo*> hilosRegistrados[MAXIMO_HILOS_METRICAS]; /**< @brief Bloques de todos los hilos. */
+static std::atomic<int> numHilosRegistrados(0);                             /**< @brief Entradas usadas de `hilosRegistrados`. */
+
+/**
+ * @brief Se pone en 1 cuando llega SIGUSR1; el exportador lo atiende y lo vuelve a 0.
+ */
+static volatile sig_atomic_t volcadoSolicitado = 0;
+
+/**
+ * @brief Nombres de las etapas, en el orden de EtapaMetrica.
+ */
+static const char* const NOMBRES_ETAPAS[NUM_ETAPAS] = {"llegada", "parseo", "decodificacion", "salida"};
+
+/**
+ * @brief Límites de los intervalos del histograma de Prometheus, en segundos.
+ */
+static const double LIMITES_PROMETHEUS[] = {1e-7, 2.5e-7, 5e-7, 1e-6, 2.5e-6, 5e-6, 1e-5, 2.5e-5, 5e-5,
+                                            1e-4, 2.5e-4, 5e-4, 1e-3, 1e-2, 1e-1, 1.0};
+
+static const int NUM_LIMITES_PROMETHEUS = (int)(sizeof(LIMITES_PROMETHEUS) / sizeof(LIMITES_PROMETHEUS[0]));
+
+MetricasHilo* registrarHiloMetricas() {
+    MetricasHilo* metricas = new MetricasHilo();
+    int indice = numHilosRegistrados.fetch_add(1, std::memory_order_relaxed);
+    if (indice < MAXIMO_HILOS_METRICAS) {
+        hilosRegistrados[indice].store(metricas, std::memory_order_release);
+    } else if (indice == MAXIMO_HILOS_METRICAS) {
+        std::cerr << "Advertencia: Más de " << MAXIMO_HILOS_METRICAS
+                  << " hilos con métricas; los siguientes no se incluyen en los volcados." << std::endl;
+    }
+    // El bloque no se libera: las métricas de un hilo que terminó siguen en los volcados
+    metricasDelHilo = metricas;
+    return metricas;
+}
+
+/**
+ * @brief Menor duración (en ticks) que cae en un intervalo del histograma.
+ */
+static uint64_t inicioIntervalo(int intervalo) {
+    if (intervalo < (2 << BITS_SUBINTERVALO)) {
+        return (uint64_t)intervalo;
+    }
+    int k = intervalo - (2 << BITS_SUBINTERVALO);
+    int bit = k / (1 << BITS_SUBINTERVALO) + BITS_SUBINTERVALO + 1;
+    uint64_t sub = (uint64_t)(k % (1 << BITS_SUBINTERVALO));
+    return ((1ULL << BITS_SUBINTERVALO) + sub) << (bit - BITS_SUBINTERVALO);
+}
+
+/**
+ * @brief Mayor duración (en ticks) que cae en un intervalo del histograma.
+ */
+static uint64_t finIntervalo(int intervalo) {
+    if (intervalo + 1 >= NUM_INTERVALOS) {
+        return ~0ULL;
+    }
+    return inicioIntervalo(intervalo + 1) - 1;
+}
+
+/**
+ * @struct ResumenEtapa
+ * @brief Suma de los histogramas de una etapa en todos los hilos.
+ */
+struct ResumenEtapa {
+    uint64_t intervalos[NUM_INTERVALOS]; /**< @brief Muestras por intervalo. */
+    uint64_t muestras;                   /**< @brief Total de muestras. */
+    uint64_t suma;                       /**< @brief Suma de las muestras (ticks). */
+    uint64_t maximo;                     /**< @brief Mayor muestra (ticks). */
+};
+
+/**
+ * @struct ResumenMetricas
+ * @brief Métricas de todos los hilos sumadas en un instante.
+ */
+struct ResumenMetricas {
+    uint64_t contadores[NUM_CONTADORES]; /**< @brief Contadores sumados. */
+    ResumenEtapa etapas[NUM_ETAPAS];     /**< @brief Histogramas sumados por etapa. */
+    int hilos;                           /**< @brief Hilos incluidos. */
+    double nanosegundosPorTick;          /**< @brief Conversión de ticks a nanosegundos. */
+};
+
+/**
+ * @brief Suma las métricas de todos los hilos registrados.
+ * @details Los hilos siguen escribiendo mientras tanto: cada valor es exacto,
+ *          pero no todos corresponden al mismo instante.
+ * @param resumen Salida: métricas sumadas.
+ */
+static void reunirMetricas(ResumenMetricas* resumen) {
+    memset(resumen, 0, sizeof(ResumenMetricas));
+    int hilos = numHilosRegistrados.load(std::memory_order_relaxed);
+    if (hilos > MAXIMO_HILOS_METRICAS) {
+        hilos = MAXIMO_HILOS_METRICAS;
+    }
+    for (int h = 0; h < hilos; ++h) {
+        MetricasHilo* metricas = hilosRegistrados[h].load(std::memory_order_acquire);
+        if (metricas == nullptr) {
+            continue; // Registrado pero aún no publicado
+        }
+        resumen->hilos++;
+        for (int c = 0; c < NUM_CONTADORES; ++c) {
+            resumen->contadores[c] += metricas->contadores[c].load(std::memory_order_relaxed);
+        }
+        for (int e = 0; e < NUM_ETAPAS; ++e) {
+            const HistogramaLatencia& histograma = metricas->histogramas[e];
+            ResumenEtapa* etapa = &resumen->etapas[e];
+            for (int i = 0; i < NUM_INTERVALOS; ++i) {
+                uint64_t muestras = histograma.intervalos[i].load(std::memory_order_relaxed);
+                etapa->intervalos[i] += muestras;
+                etapa->muestras += muestras;
+            }
+            etapa->suma += histograma.suma.load(std::memory_order_relaxed);
+            uint64_t maximo = histograma.maximo.load(std::memory_order_relaxed);
+            if (maximo > etapa->maximo) {
+                etapa->maximo = maximo;
+            }
+        }
+    }
+    resumen->nanosegundosPorTick = nanosegundosPorTick();
+}
+
+/**
+ * @brief Obtiene un percentil de una etapa.
+ * @param etapa Histograma sumado.
+ * @param fraccion Percentil entre 0 y 1.
+ * @return Punto medio del intervalo que contiene el percentil, en ticks.
+ */
+static double percentil(const ResumenEtapa& etapa, double fraccion) {
+    uint64_t objetivo = (uint64_t)(fraccion * (double)etapa.muestras);
+    if (objetivo >= etapa.muestras) {
+        objetivo = etapa.muestras - 1;
+    }
+    uint64_t acumuladas = 0;
+    for (int i = 0; i < NUM_INTERVALOS; ++i) {
+        acumuladas += etapa.intervalos[i];
+        if (acumuladas > objetivo) {
+            double medio = ((double)inicioIntervalo(i) + (double)finIntervalo(i)) / 2.0;
+            return medio < (double)etapa.maximo ? medio : (double)etapa.maximo;
+        }
+    }
+    return (double)etapa.maximo;
+}
+
+/**
+ * @brief Manejador de SIGUSR1: solo marca la solicitud.
+ */
+static void manejarVolcado(int) {
+    volcadoSolicitado = 1;
+}
+
+bool metricasInstrumentadas() {
+    return true;
+}
+
+void instalarVolcadoPorSenal() {
+#ifdef SIGUSR1
+    std::signal(SIGUSR1, manejarVolcado);
+#endif
+}
+
+void volcarMetricas(std::ostream& salida) {
+    ResumenMetricas* resumen = (ResumenMetricas*)malloc(sizeof(ResumenMetricas));
+    if (resumen == nullptr) {
+        return;
+    }
+    reunirMetricas(resumen);
+    const uint64_t* c = resumen->contadores;
+    salida << "Métricas (" << resumen->hilos << " hilos): " << c[CONTADOR_LINEAS] << " líneas, "
+           << c[CONTADOR_CARGAS] << " LOAD, " << c[CONTADOR_MAPAS] << " MAP, " << c[CONTADOR_INVALIDAS]
+           << " inválidas, " << c[CONTADOR_INFORMATIVAS] << " informativas; " << c[CONTADOR_LECTURAS]
+           << " lecturas, " << c[CONTADOR_BYTES] << " bytes." << std::endl;
+    salida << "  Una de cada " << MUESTREO_METRICAS << " tramas cronometrada." << std::endl;
+    salida << "  etapa            muestras    media      p50      p90      p99    p99,9   máximo (ns)" << std::endl;
+    for (int e = 0; e < NUM_ETAPAS; ++e) {
+        const ResumenEtapa& etapa = resumen->etapas[e];
+        if (etapa.muestras == 0) {
+            continue;
+        }
+        double escala = resumen->nanosegundosPorTick;
+        char linea[160];
+        snprintf(linea, sizeof(linea), "  %-14s %10llu %8.0f %8.0f %8.0f %8.0f %8.0f %8.0f", NOMBRES_ETAPAS[e],
+                 (unsigned long long)etapa.muestras, (double)etapa.suma / (double)etapa.muestras * escala,
+                 percentil(etapa, 0.5) * escala, percentil(etapa, 0.9) * escala, percentil(etapa, 0.99) * escala,
+                 percentil(etapa, 0.999) * escala, (double)etapa.maximo * escala);
+        salida << linea << std::endl;
+    }
+    free(resumen);
+}
+
+bool exportarPrometheus(const char* ruta) {
+    ResumenMetricas* resumen = (ResumenMetricas*)malloc(sizeof(ResumenMetricas));
+    size_t longitudRuta = strlen(ruta);
+    char* rutaTemporal = (char*)malloc(longitudRuta + 5);
+    if (resumen == nullptr || rutaTemporal == nullptr) {
+        free(resumen);
+        free(rutaTemporal);
+        return false;
+    }
+    memcpy(rutaTemporal, ruta, longitudRuta);
+    memcpy(rutaTemporal + longitudRuta, ".tmp", 5);
+    reunirMetricas(resumen);
+
+    FILE* archivo = fopen(rutaTemporal, "w");
+    if (archivo == nullptr) {
+        free(resumen);
+        free(rutaTemporal);
+        return false;
+    }
+    const uint64_t* c = resumen->contadores;
+    fprintf(archivo, "# HELP prt7_lecturas_total Lecturas del puerto o la entrada que devolvieron datos.\n");
+    fprintf(archivo, "# TYPE prt7_lecturas_total counter\nprt7_lecturas_total %llu\n",
+            (unsigned long long)c[CONTADOR_LECTURAS]);
+    fprintf(archivo, "# HELP prt7_bytes_total Bytes recibidos.\n");
+    fprintf(archivo, "# TYPE prt7_bytes_total counter\nprt7_bytes_total %llu\n", (unsigned long long)c[CONTADOR_BYTES]);
+    fprintf(archivo, "# HELP prt7_lineas_total Líneas entregadas por la fuente.\n");
+    fprintf(archivo, "# TYPE prt7_lineas_total counter\nprt7_lineas_total %llu\n", (unsigned long long)c[CONTADOR_LINEAS]);
+    fprintf(archivo, "# HELP prt7_tramas_total Tramas procesadas por tipo.\n# TYPE prt7_tramas_total counter\n");
+    fprintf(archivo, "prt7_tramas_total{tipo=\"carga\"} %llu\n", (unsigned long long)c[CONTADOR_CARGAS]);
+    fprintf(archivo, "prt7_tramas_total{tipo=\"mapa\"} %llu\n", (unsigned long long)c[CONTADOR_MAPAS]);
+    fprintf(archivo, "prt7_tramas_total{tipo=\"invalida\"} %llu\n", (unsigned long long)c[CONTADOR_INVALIDAS]);
+    fprintf(archivo, "prt7_tramas_total{tipo=\"informativa\"} %llu\n", (unsigned long long)c[CONTADOR_INFORMATIVAS]);
+
+    double segundosPorTick = resumen->nanosegundosPorTick * 1e-9;
+    fprintf(archivo, "# HELP prt7_latencia_segundos Duración de cada etapa de una trama (una de cada %u tramas).\n",
+            (unsigned)MUESTREO_METRICAS);
+    fprintf(archivo, "# TYPE prt7_latencia_segundos histogram\n");
+    for (int e = 0; e < NUM_ETAPAS; ++e) {
+        const ResumenEtapa& etapa = resumen->etapas[e];
+        // Un intervalo del histograma cuenta para un límite si todo él queda por debajo
+        int intervalo = 0;
+        uint64_t acumuladas = 0;
+        for (int l = 0; l < NUM_LIMITES_PROMETHEUS; ++l) {
+            while (intervalo < NUM_INTERVALOS && (double)finIntervalo(intervalo) * segundosPorTick <= LIMITES_PROMETHEUS[l]) {
+                acumuladas += etapa.intervalos[intervalo++];
+            }
+            fprintf(archivo, "prt7_latencia_segundos_bucket{etapa=\"%s\",le=\"%g\"} %llu\n", NOMBRES_ETAPAS[e],
+                    LIMITES_PROMETHEUS[l], (unsigned long long)acumuladas);
+        }
+        fprintf(archivo, "prt7_latencia_segundos_bucket{etapa=\"%s\",le=\"+Inf\"} %llu\n", NOMBRES_ETAPAS[e],
+                (unsigned long long)etapa.muestras);
+        fprintf(archivo, "prt7_latencia_segundos_sum{etapa=\"%s\"} %.9g\n", NOMBRES_ETAPAS[e],
+                (double)etapa.suma * segundosPorTick);
+        fprintf(archivo, "prt7_latencia_segundos_count{etapa=\"%s\"} %llu\n", NOMBRES_ETAPAS[e],
+                (unsigned long long)etapa.muestras);
+    }
+    fprintf(archivo, "# HELP prt7_latencia_maxima_segundos Mayor duración observada de cada etapa.\n");
+    fprintf(archivo, "# TYPE prt7_latencia_maxima_segundos gauge\n");
+    for (int e = 0; e < NUM_ETAPAS; ++e) {
+        fprintf(archivo, "prt7_latencia_maxima_segundos{etapa=\"%s\"} %.9g\n", NOMBRES_ETAPAS[e],
+                (double)resumen->etapas[e].maximo * segundosPorTick);
+    }
+
+    bool correcto = fclose(archivo) == 0 && rename(rutaTemporal, ruta) == 0;
+    free(resumen);
+    free(rutaTemporal);
+    return correcto;
+}
+
+ExportadorMetricas::ExportadorMetricas() : rutaPrometheus(nullptr), detener(false) {}
+
+ExportadorMetricas::~ExportadorMetricas() {
+    detenerYExportar();
+}
+
+void ExportadorMetricas::iniciar(const char* rutaPrometheus) {
+    if (hilo.joinable()) {
+        return;
+    }
+    this->rutaPrometheus = rutaPrometheus;
+    detener = false;
+    metricasHilo(); // Crear aquí el bloque del hilo principal y no en la primera trama
+    instalarVolcadoPorSenal();
+    hilo = std::thread(&ExportadorMetricas::ejecutar, this);
+}
+
+void ExportadorMetricas::ejecutar() {
+    auto ultimaExportacion = std::chrono::steady_clock::now();
+    bool errorInformado = false;
+    std::unique_lock<std::mutex> cerrojo(mutex);
+    while (!detener) {
+        despertador.wait_for(cerrojo, std::chrono::milliseconds(INTERVALO_SONDEO_MS));
+        if (detener) {
+            break;
+        }
+        cerrojo.unlock();
+        if (volcadoSolicitado) {
+            volcadoSolicitado = 0;
+            volcarMetricas(std::cerr);
+        }
+        auto ahora = std::chrono::steady_clock::now();
+        if (rutaPrometheus != nullptr &&
+            ahora - ultimaExportacion >= std::chrono::milliseconds(INTERVALO_EXPORTACION_MS)) {
+            ultimaExportacion = ahora;
+            if (!exportarPrometheus(rutaPrometheus) && !errorInformado) {
+                std::cerr << "Error: No se pudo escribir " << rutaPrometheus << std::endl;
+                errorInformado = true;
+            }
+        }
+        cerrojo.lock();
+    }
+}
+
+void ExportadorMetricas::detenerYExportar() {
+    if (!hilo.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> cerrojo(mutex);
+        detener = true;
+    }
+    despertador.notify_one();
+    hilo.join();
+    if (rutaPrometheus != nullptr && !exportarPrometheus(rutaPrometheus)) {
+        std::cerr << "Error: No se pudo escribir " << rutaPrometheus << std::endl;
+    }
+}
+
+#else
+
+bool metricasInstrumentadas() {
+    return false;
+}
+
+void instalarVolcadoPorSenal() {
+    // Sin métricas: SIGUSR1 conserva su acción por defecto.
+}
+
+void volcarMetricas(std::ostream&) {
+    // Sin métricas no hay nada que volcar.
+}
+
+bool exportarPrometheus(const char*) {
+    return false;
+}
+
+ExportadorMetricas::ExportadorMetricas() : rutaPrometheus(nullptr), detener(false) {}
+
+ExportadorMetricas::~ExportadorMetricas() {}
+
+void ExportadorMetricas::iniciar(const char*) {
+    // Sin métricas no hay nada que exportar.
+}
+
+void ExportadorMetricas::ejecutar() {}
+
+void ExportadorMetricas::detenerYExportar() {}
+
+#endif // PRT7_METRICAS
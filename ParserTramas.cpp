@@ -0,0 +1,149 @@
+/**
+ * @file ParserTramas.cpp
+ * @brief Implementación de las funciones de parseo de tramas PRT-7.
+ */
+
+#include "ParserTramas.h"
+#include "TramaCompacta.h"
+#include "DivisorTramas.h"
+#include <cstring>  // Para memchr, strlen
+
+/**
+ * @brief Lee un entero con signo opcional, acumulando en unsigned como el parser original.
+ * @param linea Línea a examinar.
+ * @param len Longitud de la línea.
+ * @param pos Entrada/salida: posición del primer carácter del número.
+ * @param conSigno Salida: `true` si el número llevaba '+' o '-'.
+ * @return El valor leído (0 si no hay dígitos).
+ */
+static int leerEntero(const char* linea, size_t len, size_t* pos, bool* conSigno) {
+    int sign = 1;
+    *conSigno = false;
+    if (*pos < len && linea[*pos] == '-') {
+        sign = -1;
+        *conSigno = true;
+        (*pos)++;
+    } else if (*pos < len && linea[*pos] == '+') {
+        *conSigno = true;
+        (*pos)++;
+    }
+
+    // Acumular en unsigned para que un número demasiado largo se trunque de forma definida
+    unsigned int valor = 0;
+    while (*pos < len && linea[*pos] >= '0' && linea[*pos] <= '9') {
+        valor = valor * 10u + (unsigned int)(linea[*pos] - '0');
+        (*pos)++;
+    }
+    return (int)valor * sign;
+}
+
+TipoLinea clasificarLinea(const char* linea, size_t longitud, char* dato, int* rotacion, int* rotor) {
+    *dato = '\0';
+    *rotacion = 0;
+    if (rotor != nullptr) {
+        *rotor = 0;
+    }
+
+    // La línea termina en el primer '\0', igual que con manual_strlen
+    size_t len = longitud;
+    if (longitud == (size_t)-1) {
+        len = strlen(linea);
+    } else {
+        const char* nulo = (const char*)memchr(linea, '\0', longitud);
+        if (nulo != nullptr) {
+            len = (size_t)(nulo - linea);
+        }
+    }
+
+    if (len == 0 || (linea[0] != 'L' && linea[0] != 'M')) {
+        return LINEA_INFO;
+    }
+
+    // Verificar longitud mínima y que hay una coma en la posición correcta
+    if (len < 3 || linea[1] != ',') {
+        return LINEA_INVALIDA;
+    }
+
+    if (linea[0] == 'L') {
+        *dato = linea[2]; // Puede ser un espacio ("L, ")
+        return LINEA_CARGA;
+    }
+
+    size_t pos = 2; // Saltar "M,"
+    size_t inicioNumero = pos;
+    bool conSigno;
+    int valor = leerEntero(linea, len, &pos, &conSigno);
+    if (rotor == nullptr || pos == len || linea[pos] != ',') {
+        // Forma clásica "M,N": rota el primer rotor; como el parser original, se ignora lo que siga al número
+        *rotacion = valor;
+        return LINEA_MAPA;
+    }
+
+    // Forma "M,<rotor>,N": el índice del rotor es un número sin signo de 0 a 255
+    if (conSigno || pos == inicioNumero || (unsigned int)valor > 255u) {
+        return LINEA_INVALIDA;
+    }
+    pos++; // Saltar la segunda coma
+    *rotacion = leerEntero(linea, len, &pos, &conSigno);
+    *rotor = valor;
+    return LINEA_MAPA;
+}
+
+/**
+ * @brief Indica si un carácter termina una línea.
+ */
+static bool esFinDeLinea(char c) {
+    return c == '\n' || c == '\r';
+}
+
+bool separarLinea(const char* datos, size_t disponibles, bool finDeDatos,
+                  size_t* inicio, size_t* longitud, size_t* consumidos) {
+    // Ignorar \r y \n al inicio
+    size_t pos = 0;
+    while (pos < disponibles && esFinDeLinea(datos[pos])) {
+        pos++;
+    }
+
+    size_t principio = pos;
+    size_t limite = disponibles - principio < LONGITUD_MAXIMA_LINEA
+                        ? disponibles : principio + LONGITUD_MAXIMA_LINEA;
+    pos = (size_t)(buscarFinDeLinea(datos + principio, datos + limite) - datos);
+
+    if (pos < disponibles && esFinDeLinea(datos[pos])) {
+        *consumidos = pos + 1; // Consumir también el terminador
+    } else if (pos - principio == LONGITUD_MAXIMA_LINEA || (finDeDatos && pos > principio)) {
+        *consumidos = pos;     // Línea cortada por longitud o última línea sin terminador
+    } else {
+        *consumidos = principio; // Línea incompleta: solo se descartan los terminadores
+        return false;
+    }
+
+    *inicio = principio;
+    *longitud = pos - principio;
+    return true;
+}
+
+TramaBase* parseLine(const char* line, char* originalDataBuffer, int* rotationValue) {
+    return parseLine(line, (size_t)-1, originalDataBuffer, rotationValue);
+}
+
+TramaBase* parseLine(const char* line, size_t longitud, char* originalDataBuffer, int* rotationValue) {
+    originalDataBuffer[0] = '\0';
+    *rotationValue = 0;
+
+    if (line == nullptr) {
+        return nullptr;
+    }
+
+    TramaCompacta trama;
+    if (!parsearTrama(line, longitud, &trama)) {
+        return nullptr;
+    }
+    if (trama.tipo == TRAMA_CARGA) {
+        originalDataBuffer[0] = trama.dato;
+        originalDataBuffer[1] = '\0';
+    } else {
+        *rotationValue = trama.rotacion;
+    }
+    return crearTrama(trama);
+}
@@ -0,0 +1,91 @@
+/**
+ * @file ParserTramas.h
+ * @brief Define las funciones de parseo de las líneas de texto del protocolo PRT-7.
+ */
+
+#ifndef PARSER_TRAMAS_H
+#define PARSER_TRAMAS_H
+
+#include <cstddef>
+
+class TramaBase;
+
+/**
+ * @brief Longitud máxima de una línea; las líneas más largas se parten en fragmentos
+ *        de este tamaño, igual que lo hace SerialPort::readLine().
+ */
+const size_t LONGITUD_MAXIMA_LINEA = 255;
+
+/**
+ * @enum TipoLinea
+ * @brief Clasificación de una línea recibida.
+ */
+enum TipoLinea {
+    LINEA_INFO,     /**< @brief Mensaje informativo (no empieza con 'L' ni 'M'). */
+    LINEA_INVALIDA, /**< @brief Empieza con 'L' o 'M' pero está mal formada. */
+    LINEA_CARGA,    /**< @brief Trama LOAD válida (`L,X`). */
+    LINEA_MAPA      /**< @brief Trama MAP válida (`M,N` o `M,<rotor>,N`). */
+};
+
+/**
+ * @brief Clasifica una línea y extrae su contenido sin asignar memoria.
+ *
+ * Aplica exactamente las reglas de parseLine(): la línea termina en el primer
+ * '\0' o al alcanzar `longitud`, debe medir al menos 3 caracteres y tener una
+ * coma en la segunda posición.
+ *
+ * Con `rotor`, una trama MAP puede indicar el rotor al que va dirigida
+ * (`M,<rotor>,N`, para las pilas de rotores del firmware nuevo) y `M,N` equivale a
+ * `M,0,N`. Sin `rotor` se lee como el parser original: el primer entero es la
+ * rotación y lo que le sigue se ignora (`M,5,3` rota 5).
+ *
+ * @param linea Puntero al inicio de la línea (sin terminadores de línea).
+ * @param longitud Número máximo de bytes a examinar.
+ * @param dato Salida: carácter transportado por una trama LOAD.
+ * @param rotacion Salida: rotación transportada por una trama MAP.
+ * @param rotor Salida: rotor al que va dirigida una trama MAP (0..255), o `nullptr`
+ *              si el llamador solo tiene un rotor (forma clásica `M,N`).
+ * @return El tipo de la línea.
+ */
+TipoLinea clasificarLinea(const char* linea, size_t longitud, char* dato, int* rotacion, int* rotor = nullptr);
+
+/**
+ * @brief Busca la siguiente línea dentro de un buffer de bytes recibidos.
+ *
+ * Omite los '\n' y '\r' iniciales y corta la línea en el siguiente terminador o
+ * al llegar a LONGITUD_MAXIMA_LINEA caracteres (las mismas reglas de readLine()).
+ *
+ * @param datos Inicio de los bytes aún no consumidos.
+ * @param disponibles Número de bytes en `datos`.
+ * @param finDeDatos `true` si no llegarán más bytes: una línea final sin terminador
+ *                   también se entrega.
+ * @param inicio Salida: posición del primer carácter de la línea.
+ * @param longitud Salida: longitud de la línea.
+ * @param consumidos Salida: bytes que se pueden descartar (incluye el terminador, si lo hay).
+ *                   Si no hay línea completa, solo cuenta los terminadores iniciales.
+ * @return `true` si se encontró una línea, `false` si faltan datos.
+ */
+bool separarLinea(const char* datos, size_t disponibles, bool finDeDatos,
+                  size_t* inicio, size_t* longitud, size_t* consumidos);
+
+/**
+ * @brief Parsea una línea de texto recibida y crea el objeto TramaBase correspondiente.
+ * @param line Línea terminada en '\0'.
+ * @param originalDataBuffer Salida: carácter original de una trama LOAD (o cadena vacía).
+ * @param rotationValue Salida: rotación de una trama MAP (o 0).
+ * @return Una nueva TramaLoad o TramaMap que el llamador debe liberar con `delete`,
+ *         o `nullptr` si la línea está mal formada.
+ */
+TramaBase* parseLine(const char* line, char* originalDataBuffer, int* rotationValue);
+
+/**
+ * @brief Variante de parseLine() para líneas delimitadas por longitud.
+ * @param line Inicio de la línea (no necesita terminar en '\0').
+ * @param longitud Número de caracteres de la línea.
+ * @param originalDataBuffer Salida: carácter original de una trama LOAD (o cadena vacía).
+ * @param rotationValue Salida: rotación de una trama MAP (o 0).
+ * @return Una nueva TramaLoad o TramaMap, o `nullptr` si la línea está mal formada.
+ */
+TramaBase* parseLine(const char* line, size_t longitud, char* originalDataBuffer, int* rotationValue);
+
+#endif // PARSER_TRAMAS_H
@@ -0,0 +1,190 @@
+/**
+ * @file PilaDeRotores.cpp
+ * @brief Implementación de la clase PilaDeRotores.
+ */
+
+#include "PilaDeRotores.h"
+#include <cctype>   // Necesario para toupper
+
+/**
+ * @brief Símbolo de cada índice absoluto (A=0, ..., ' '=26).
+ */
+static const char ALFABETO[PilaDeRotores::TAMANO_ALFABETO + 1] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ ";
+
+PilaDeRotores::PilaDeRotores(int numRotores, bool avance)
+    : numRotores(numRotores), avance(avance), primerSufijoValido(0), compuestaValida(false), compilaciones(0) {
+    if (this->numRotores < 1) {
+        this->numRotores = 1;
+    } else if (this->numRotores > MAXIMO_ROTORES) {
+        this->numRotores = MAXIMO_ROTORES;
+    }
+
+    for (int r = 0; r < MAXIMO_ROTORES; ++r) {
+        desplazamientos[r] = 0;
+        for (int i = 0; i < TAMANO_ALFABETO; ++i) {
+            cableado[r][i] = (unsigned char)i;
+        }
+    }
+    // El sufijo vacío (después del último rotor) es la identidad
+    for (int i = 0; i < TAMANO_ALFABETO; ++i) {
+        sufijos[this->numRotores][i] = (unsigned char)i;
+    }
+    primerSufijoValido = this->numRotores;
+
+    // Misma clasificación de bytes que RotorDeMapeo: minúsculas como mayúsculas, espacio = 26
+    for (int b = 0; b < 256; ++b) {
+        int upper = toupper(b);
+        if (upper >= 'A' && upper <= 'Z') {
+            indiceAbsoluto[b] = (signed char)(upper - 'A');
+        } else if (b == ' ') {
+            indiceAbsoluto[b] = 26;
+        } else {
+            indiceAbsoluto[b] = -1;
+        }
+    }
+}
+
+void PilaDeRotores::invalidar(int rotor) {
+    if (rotor > 0 && primerSufijoValido <= rotor) {
+        primerSufijoValido = rotor + 1;
+    }
+    compuestaValida = false;
+}
+
+void PilaDeRotores::compilarSufijos() {
+    // sufijos[r](x) = sufijos[r + 1](cableado_r[(x + d_r) % 27]), del último rotor hacia el primero
+    for (int r = primerSufijoValido - 1; r >= 1; --r) {
+        int posicion = desplazamientos[r];
+        for (int x = 0; x < TAMANO_ALFABETO; ++x) {
+            sufijos[r][x] = sufijos[r + 1][cableado[r][posicion]];
+            posicion = (posicion + 1 == TAMANO_ALFABETO) ? 0 : posicion + 1;
+        }
+    }
+    if (primerSufijoValido > 1) {
+        primerSufijoValido = 1;
+        compilaciones++;
+    }
+}
+
+void PilaDeRotores::compilarCompuesta() {
+    compilarSufijos();
+    const unsigned char* resto = sufijos[1];
+
+    // Primero los 27 símbolos del alfabeto, después los 256 bytes posibles
+    char porIndice[TAMANO_ALFABETO];
+    int posicion = desplazamientos[0];
+    for (int x = 0; x < TAMANO_ALFABETO; ++x) {
+        porIndice[x] = ALFABETO[resto[cableado[0][posicion]]];
+        posicion = (posicion + 1 == TAMANO_ALFABETO) ? 0 : posicion + 1;
+    }
+    for (int b = 0; b < 256; ++b) {
+        int indice = indiceAbsoluto[b];
+        tablaCompuesta[b] = indice < 0 ? (char)b : porIndice[indice];
+    }
+    compuestaValida = true;
+    compilaciones++;
+}
+
+void PilaDeRotores::avanzar() {
+    for (int r = 0; r < numRotores; ++r) {
+        invalidar(r);
+        if (++desplazamientos[r] < TAMANO_ALFABETO) {
+            return;
+        }
+        desplazamientos[r] = 0; // Vuelta completa: arrastrar al siguiente rotor
+    }
+}
+
+bool PilaDeRotores::setCableado(int rotor, const char* permutacion) {
+    if (rotor < 0 || rotor >= numRotores || permutacion == nullptr) {
+        return false;
+    }
+
+    unsigned char nuevo[TAMANO_ALFABETO];
+    bool usado[TAMANO_ALFABETO] = {};
+    for (int i = 0; i < TAMANO_ALFABETO; ++i) {
+        if (permutacion[i] == '\0') {
+            return false; // Menos de 27 símbolos
+        }
+        int indice = indiceAbsoluto[(unsigned char)permutacion[i]];
+        if (indice < 0 || usado[indice]) {
+            return false; // Símbolo fuera del alfabeto o repetido
+        }
+        usado[indice] = true;
+        nuevo[i] = (unsigned char)indice;
+    }
+    if (permutacion[TAMANO_ALFABETO] != '\0') {
+        return false; // Más de 27 símbolos
+    }
+
+    for (int i = 0; i < TAMANO_ALFABETO; ++i) {
+        cableado[rotor][i] = nuevo[i];
+    }
+    invalidar(rotor);
+    return true;
+}
+
+bool PilaDeRotores::rotar(int rotor, int n) {
+    if (rotor < 0 || rotor >= numRotores) {
+        return false;
+    }
+
+    int pasos = n % TAMANO_ALFABETO;
+    if (pasos < 0) {
+        pasos += TAMANO_ALFABETO;
+    }
+    if (pasos == 0) {
+        return true;
+    }
+
+    desplazamientos[rotor] += pasos;
+    if (desplazamientos[rotor] >= TAMANO_ALFABETO) {
+        desplazamientos[rotor] -= TAMANO_ALFABETO;
+    }
+    invalidar(rotor);
+    return true;
+}
+
+char PilaDeRotores::getMapeo(char in) {
+    if (!compuestaValida) {
+        compilarCompuesta();
+    }
+    return tablaCompuesta[(unsigned char)in];
+}
+
+char PilaDeRotores::decodificar(char in) {
+    if (!avance) {
+        return getMapeo(in);
+    }
+
+    // El rotor 0 cambia en cada carácter: aplicarlo aparte sobre la composición del resto
+    char salida = in;
+    int indice = indiceAbsoluto[(unsigned char)in];
+    if (indice >= 0) {
+        if (primerSufijoValido > 1) {
+            compilarSufijos();
+        }
+        int posicion = indice + desplazamientos[0];
+        if (posicion >= TAMANO_ALFABETO) {
+            posicion -= TAMANO_ALFABETO;
+        }
+        salida = ALFABETO[sufijos[1][cableado[0][posicion]]];
+    }
+    avanzar();
+    return salida;
+}
+
+int PilaDeRotores::getNumRotores() const {
+    return numRotores;
+}
+
+int PilaDeRotores::getDesplazamiento(int rotor) const {
+    if (rotor < 0 || rotor >= numRotores) {
+        return -1;
+    }
+    return desplazamientos[rotor];
+}
+
+unsigned long PilaDeRotores::getCompilaciones() const {
+    return compilaciones;
+}
@@ -0,0 +1,130 @@
+/**
+ * @file PilaDeRotores.h
+ * @brief Define una pila de rotores encadenados (estilo Enigma) con una tabla de mapeo compuesta.
+ */
+
+#ifndef PILA_DE_ROTORES_H
+#define PILA_DE_ROTORES_H
+
+#include "RotorDeMapeo.h"
+
+/**
+ * @class PilaDeRotores
+ * @brief Varios rotores encadenados, como los que usa el firmware nuevo (RotorStack).
+ *
+ * Cada carácter atraviesa los rotores en orden, del 0 al K-1. El rotor `i` tiene un
+ * cableado fijo (una permutación del alfabeto A-Z y espacio) y una rotación `d_i`:
+ * convierte el índice absoluto `x` en `cableado_i[(x + d_i) % 27]`. Con el cableado
+ * identidad y un solo rotor equivale exactamente a RotorDeMapeo.
+ *
+ * Las tramas `M,<rotor>,N` giran un rotor concreto (`M,N` gira el rotor 0). Con el
+ * avance activado, el rotor 0 avanza una posición después de cada trama LOAD y, al
+ * completar la vuelta (pasar de 26 a 0), arrastra al siguiente, como un odómetro.
+ * Las rotaciones explícitas no generan arrastre.
+ *
+ * Para que el costo por carácter no dependa de K, los K rotores se compilan en una
+ * tabla compuesta de 256 entradas cada vez que cambia el estado. Con el avance
+ * activado el rotor 0 cambia en cada carácter, así que se aplica aparte (una suma
+ * y una consulta) sobre la composición de los rotores 1..K-1. Esa composición se
+ * guarda por sufijos (rotores r..K-1): un arrastre que llega hasta el rotor r solo
+ * recompila los sufijos 1..r, de modo que el costo amortizado tampoco depende de K.
+ */
+class PilaDeRotores {
+public:
+    static const int MAXIMO_ROTORES = 16; /**< @brief Número máximo de rotores en la pila. */
+    static const int TAMANO_ALFABETO = RotorDeMapeo::TAMANO_ALFABETO; /**< @brief Símbolos por rotor. */
+
+private:
+    int numRotores;  /**< @brief Número de rotores (1..MAXIMO_ROTORES). */
+    bool avance;     /**< @brief Avanzar el rotor 0 tras cada trama LOAD, con arrastre. */
+    int desplazamientos[MAXIMO_ROTORES]; /**< @brief Rotación actual de cada rotor (0..26). */
+    unsigned char cableado[MAXIMO_ROTORES][TAMANO_ALFABETO]; /**< @brief Permutación de índices de cada rotor. */
+    signed char indiceAbsoluto[256]; /**< @brief Índice absoluto de cada byte, o -1 si no pertenece al alfabeto. */
+    unsigned char sufijos[MAXIMO_ROTORES + 1][TAMANO_ALFABETO]; /**< @brief `sufijos[r]`: rotores r..K-1 compuestos (índice → índice). */
+    char tablaCompuesta[256]; /**< @brief Los K rotores compuestos (byte recibido → carácter decodificado). */
+    int primerSufijoValido; /**< @brief Los sufijos desde este índice corresponden al estado actual. */
+    bool compuestaValida;   /**< @brief `tablaCompuesta` corresponde al estado actual. */
+    unsigned long compilaciones; /**< @brief Veces que se recompiló alguna de las tablas. */
+
+    /**
+     * @brief Recompila los sufijos que dejaron de ser válidos, hasta `sufijos[1]`.
+     */
+    void compilarSufijos();
+
+    /**
+     * @brief Marca como inválidos los sufijos que incluyen a un rotor que cambió.
+     * @param rotor Índice del rotor que cambió.
+     */
+    void invalidar(int rotor);
+
+    /**
+     * @brief Recompila `tablaCompuesta` a partir de todos los rotores.
+     */
+    void compilarCompuesta();
+
+    /**
+     * @brief Avanza el rotor 0 una posición y propaga el arrastre.
+     */
+    void avanzar();
+
+public:
+    /**
+     * @brief Constructor de PilaDeRotores.
+     * Todos los rotores empiezan con el cableado identidad y rotación 0.
+     * @param numRotores Número de rotores; se limita al rango 1..MAXIMO_ROTORES.
+     * @param avance `true` para avanzar los rotores tras cada trama LOAD.
+     */
+    explicit PilaDeRotores(int numRotores = 1, bool avance = false);
+
+    /**
+     * @brief Cambia el cableado de un rotor.
+     * @param rotor Índice del rotor (0..getNumRotores()-1).
+     * @param permutacion 27 caracteres con cada símbolo del alfabeto exactamente una vez;
+     *                    la posición `i` indica a qué símbolo lleva el índice `i`.
+     * @return `true` si el cableado es válido y se aplicó, `false` en caso contrario.
+     */
+    bool setCableado(int rotor, const char* permutacion);
+
+    /**
+     * @brief Gira un rotor N posiciones (reducidas módulo 27, como RotorDeMapeo::rotar()).
+     * @param rotor Índice del rotor.
+     * @param n Posiciones a girar; negativo gira hacia atrás.
+     * @return `false` si el rotor no existe en la pila.
+     */
+    bool rotar(int rotor, int n);
+
+    /**
+     * @brief Mapea un carácter con el estado actual, sin avanzar los rotores.
+     * @param in Carácter de entrada.
+     * @return El carácter mapeado, o `in` si no pertenece al alfabeto.
+     */
+    char getMapeo(char in);
+
+    /**
+     * @brief Decodifica el carácter de una trama LOAD y, si el avance está activo, avanza la pila.
+     * @param in Carácter recibido.
+     * @return El carácter decodificado con el estado previo al avance.
+     */
+    char decodificar(char in);
+
+    /**
+     * @brief Obtiene el número de rotores.
+     * @return Número de rotores de la pila.
+     */
+    int getNumRotores() const;
+
+    /**
+     * @brief Obtiene la rotación actual de un rotor.
+     * @param rotor Índice del rotor.
+     * @return La rotación (0..26), o -1 si el rotor no existe.
+     */
+    int getDesplazamiento(int rotor) const;
+
+    /**
+     * @brief Obtiene cuántas veces se recompilaron las tablas.
+     * @return Número de compilaciones desde la construcción.
+     */
+    unsigned long getCompilaciones() const;
+};
+
+#endif // PILA_DE_ROTORES_H
@@ -0,0 +1,234 @@
+/**
+ * @file ProcesadorLineas.cpp
+ * @brief Implementación del procesamiento y la presentación de las líneas recibidas.
+ */
+
+#include "ProcesadorLineas.h"
+#include "Metricas.h"
+#include "TramaCompacta.h"
+#include <iostream>
+
+char* itoa_custom(int val, char* buf) {
+    if (buf == nullptr) return nullptr;
+
+    int i = 0;
+    int isNegative = 0;
+
+    if (val == 0) {
+        buf[i++] = '0';
+        buf[i] = '\0';
+        return buf;
+    }
+
+    if (val < 0) {
+        isNegative = 1;
+        val = -val;
+    }
+
+    int start = 0;
+    while (val != 0) {
+        buf[i++] = (val % 10) + '0';
+        val /= 10;
+    }
+
+    if (isNegative) {
+        buf[i++] = '-';
+    }
+
+    buf[i] = '\0';
+
+    // Invertir la cadena
+    int end = i - 1;
+    while (start < end) {
+        char temp = buf[start];
+        buf[start] = buf[end];
+        buf[end] = temp;
+        start++;
+        end--;
+    }
+    return buf;
+}
+
+/**
+ * @brief Deja un ResultadoLinea en blanco y parsea la línea.
+ * @param linea Línea recibida.
+ * @param trama Salida: trama parseada.
+ * @param resultado Salida: RESULTADO_INFO o RESULTADO_INVALIDA si la línea no es una trama válida.
+ * @param variosRotores `true` para reconocer las tramas `M,<rotor>,N` (ver parsearTrama()).
+ * @return `true` si la línea es una trama válida que hay que procesar.
+ */
+static bool prepararResultado(const VistaLinea& linea, TramaCompacta* trama, ResultadoLinea* resultado,
+                              bool variosRotores) {
+    resultado->original = '\0';
+    resultado->decodificado = '\0';
+    resultado->referencia = '\0';
+    resultado->mapeoReferencia = '\0';
+    resultado->rotacion = 0;
+    resultado->rotor = 0;
+
+    // Ignorar líneas que no son tramas (mensajes del Arduino)
+    if (linea.datos[0] != 'L' && linea.datos[0] != 'M') {
+        resultado->tipo = RESULTADO_INFO;
+        return false;
+    }
+
+    // La trama se parsea en el lugar: sin memoria dinámica ni despacho virtual
+    if (!parsearTrama(linea.datos, linea.longitud, trama, variosRotores)) {
+        resultado->tipo = RESULTADO_INVALIDA;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Cierra la etapa de decodificación y cuenta la línea según su tipo (ver Metricas.h).
+ */
+static inline void registrarProcesada(const ResultadoLinea* resultado) {
+    marcarEtapa(ETAPA_DECODIFICACION);
+    contarEvento(resultado->tipo == RESULTADO_CARGA ? CONTADOR_CARGAS : resultado->tipo == RESULTADO_MAPA ? CONTADOR_MAPAS
+                 : resultado->tipo == RESULTADO_INVALIDA ? CONTADOR_INVALIDAS : CONTADOR_INFORMATIVAS);
+}
+
+void procesarLinea(const VistaLinea& linea, ListaDeCarga* carga, RotorDeMapeo* rotor, ResultadoLinea* resultado) {
+    TramaCompacta trama;
+    bool valida = prepararResultado(linea, &trama, resultado, false);
+    marcarEtapa(ETAPA_PARSEO);
+    if (!valida) {
+        registrarProcesada(resultado);
+        return;
+    }
+
+    if (trama.tipo == TRAMA_CARGA) {
+        resultado->tipo = RESULTADO_CARGA;
+        resultado->original = trama.dato;
+        resultado->rotacion = rotor->getDesplazamiento();
+        resultado->decodificado = rotor->getMapeo(trama.dato);
+        procesarTrama(trama, carga, rotor);
+    } else {
+        resultado->tipo = RESULTADO_MAPA;
+        resultado->rotacion = trama.rotacion;
+        procesarTrama(trama, carga, rotor);
+        resultado->referencia = rotor->getSimbolo(0);
+        resultado->mapeoReferencia = rotor->getMapeo(resultado->referencia);
+    }
+    registrarProcesada(resultado);
+}
+
+void procesarLinea(const VistaLinea& linea, ListaDeCarga* carga, PilaDeRotores* pila, ResultadoLinea* resultado) {
+    TramaCompacta trama;
+    bool valida = prepararResultado(linea, &trama, resultado, pila->getNumRotores() > 1);
+    marcarEtapa(ETAPA_PARSEO);
+    if (!valida) {
+        registrarProcesada(resultado);
+        return;
+    }
+
+    if (trama.tipo == TRAMA_CARGA) {
+        resultado->tipo = RESULTADO_CARGA;
+        resultado->original = trama.dato;
+        resultado->rotacion = pila->getDesplazamiento(0);
+        resultado->decodificado = pila->decodificar(trama.dato);
+        carga->insertarAlFinal(resultado->decodificado);
+    } else if (!pila->rotar(trama.rotor, trama.rotacion)) {
+        resultado->tipo = RESULTADO_INVALIDA; // Rotor fuera de la pila
+    } else {
+        resultado->tipo = RESULTADO_MAPA;
+        resultado->rotacion = trama.rotacion;
+        resultado->rotor = trama.rotor;
+        resultado->referencia = 'A';
+        resultado->mapeoReferencia = pila->getMapeo('A');
+    }
+    registrarProcesada(resultado);
+}
+
+/**
+ * @brief Copia un texto al final de un buffer.
+ * @return Posición siguiente al texto copiado.
+ */
+static char* agregarTexto(char* destino, const char* texto) {
+    while (*texto != '\0') {
+        *destino++ = *texto++;
+    }
+    return destino;
+}
+
+size_t formatearDetalle(const ResultadoLinea& resultado, char* destino) {
+    char* p = destino;
+    if (resultado.tipo == RESULTADO_CARGA) {
+        // Mostrar el carácter de forma legible
+        if (resultado.original == ' ') {
+            p = agregarTexto(p, "Fragmento 'Space' decodificado como '");
+        } else {
+            p = agregarTexto(p, "Fragmento '");
+            *p++ = resultado.original;
+            p = agregarTexto(p, "' decodificado como '");
+        }
+
+        if (resultado.decodificado == ' ') {
+            p = agregarTexto(p, "Space");
+        } else {
+            *p++ = resultado.decodificado;
+        }
+        p = agregarTexto(p, "'. ");
+    } else {
+        char buffer[12]; // Suficiente para "-2147483648"
+        p = agregarTexto(p, "ROTANDO ROTOR ");
+        if (resultado.rotor != 0) {
+            p = agregarTexto(p, itoa_custom(resultado.rotor, buffer));
+            p = agregarTexto(p, " EN ");
+        }
+        p = agregarTexto(p, itoa_custom(resultado.rotacion, buffer));
+        p = agregarTexto(p, ". (Ahora '");
+        *p++ = resultado.referencia;
+        p = agregarTexto(p, "' se mapea a '");
+        *p++ = resultado.mapeoReferencia;
+        p = agregarTexto(p, "') ");
+    }
+    return (size_t)(p - destino);
+}
+
+bool mostrarResultado(const VistaLinea& linea, const ResultadoLinea& resultado, ModoSalida modo, ListaDeCarga* mensaje) {
+    if (resultado.tipo == RESULTADO_INFO) {
+        // Es un mensaje informativo del Arduino, no una trama
+        if (modo == SALIDA_SILENCIOSA) {
+            return false;
+        }
+        std::cout << "[INFO Arduino]: ";
+        std::cout.write(linea.datos, (std::streamsize)linea.longitud) << '\n';
+        return true;
+    }
+
+    if (modo == SALIDA_SILENCIOSA) {
+        if (resultado.tipo == RESULTADO_INVALIDA) {
+            std::cerr << "Error: No se pudo parsear la trama: ";
+            std::cerr.write(linea.datos, (std::streamsize)linea.longitud) << std::endl;
+        }
+        return false;
+    }
+
+    std::cout << "Trama recibida: [";
+    std::cout.write(linea.datos, (std::streamsize)linea.longitud) << "] -> Procesando... -> ";
+
+    if (resultado.tipo == RESULTADO_INVALIDA) {
+        // std::cerr está ligado a std::cout: lo pendiente se vacía antes del error
+        std::cerr << "Error: No se pudo parsear la trama: ";
+        std::cerr.write(linea.datos, (std::streamsize)linea.longitud) << std::endl;
+        return false;
+    }
+
+    char detalle[LONGITUD_MAXIMA_DETALLE];
+    std::cout.write(detalle, (std::streamsize)formatearDetalle(resultado, detalle));
+
+    // Imprimir el estado actual del mensaje ensamblado
+    if (modo == SALIDA_COMPLETA) {
+        std::cout << "Mensaje: [";
+        mensaje->imprimirMensaje();
+        std::cout << "]\n";
+    } else {
+        // Solo lo que se agregó desde la trama anterior
+        std::cout << "Mensaje += [";
+        mensaje->imprimirNuevos();
+        std::cout << "]\n";
+    }
+    return true;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file ProcesadorLineas.h
+ * @brief Define el procesamiento de una línea recibida y su presentación en consola.
+ */
+
+#ifndef PROCESADOR_LINEAS_H
+#define PROCESADOR_LINEAS_H
+
+#include "FuenteTramas.h"
+#include "ListaDeCarga.h"
+#include "RotorDeMapeo.h"
+#include "PilaDeRotores.h"
+
+/**
+ * @enum ModoSalida
+ * @brief Qué se muestra en consola por cada trama procesada.
+ */
+enum ModoSalida {
+    SALIDA_COMPLETA,    /**< @brief Detalle de la trama y el mensaje completo (formato original). */
+    SALIDA_INCREMENTAL, /**< @brief Detalle de la trama y solo los caracteres nuevos del mensaje. */
+    SALIDA_SILENCIOSA   /**< @brief Nada por trama; solo el mensaje final. */
+};
+
+/**
+ * @enum TipoResultado
+ * @brief Qué era la línea procesada.
+ */
+enum TipoResultado {
+    RESULTADO_INFO,     /**< @brief Mensaje informativo del Arduino. */
+    RESULTADO_INVALIDA, /**< @brief Trama mal formada. */
+    RESULTADO_CARGA,    /**< @brief Trama LOAD procesada. */
+    RESULTADO_MAPA      /**< @brief Trama MAP procesada. */
+};
+
+/**
+ * @struct ResultadoLinea
+ * @brief Todo lo necesario para mostrar una línea después de procesarla.
+ *
+ * Permite separar el procesamiento (que modifica el rotor y la lista) de la
+ * escritura en consola, p. ej. para hacerlos en hilos distintos.
+ */
+struct ResultadoLinea {
+    TipoResultado tipo; /**< @brief Tipo de la línea. */
+    char original;      /**< @brief Carácter recibido (RESULTADO_CARGA). */
+    char decodificado;  /**< @brief Carácter decodificado (RESULTADO_CARGA). */
+    char referencia;    /**< @brief Primer símbolo del alfabeto ('A' en el latino), cuyo mapeo se muestra (RESULTADO_MAPA). */
+    char mapeoReferencia; /**< @brief A qué se mapea `referencia` tras la rotación (RESULTADO_MAPA). */
+    int rotacion;       /**< @brief Rotación recibida (RESULTADO_MAPA) o desplazamiento del rotor (del primero, con la pila) al decodificar (RESULTADO_CARGA). */
+    int rotor;          /**< @brief Rotor girado (RESULTADO_MAPA); 0 con un solo rotor. */
+};
+
+/**
+ * @brief Caracteres que ocupa como máximo el detalle de formatearDetalle().
+ */
+const size_t LONGITUD_MAXIMA_DETALLE = 96;
+
+/**
+ * @brief Convierte un entero a una cadena de caracteres.
+ * @param val Valor a convertir.
+ * @param buf Buffer de salida (al menos 12 bytes).
+ * @return `buf`.
+ */
+char* itoa_custom(int val, char* buf);
+
+/**
+ * @brief Procesa una línea: decodifica una trama LOAD o rota el rotor con una trama MAP.
+ * @param linea Línea recibida.
+ * @param carga Lista donde se agregan los caracteres decodificados.
+ * @param rotor Rotor de mapeo.
+ * @param resultado Salida: lo que se hizo con la línea.
+ */
+void procesarLinea(const VistaLinea& linea, ListaDeCarga* carga, RotorDeMapeo* rotor, ResultadoLinea* resultado);
+
+/**
+ * @brief Variante de procesarLinea() para una pila de varios rotores.
+ *
+ * Una trama MAP dirigida a un rotor que no existe en la pila se informa como
+ * RESULTADO_INVALIDA. Con un solo rotor se comporta como la versión de RotorDeMapeo.
+ *
+ * @param linea Línea recibida.
+ * @param carga Lista donde se agregan los caracteres decodificados.
+ * @param pila Pila de rotores.
+ * @param resultado Salida: lo que se hizo con la línea.
+ */
+void procesarLinea(const VistaLinea& linea, ListaDeCarga* carga, PilaDeRotores* pila, ResultadoLinea* resultado);
+
+/**
+ * @brief Escribe lo que se hizo con una trama LOAD o MAP, p. ej. `Fragmento 'A' decodificado como 'X'. `
+ * @param resultado Resultado de procesarLinea() (RESULTADO_CARGA o RESULTADO_MAPA).
+ * @param destino Buffer de al menos LONGITUD_MAXIMA_DETALLE caracteres (no se termina en '\0').
+ * @return Caracteres escritos.
+ */
+size_t formatearDetalle(const ResultadoLinea& resultado, char* destino);
+
+/**
+ * @brief Muestra en consola una línea ya procesada, con el formato del modo elegido.
+ *
+ * Los errores de parseo se escriben en `std::cerr` en todos los modos.
+ *
+ * @param linea Línea recibida.
+ * @param resultado Resultado de procesarLinea().
+ * @param modo Formato de la salida.
+ * @param mensaje Mensaje ensamblado hasta esta línea (incluida).
+ * @return `true` si se escribió algo en `std::cout` que aún no se vació.
+ */
+bool mostrarResultado(const VistaLinea& linea, const ResultadoLinea& resultado, ModoSalida modo, ListaDeCarga* mensaje);
+
+#endif // PROCESADOR_LINEAS_H
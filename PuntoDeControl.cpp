@@ -0,0 +1,354 @@
+/**
+ * @file PuntoDeControl.cpp
+ * @brief Implementación de los puntos de control y de la reanudación.
+ */
+
+#include "PuntoDeControl.h"
+#include "Crc8.h"
+#include <cstdlib>  // Para malloc, free, strtol
+#include <cstring>  // Para strlen, memcpy, strstr
+#include <iostream>
+
+#ifdef _WIN32
+    #include <windows.h>
+    #include <io.h>     // Para _commit, _open, _chsize_s
+    #include <fcntl.h>
+#else
+    #include <unistd.h> // Para fsync, truncate
+#endif
+
+/**
+ * @brief Primera línea de `.chk`; el número es la versión del formato.
+ */
+static const char CABECERA_ESTADO[] = "PRT7-CHK 1\n";
+
+/**
+ * @brief Tamaño máximo de `.chk` (con 16 rotores ocupa menos de 300 bytes).
+ */
+static const size_t MAXIMO_ARCHIVO_ESTADO = 1024;
+
+/**
+ * @brief Concatena una base y una extensión en una cadena nueva.
+ * @return La cadena (liberar con free()), o `nullptr` si no hay memoria.
+ */
+static char* unirRuta(const char* base, const char* extension) {
+    size_t largoBase = strlen(base);
+    size_t largoExtension = strlen(extension);
+    char* ruta = (char*)malloc(largoBase + largoExtension + 1);
+    if (ruta != nullptr) {
+        memcpy(ruta, base, largoBase);
+        memcpy(ruta + largoBase, extension, largoExtension + 1);
+    }
+    return ruta;
+}
+
+/**
+ * @brief Fuerza que lo escrito en un archivo llegue al disco.
+ * @return `true` si la sincronización tuvo éxito.
+ */
+static bool sincronizarArchivo(FILE* archivo) {
+    if (fflush(archivo) != 0) {
+        return false;
+    }
+#ifdef _WIN32
+    return _commit(_fileno(archivo)) == 0;
+#else
+    return fsync(fileno(archivo)) == 0;
+#endif
+}
+
+/**
+ * @brief Recorta un archivo a una longitud.
+ * @return `true` si se pudo recortar.
+ */
+static bool truncarArchivo(const char* ruta, unsigned long long longitud) {
+#ifdef _WIN32
+    int fd = _open(ruta, _O_RDWR | _O_BINARY);
+    if (fd < 0) {
+        return false;
+    }
+    bool correcto = _chsize_s(fd, (__int64)longitud) == 0;
+    _close(fd);
+    return correcto;
+#else
+    return truncate(ruta, (off_t)longitud) == 0;
+#endif
+}
+
+/**
+ * @brief Reemplaza un archivo por otro en un solo paso.
+ * @return `true` si se pudo renombrar.
+ */
+static bool reemplazarArchivo(const char* origen, const char* destino) {
+#ifdef _WIN32
+    return MoveFileExA(origen, destino, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return rename(origen, destino) == 0;
+#endif
+}
+
+PuntoDeControl::PuntoDeControl()
+    : rutaEstado(nullptr), rutaTemporal(nullptr), rutaBitacora(nullptr), bitacora(nullptr),
+      anillo(nullptr), terminar(false), activo(false), escritos(0), pospuestos(0), fallidos(0) {}
+
+PuntoDeControl::~PuntoDeControl() {
+    if (activo) {
+        terminar.store(true, std::memory_order_release);
+        escritor.join();
+        fclose(bitacora);
+        activo = false;
+    }
+    delete anillo;
+    liberarRutas();
+}
+
+void PuntoDeControl::liberarRutas() {
+    free(rutaEstado);
+    free(rutaTemporal);
+    free(rutaBitacora);
+    rutaEstado = nullptr;
+    rutaTemporal = nullptr;
+    rutaBitacora = nullptr;
+}
+
+bool PuntoDeControl::cargar(const char* base, EstadoDecodificador* estado, ListaDeCarga* carga) {
+    char* rutaEstado = unirRuta(base, ".chk");
+    char* rutaBitacora = unirRuta(base, ".log");
+    char* contenido = (char*)malloc(MAXIMO_ARCHIVO_ESTADO + 1);
+    char* bloque = (char*)malloc(64 * 1024);
+    bool correcto = false;
+
+    FILE* archivo = nullptr;
+    size_t leidos = 0;
+    if (rutaEstado != nullptr && rutaBitacora != nullptr && contenido != nullptr && bloque != nullptr) {
+        archivo = fopen(rutaEstado, "rb");
+    }
+    if (archivo == nullptr) {
+        std::cerr << "ERROR: No se pudo leer el punto de control " << base << ".chk" << std::endl;
+    } else {
+        leidos = fread(contenido, 1, MAXIMO_ARCHIVO_ESTADO, archivo);
+        fclose(archivo);
+        contenido[leidos] = '\0';
+
+        // El CRC-8 de la última línea protege todo lo anterior
+        const char* lineaCrc = strstr(contenido, "crc ");
+        bool integro = lineaCrc != nullptr && strncmp(contenido, CABECERA_ESTADO, strlen(CABECERA_ESTADO)) == 0 &&
+                       strtol(lineaCrc + 4, nullptr, 16) ==
+                           calcularCrc8((const unsigned char*)contenido, (size_t)(lineaCrc - contenido));
+        int consumidos = 0;
+        if (integro && sscanf(contenido + strlen(CABECERA_ESTADO),
+                              "tramas %llu\nposicion %llu\nsecuencia %d\nmensaje %llu\nrotores %d%n",
+                              &estado->tramas, &estado->posicion, &estado->secuencia,
+                              &estado->longitudMensaje, &estado->numRotores, &consumidos) == 5 &&
+            estado->numRotores >= 1 && estado->numRotores <= PilaDeRotores::MAXIMO_ROTORES) {
+            const char* cursorTexto = contenido + strlen(CABECERA_ESTADO) + consumidos;
+            correcto = true;
+            for (int r = 0; r < estado->numRotores; ++r) {
+                char* fin = nullptr;
+                long valor = strtol(cursorTexto, &fin, 10);
+                if (fin == cursorTexto || valor < 0 || valor >= RotorDeMapeo::TAMANO_ALFABETO) {
+                    correcto = false;
+                    break;
+                }
+                estado->desplazamientos[r] = (int)valor;
+                cursorTexto = fin;
+            }
+        }
+        if (!correcto) {
+            std::cerr << "ERROR: El punto de control " << base << ".chk está dañado." << std::endl;
+        }
+    }
+
+    if (correcto) {
+        // Reconstruir el mensaje: solo los caracteres que el estado da por escritos
+        FILE* log = fopen(rutaBitacora, "rb");
+        unsigned long long pendientes = estado->longitudMensaje;
+        while (log != nullptr && pendientes > 0) {
+            size_t pedir = pendientes < 64 * 1024 ? (size_t)pendientes : 64 * 1024;
+            size_t n = fread(bloque, 1, pedir, log);
+            if (n == 0) {
+                break;
+            }
+            carga->insertarBloque(bloque, n);
+            pendientes -= n;
+        }
+        if (log != nullptr) {
+            fclose(log);
+        }
+        if (log == nullptr || pendientes > 0) {
+            std::cerr << "ERROR: La bitácora " << base << ".log tiene menos caracteres que el punto de control." << std::endl;
+            correcto = false;
+        } else if (!truncarArchivo(rutaBitacora, estado->longitudMensaje)) {
+            std::cerr << "ERROR: No se pudo recortar la bitácora " << base << ".log" << std::endl;
+            correcto = false;
+        }
+    }
+
+    free(bloque);
+    free(contenido);
+    free(rutaBitacora);
+    free(rutaEstado);
+    return correcto;
+}
+
+bool PuntoDeControl::abrir(const char* base, bool reanudar, const EstadoDecodificador& inicial,
+                           const ListaDeCarga& carga) {
+    rutaEstado = unirRuta(base, ".chk");
+    rutaTemporal = unirRuta(base, ".chk.tmp");
+    rutaBitacora = unirRuta(base, ".log");
+    if (rutaEstado == nullptr || rutaTemporal == nullptr || rutaBitacora == nullptr) {
+        liberarRutas();
+        return false;
+    }
+
+    bitacora = fopen(rutaBitacora, reanudar ? "ab" : "wb");
+    if (bitacora == nullptr) {
+        std::cerr << "ERROR: No se pudo abrir la bitácora " << rutaBitacora << std::endl;
+        liberarRutas();
+        return false;
+    }
+    EstadoDecodificador estado = inicial;
+    estado.longitudMensaje = carga.getLongitud();
+    if (!reanudar && !escribirEstado(estado)) {
+        std::cerr << "ERROR: No se pudo escribir el punto de control " << rutaEstado << std::endl;
+        fclose(bitacora);
+        bitacora = nullptr;
+        liberarRutas();
+        return false;
+    }
+
+    // Lo que ya está en la lista (cargado o no) no vuelve a la bitácora
+    cursor = CursorCarga();
+    char descarte[CAPACIDAD_BLOQUE];
+    while (carga.copiarNuevos(&cursor, descarte, sizeof(descarte)) > 0) {
+    }
+
+    anillo = new AnilloSPSC<BloqueBitacora, CAPACIDAD_ANILLO>();
+    terminar.store(false, std::memory_order_relaxed);
+    proximo = std::chrono::steady_clock::now() + std::chrono::milliseconds(INTERVALO_PUNTO_CONTROL_MS);
+    activo = true;
+    escritor = std::thread(&PuntoDeControl::ejecutarEscritor, this);
+    return true;
+}
+
+bool PuntoDeControl::escribirEstado(const EstadoDecodificador& estado) {
+    char contenido[MAXIMO_ARCHIVO_ESTADO];
+    int n = snprintf(contenido, sizeof(contenido),
+                     "%stramas %llu\nposicion %llu\nsecuencia %d\nmensaje %llu\nrotores %d",
+                     CABECERA_ESTADO, estado.tramas, estado.posicion, estado.secuencia,
+                     estado.longitudMensaje, estado.numRotores);
+    for (int r = 0; r < estado.numRotores && n > 0 && (size_t)n < sizeof(contenido) - 16; ++r) {
+        n += snprintf(contenido + n, sizeof(contenido) - (size_t)n, " %d", estado.desplazamientos[r]);
+    }
+    n += snprintf(contenido + n, sizeof(contenido) - (size_t)n, "\n");
+    n += snprintf(contenido + n, sizeof(contenido) - (size_t)n, "crc %02X\n",
+                  calcularCrc8((const unsigned char*)contenido, (size_t)n));
+
+    FILE* temporal = fopen(rutaTemporal, "wb");
+    if (temporal == nullptr) {
+        return false;
+    }
+    bool correcto = fwrite(contenido, 1, (size_t)n, temporal) == (size_t)n && sincronizarArchivo(temporal);
+    correcto = fclose(temporal) == 0 && correcto;
+    return correcto && reemplazarArchivo(rutaTemporal, rutaEstado);
+}
+
+void PuntoDeControl::ejecutarEscritor() {
+    while (true) {
+        BloqueBitacora* bloque = anillo->frente();
+        if (bloque == nullptr) {
+            if (terminar.load(std::memory_order_acquire)) {
+                bloque = anillo->frente(); // Lo publicado antes de la orden de terminar ya es visible
+                if (bloque == nullptr) {
+                    break;
+                }
+            } else {
+                // Los puntos de control son esporádicos: no hace falta reaccionar al instante
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                continue;
+            }
+        }
+
+        if (!bloque->esEstado) {
+            if (fwrite(bloque->datos, 1, bloque->cantidad, bitacora) != bloque->cantidad) {
+                fallidos++;
+            }
+        } else if (sincronizarArchivo(bitacora) && escribirEstado(bloque->estado)) {
+            // La bitácora ya está en disco: recién ahora el estado puede apuntar a ella
+            escritos++;
+        } else {
+            fallidos++;
+        }
+        anillo->liberar();
+    }
+}
+
+bool PuntoDeControl::vencido() const {
+    return std::chrono::steady_clock::now() >= proximo;
+}
+
+bool PuntoDeControl::registrar(const EstadoDecodificador& estado, const ListaDeCarga& carga) {
+    // Primero los caracteres nuevos; el estado solo cuando todos están en camino
+    while (cursor.entregados < carga.getLongitud()) {
+        BloqueBitacora* bloque = anillo->reservar();
+        if (bloque == nullptr) {
+            pospuestos++;
+            return false;
+        }
+        bloque->esEstado = false;
+        bloque->cantidad = carga.copiarNuevos(&cursor, bloque->datos, CAPACIDAD_BLOQUE);
+        anillo->publicar();
+    }
+    BloqueBitacora* bloque = anillo->reservar();
+    if (bloque == nullptr) {
+        pospuestos++;
+        return false;
+    }
+    bloque->esEstado = true;
+    bloque->cantidad = 0;
+    bloque->estado = estado;
+    bloque->estado.longitudMensaje = cursor.entregados;
+    anillo->publicar();
+    proximo = std::chrono::steady_clock::now() + std::chrono::milliseconds(INTERVALO_PUNTO_CONTROL_MS);
+    return true;
+}
+
+void PuntoDeControl::cerrar(const EstadoDecodificador* estado, const ListaDeCarga& carga) {
+    if (!activo) {
+        return;
+    }
+    // Al terminar ya no hay nada que proteger: vaciar el anillo y escribir el resto desde aquí
+    terminar.store(true, std::memory_order_release);
+    escritor.join();
+    if (estado != nullptr) {
+        char bloque[CAPACIDAD_BLOQUE];
+        size_t n;
+        bool correcto = true;
+        while ((n = carga.copiarNuevos(&cursor, bloque, sizeof(bloque))) > 0) {
+            correcto = fwrite(bloque, 1, n, bitacora) == n && correcto;
+        }
+        EstadoDecodificador final = *estado;
+        final.longitudMensaje = cursor.entregados;
+        if (correcto && sincronizarArchivo(bitacora) && escribirEstado(final)) {
+            escritos++;
+        } else {
+            fallidos++;
+        }
+    }
+    fclose(bitacora);
+    bitacora = nullptr;
+    activo = false;
+}
+
+bool PuntoDeControl::estaActivo() const {
+    return activo;
+}
+
+void PuntoDeControl::imprimirResumen() const {
+    std::cout << "Puntos de control: " << escritos << " escritos en " << rutaEstado << " ("
+              << pospuestos << " pospuestos por el anillo lleno";
+    if (fallidos > 0) {
+        std::cout << ", " << fallidos << " errores de escritura";
+    }
+    std::cout << ")." << std::endl;
+}
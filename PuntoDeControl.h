@@ -0,0 +1,177 @@
+/**
+ * @file PuntoDeControl.h
+ * @brief Define los puntos de control que permiten reanudar la decodificación tras un reinicio.
+ */
+
+#ifndef PUNTO_DE_CONTROL_H
+#define PUNTO_DE_CONTROL_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <thread>
+#include "AnilloSPSC.h"
+#include "ListaDeCarga.h"
+#include "PilaDeRotores.h"
+
+/**
+ * @brief Tiempo mínimo entre dos puntos de control.
+ */
+const int INTERVALO_PUNTO_CONTROL_MS = 500;
+
+/**
+ * @struct EstadoDecodificador
+ * @brief Lo que hace falta, además del mensaje, para continuar la decodificación.
+ */
+struct EstadoDecodificador {
+    unsigned long long tramas;   /**< @brief Líneas procesadas. */
+    unsigned long long posicion; /**< @brief Bytes consumidos de la captura (0 con un puerto serial). */
+    int secuencia;               /**< @brief Siguiente secuencia esperada, o -1 sin `--secuencia`. */
+    int numRotores;              /**< @brief Rotores guardados (1 con un solo RotorDeMapeo). */
+    int desplazamientos[PilaDeRotores::MAXIMO_ROTORES]; /**< @brief Desplazamiento (0..26) de cada rotor. */
+    unsigned long long longitudMensaje; /**< @brief Caracteres del mensaje ya escritos en la bitácora. */
+};
+
+/**
+ * @class PuntoDeControl
+ * @brief Guarda periódicamente el estado del decodificador sin frenar el procesamiento.
+ *
+ * Usa dos archivos con la misma base:
+ * - `<base>.log`: bitácora del mensaje; solo se le agregan los caracteres nuevos.
+ * - `<base>.chk`: estado (rotores, tramas, posición, secuencia, longitud de la
+ *   bitácora), unos pocos cientos de bytes que se reemplazan de forma atómica
+ *   (archivo temporal + rename) y llevan un CRC-8.
+ *
+ * El hilo que decodifica solo copia los caracteres nuevos y el estado en un
+ * AnilloSPSC; un hilo escritor los pasa a disco, sincroniza la bitácora y después
+ * reemplaza `.chk`, de modo que el estado nunca apunta a caracteres que no llegaron
+ * al disco. Si el anillo está lleno, el punto de control se pospone en lugar de esperar.
+ *
+ * Reanudar lee `.chk` y los caracteres de la bitácora que indica: el costo depende
+ * del tamaño del mensaje, no de cuántas tramas se recibieron.
+ */
+class PuntoDeControl {
+public:
+    static const size_t CAPACIDAD_BLOQUE = 4096; /**< @brief Caracteres por bloque de la bitácora. */
+    static const size_t CAPACIDAD_ANILLO = 64;   /**< @brief Bloques en tránsito hacia el hilo escritor. */
+
+private:
+    /**
+     * @struct BloqueBitacora
+     * @brief Elemento del anillo: caracteres para la bitácora o un estado a guardar.
+     */
+    struct BloqueBitacora {
+        bool esEstado;                 /**< @brief `true` si el bloque lleva un estado y no caracteres. */
+        size_t cantidad;               /**< @brief Caracteres en `datos`. */
+        char datos[CAPACIDAD_BLOQUE];  /**< @brief Caracteres nuevos del mensaje. */
+        EstadoDecodificador estado;    /**< @brief Estado a escribir en `.chk`. */
+    };
+
+    char* rutaEstado;     /**< @brief Ruta de `<base>.chk`. */
+    char* rutaTemporal;   /**< @brief Ruta de `<base>.chk.tmp`. */
+    char* rutaBitacora;   /**< @brief Ruta de `<base>.log`. */
+    FILE* bitacora;       /**< @brief Bitácora abierta para agregar (solo la usa el hilo escritor). */
+    AnilloSPSC<BloqueBitacora, CAPACIDAD_ANILLO>* anillo; /**< @brief Bloques del hilo decodificador al escritor. */
+    std::thread escritor; /**< @brief Hilo que escribe en disco. */
+    std::atomic<bool> terminar; /**< @brief Pide al escritor que termine al vaciar el anillo. */
+    CursorCarga cursor;   /**< @brief Hasta dónde se copió el mensaje al anillo. */
+    std::chrono::steady_clock::time_point proximo; /**< @brief Cuándo toca el siguiente punto de control. */
+    bool activo;          /**< @brief Hay archivos abiertos y un escritor en marcha. */
+    unsigned long escritos;   /**< @brief Puntos de control escritos (lo actualiza el escritor). */
+    unsigned long pospuestos; /**< @brief Puntos de control pospuestos por tener el anillo lleno. */
+    unsigned long fallidos;   /**< @brief Errores de escritura (lo actualiza el escritor). */
+
+    /**
+     * @brief Bucle del hilo escritor.
+     */
+    void ejecutarEscritor();
+
+    /**
+     * @brief Escribe un estado en `.chk` de forma atómica.
+     * @param estado Estado a guardar.
+     * @return `true` si se escribió y se renombró correctamente.
+     */
+    bool escribirEstado(const EstadoDecodificador& estado);
+
+    /**
+     * @brief Libera las rutas.
+     */
+    void liberarRutas();
+
+public:
+    /**
+     * @brief Constructor de PuntoDeControl. No abre ningún archivo.
+     */
+    PuntoDeControl();
+
+    /**
+     * @brief Destructor de PuntoDeControl. Detiene el escritor sin guardar un último estado.
+     */
+    ~PuntoDeControl();
+
+    PuntoDeControl(const PuntoDeControl&) = delete;
+    PuntoDeControl& operator=(const PuntoDeControl&) = delete;
+
+    /**
+     * @brief Lee un punto de control y reconstruye el mensaje desde la bitácora.
+     *
+     * Los caracteres que la bitácora tenga más allá de lo que indica `.chk` (escritos
+     * después del último punto de control) se descartan.
+     *
+     * @param base Ruta base de los archivos.
+     * @param estado Salida: estado guardado.
+     * @param carga Lista vacía donde se carga el mensaje.
+     * @return `true` si el punto de control es válido y la bitácora está completa.
+     */
+    static bool cargar(const char* base, EstadoDecodificador* estado, ListaDeCarga* carga);
+
+    /**
+     * @brief Abre los archivos y arranca el hilo escritor.
+     *
+     * Sin `reanudar`, vacía la bitácora y escribe de inmediato `inicial` en `.chk`,
+     * para que un punto de control anterior no se combine con la bitácora nueva.
+     *
+     * @param base Ruta base de los archivos.
+     * @param reanudar `true` si se continúa desde cargar(): la bitácora se conserva.
+     * @param inicial Estado actual (el cargado, o el inicial del decodificador).
+     * @param carga Mensaje actual; solo lo que se agregue después irá a la bitácora.
+     * @return `true` si se pudieron abrir los archivos.
+     */
+    bool abrir(const char* base, bool reanudar, const EstadoDecodificador& inicial, const ListaDeCarga& carga);
+
+    /**
+     * @brief Indica si ya pasó el intervalo desde el último punto de control.
+     * @return `true` si conviene llamar a registrar().
+     */
+    bool vencido() const;
+
+    /**
+     * @brief Entrega al escritor los caracteres nuevos y el estado, sin bloquear.
+     * @param estado Estado en este momento (`longitudMensaje` se completa aquí).
+     * @param carga Mensaje ensamblado, coherente con `estado`.
+     * @return `true` si se registró; `false` si se pospuso porque el anillo está lleno.
+     */
+    bool registrar(const EstadoDecodificador& estado, const ListaDeCarga& carga);
+
+    /**
+     * @brief Detiene el escritor y guarda el estado final sin pasar por el anillo.
+     * @param estado Estado final, o `nullptr` si no es exacto (se conserva el punto de control anterior).
+     * @param carga Mensaje final.
+     */
+    void cerrar(const EstadoDecodificador* estado, const ListaDeCarga& carga);
+
+    /**
+     * @brief Indica si hay un punto de control abierto.
+     * @return `true` entre abrir() y cerrar().
+     */
+    bool estaActivo() const;
+
+    /**
+     * @brief Muestra en consola cuántos puntos de control se escribieron.
+     * @details Llamar después de cerrar().
+     */
+    void imprimirResumen() const;
+};
+
+#endif // PUNTO_DE_CONTROL_H
@@ -0,0 +1,29 @@
+/**
+ * @file RelojTicks.cpp
+ * @brief Calibración del reloj de ticks.
+ */
+
+#include "RelojTicks.h"
+#include <thread>
+
+/**
+ * @brief Ticks y tiempo de `steady_clock` al iniciar el programa, para convertir ticks a nanosegundos.
+ */
+static const uint64_t ticksIniciales = leerTicks();
+static const std::chrono::steady_clock::time_point instanteInicial = std::chrono::steady_clock::now();
+
+double nanosegundosPorTick() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    while (true) {
+        uint64_t ticks = leerTicks() - ticksIniciales;
+        double nanosegundos = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() -
+                                                                       instanteInicial).count();
+        if (nanosegundos >= 1e7 && ticks > 0) {
+            return nanosegundos / (double)ticks;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+#else
+    return 1.0; // leerTicks() ya devuelve nanosegundos
+#endif
+}
@@ -0,0 +1,42 @@
+/**
+ * @file RelojTicks.h
+ * @brief Reloj de bajo costo para medir duraciones en el bucle de decodificación.
+ */
+
+#ifndef RELOJ_TICKS_H
+#define RELOJ_TICKS_H
+
+#include <chrono>
+#include <cstdint>
+#if defined(_MSC_VER)
+    #include <intrin.h>     // Para __rdtsc
+#elif defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>  // Para __rdtsc
+#endif
+
+/**
+ * @brief Lee el reloj de las métricas y la traza.
+ *
+ * En x86 lee el contador de ciclos (`rdtsc`), que cuesta menos que `steady_clock`
+ * y no pasa por el sistema operativo; los ticks se convierten a nanosegundos con
+ * nanosegundosPorTick() solo al mostrarlos.
+ *
+ * @return Ticks del contador de ciclos (x86) o nanosegundos de `steady_clock` (otras arquitecturas).
+ */
+inline uint64_t leerTicks() {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+    return __rdtsc();
+#else
+    return (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+/**
+ * @brief Calcula cuántos nanosegundos dura un tick.
+ * @details Compara los ticks y `steady_clock` transcurridos desde el inicio del
+ *          programa; si pasaron menos de 10 ms, espera hasta completarlos.
+ * @return Nanosegundos por tick (1 fuera de x86).
+ */
+double nanosegundosPorTick();
+
+#endif // RELOJ_TICKS_H
@@ -0,0 +1,37 @@
+/**
+ * @file RotorAlfabeto.cpp
+ * @brief Implementación de la selección de alfabetos al ejecutar.
+ */
+
+#include "RotorAlfabeto.h"
+#include <cstring>
+#include <iostream>
+
+/**
+ * @brief Descripción de cada TipoAlfabeto, en el orden del enum.
+ */
+static const DescripcionAlfabeto ALFABETOS[NUM_ALFABETOS] = {
+    {"latino", AlfabetoLatino::TAMANO,
+     TablasAlfabeto<AlfabetoLatino>::INDICES.valor, TablasAlfabeto<AlfabetoLatino>::SIMBOLOS.valor},
+    {"digitos", AlfabetoDigitos::TAMANO,
+     TablasAlfabeto<AlfabetoDigitos>::INDICES.valor, TablasAlfabeto<AlfabetoDigitos>::SIMBOLOS.valor},
+    {"imprimible", AlfabetoImprimible::TAMANO,
+     TablasAlfabeto<AlfabetoImprimible>::INDICES.valor, TablasAlfabeto<AlfabetoImprimible>::SIMBOLOS.valor},
+    {"bytes", AlfabetoBytes::TAMANO,
+     TablasAlfabeto<AlfabetoBytes>::INDICES.valor, TablasAlfabeto<AlfabetoBytes>::SIMBOLOS.valor},
+};
+
+const DescripcionAlfabeto& describirAlfabeto(TipoAlfabeto tipo) {
+    return ALFABETOS[tipo];
+}
+
+bool leerAlfabeto(const char* nombre, TipoAlfabeto* tipo) {
+    for (int i = 0; i < NUM_ALFABETOS; ++i) {
+        if (strcmp(nombre, ALFABETOS[i].nombre) == 0) {
+            *tipo = (TipoAlfabeto)i;
+            return true;
+        }
+    }
+    std::cerr << "Alfabeto no reconocido: " << nombre << std::endl;
+    return false;
+}
@@ -0,0 +1,227 @@
+/**
+ * @file RotorAlfabeto.h
+ * @brief Define las tablas de cada alfabeto y rotores especializados en tiempo de compilación
+ *        para un alfabeto (RotorAlfabeto).
+ */
+
+#ifndef ROTOR_ALFABETO_H
+#define ROTOR_ALFABETO_H
+
+#include <cstddef>
+#include <cstdint>
+#include "Alfabetos.h"
+
+/**
+ * @struct TablasAlfabeto
+ * @brief Tablas de un alfabeto (ver Alfabetos.h), generadas al compilar.
+ *
+ * - `INDICES`: índice absoluto de cada byte de entrada, o -1 si no pertenece al alfabeto.
+ * - `SIMBOLOS`: los símbolos dos veces seguidas, para que `SIMBOLOS[indice + desplazamiento]`
+ *   no necesite restar el tamaño cuando la suma se pasa del final.
+ *
+ * @tparam Alfabeto Tipo que describe el alfabeto.
+ */
+template <class Alfabeto>
+struct TablasAlfabeto {
+    static constexpr int TAMANO = Alfabeto::TAMANO; /**< @brief Cantidad de símbolos. */
+    static_assert(TAMANO >= 1 && TAMANO <= 256, "Un alfabeto tiene entre 1 y 256 símbolos");
+
+    /**
+     * @struct Indices
+     * @brief Índice absoluto de cada byte.
+     *
+     * Es `int16_t` para todos los alfabetos (256 símbolos no caben en un byte con signo),
+     * así RotorDeMapeo recorre las tablas de cualquiera con el mismo código.
+     */
+    struct Indices {
+        int16_t valor[256]; /**< @brief Índice del byte, o -1. */
+    };
+
+    /**
+     * @struct Simbolos
+     * @brief Símbolos repetidos dos veces.
+     */
+    struct Simbolos {
+        char valor[2 * TAMANO]; /**< @brief `valor[i] == valor[i + TAMANO] == Alfabeto::simbolo(i)`. */
+    };
+
+    /**
+     * @brief Comprueba que ningún símbolo se repite.
+     * @return `true` si los símbolos son distintos.
+     */
+    static constexpr bool simbolosUnicos() {
+        bool visto[256] = {};
+        for (int i = 0; i < TAMANO; ++i) {
+            unsigned char b = (unsigned char)Alfabeto::simbolo(i);
+            if (visto[b]) {
+                return false;
+            }
+            visto[b] = true;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Genera la tabla de índices.
+     */
+    static constexpr Indices construirIndices() {
+        Indices t{};
+        for (int b = 0; b < 256; ++b) {
+            t.valor[b] = -1;
+        }
+        for (int i = 0; i < TAMANO; ++i) {
+            t.valor[(unsigned char)Alfabeto::simbolo(i)] = (int16_t)i;
+        }
+        if (Alfabeto::IGUALAR_MINUSCULAS) {
+            for (int b = 'a'; b <= 'z'; ++b) {
+                if (t.valor[b] < 0) {
+                    t.valor[b] = t.valor[b - 'a' + 'A'];
+                }
+            }
+        }
+        return t;
+    }
+
+    /**
+     * @brief Genera la tabla de símbolos repetidos.
+     */
+    static constexpr Simbolos construirSimbolos() {
+        Simbolos t{};
+        for (int i = 0; i < TAMANO; ++i) {
+            t.valor[i] = Alfabeto::simbolo(i);
+            t.valor[i + TAMANO] = Alfabeto::simbolo(i);
+        }
+        return t;
+    }
+
+    static_assert(simbolosUnicos(), "Los símbolos de un alfabeto no se pueden repetir");
+
+    static constexpr Indices INDICES = construirIndices();    /**< @brief Índice absoluto de cada byte. */
+    static constexpr Simbolos SIMBOLOS = construirSimbolos(); /**< @brief Símbolos repetidos dos veces. */
+};
+
+/**
+ * @class RotorAlfabeto
+ * @brief Rotor con el mismo comportamiento que RotorDeMapeo, pero con el alfabeto fijado al compilar.
+ *
+ * El tamaño del alfabeto es una constante, así que la reducción de rotar() se compila
+ * como multiplicación y desplazamiento en lugar de una división, y las tablas viven en
+ * memoria de solo lectura en lugar de construirse en cada instancia. RotorDeMapeo usa
+ * estas mismas tablas y reducir() para el alfabeto elegido con `--alfabeto`.
+ *
+ * No tiene memoria dinámica: se puede copiar y varios hilos pueden usar
+ * mapearConDesplazamiento() a la vez.
+ *
+ * @tparam Alfabeto Tipo que describe el alfabeto (ver Alfabetos.h).
+ */
+template <class Alfabeto = AlfabetoLatino>
+class RotorAlfabeto {
+public:
+    static constexpr int TAMANO_ALFABETO = Alfabeto::TAMANO; /**< @brief Cantidad de símbolos del rotor. */
+
+private:
+    using Tablas = TablasAlfabeto<Alfabeto>;
+
+    int desplazamiento; /**< @brief Índice absoluto del símbolo en la posición 'cero' (0..TAMANO_ALFABETO-1). */
+
+public:
+    /**
+     * @brief Constructor de RotorAlfabeto. Empieza sin rotación.
+     */
+    RotorAlfabeto() : desplazamiento(0) {}
+
+    /**
+     * @brief Reduce una rotación al rango 0..TAMANO_ALFABETO-1.
+     * @param n Rotación (negativa = hacia atrás).
+     * @return Los pasos hacia adelante equivalentes a `n`.
+     */
+    static int reducir(int n) {
+        int pasos = n % TAMANO_ALFABETO;
+        if (pasos < 0) {
+            pasos += TAMANO_ALFABETO;
+        }
+        return pasos;
+    }
+
+    /**
+     * @brief Rota el rotor N posiciones (negativo = hacia atrás), como RotorDeMapeo::rotar().
+     * @param n El número de posiciones a rotar y la dirección.
+     */
+    void rotar(int n) {
+        desplazamiento += reducir(n);
+        if (desplazamiento >= TAMANO_ALFABETO) {
+            desplazamiento -= TAMANO_ALFABETO;
+        }
+    }
+
+    /**
+     * @brief Mapea un carácter con la rotación actual.
+     * @param in El carácter de entrada.
+     * @return El carácter mapeado, o `in` si no pertenece al alfabeto.
+     */
+    char getMapeo(char in) const {
+        return mapearConDesplazamiento(in, desplazamiento);
+    }
+
+    /**
+     * @brief Obtiene la rotación actual del rotor.
+     * @return El índice absoluto (0..TAMANO_ALFABETO-1) del símbolo en la posición 'cero'.
+     */
+    int getDesplazamiento() const {
+        return desplazamiento;
+    }
+
+    /**
+     * @brief Mapea un carácter como si el rotor tuviera la rotación indicada.
+     * @param in El carácter de entrada.
+     * @param desplazamientoInicial Rotación a aplicar, en el rango 0..TAMANO_ALFABETO-1.
+     * @return El carácter que devolvería getMapeo() con esa rotación.
+     */
+    char mapearConDesplazamiento(char in, int desplazamientoInicial) const {
+        int indice = Tablas::INDICES.valor[(unsigned char)in];
+        if (indice < 0) {
+            return in;
+        }
+        return Tablas::SIMBOLOS.valor[indice + desplazamientoInicial];
+    }
+
+    /**
+     * @brief Mapea un bloque de caracteres con la rotación actual.
+     * @param in Caracteres de entrada.
+     * @param out Salida de `n` bytes; puede ser el mismo buffer que `in`.
+     * @param n Número de caracteres.
+     */
+    void mapearBloque(const char* in, char* out, size_t n) const {
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = mapearConDesplazamiento(in[i], desplazamiento);
+        }
+    }
+};
+
+/**
+ * @struct DescripcionAlfabeto
+ * @brief Tablas de un alfabeto elegido al ejecutar (apuntan a las de TablasAlfabeto).
+ */
+struct DescripcionAlfabeto {
+    const char* nombre;     /**< @brief Nombre para `--alfabeto` (p. ej. "latino"). */
+    int tamano;             /**< @brief Cantidad de símbolos. */
+    const int16_t* indices; /**< @brief Índice absoluto de cada byte, o -1 (256 entradas). */
+    const char* simbolos;   /**< @brief Símbolos repetidos dos veces (2 * tamano entradas). */
+};
+
+/**
+ * @brief Obtiene las tablas de un alfabeto.
+ * @param tipo El alfabeto.
+ * @return Descripción con vida estática.
+ */
+const DescripcionAlfabeto& describirAlfabeto(TipoAlfabeto tipo);
+
+/**
+ * @brief Interpreta el nombre de un alfabeto ("latino", "digitos", "imprimible" o "bytes").
+ * @param nombre Texto de la opción `--alfabeto`.
+ * @param tipo Recibe el alfabeto si el nombre es válido.
+ * @return `false` si el nombre no corresponde a ningún alfabeto (se informa por std::cerr).
+ */
+bool leerAlfabeto(const char* nombre, TipoAlfabeto* tipo);
+
+#endif // ROTOR_ALFABETO_H
@@ -4,13 +4,24 @@
  */
 
 #include "RotorDeMapeo.h"
-#include <cctype>   // Necesario para toupper
 
-RotorDeMapeo::RotorDeMapeo() : cabeza(nullptr) {
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define PRT7_ROTOR_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define PRT7_ROTOR_SSE2
+#endif
+
+RotorDeMapeo::RotorDeMapeo(TipoAlfabeto alfabeto)
+    : alfabeto(alfabeto), tamano(describirAlfabeto(alfabeto).tamano),
+      indiceAbsoluto(describirAlfabeto(alfabeto).indices), simbolos(describirAlfabeto(alfabeto).simbolos),
+      cabeza(nullptr), nodos(new NodoCircular*[tamano]), desplazamiento(0) {
     inicializarAlfabeto();
 }
 
 RotorDeMapeo::~RotorDeMapeo() {
+    delete[] nodos;
     if (cabeza == nullptr) {
         return;
     }
@@ -32,68 +43,194 @@ void RotorDeMapeo::inicializarAlfabeto() {
     }
 
     NodoCircular* current = nullptr;
-    NodoCircular* newNode = nullptr;
 
-    // Añadir A-Z
-    for (char c = 'A'; c <= 'Z'; ++c) {
-        newNode = new NodoCircular(c);
+    // Añadir los símbolos en el orden de su índice absoluto
+    for (int indice = 0; indice < tamano; ++indice) {
+        NodoCircular* newNode = new NodoCircular(simbolos[indice]);
         if (cabeza == nullptr) {
             cabeza = newNode;
             cabeza->siguiente = cabeza;
             cabeza->previo = cabeza;
-            current = cabeza;
         } else {
             current->siguiente = newNode;
             newNode->previo = current;
             newNode->siguiente = cabeza; // Enlazar de vuelta a la cabeza para cerrar el círculo
             cabeza->previo = newNode;   // Enlazar el previo de la cabeza al nuevo nodo
-            current = newNode;
         }
+        current = newNode;
+        nodos[indice] = newNode;
     }
 
-    // Añadir el espacio ' '
-    newNode = new NodoCircular(' ');
-    current->siguiente = newNode;
-    newNode->previo = current;
-    newNode->siguiente = cabeza;
-    cabeza->previo = newNode;
+    desplazamiento = 0;
 }
 
+int RotorDeMapeo::reducirRotacion(int n) const {
+    // El módulo es una constante en cada rama, así que no se compila como división
+    switch (alfabeto) {
+        case ALFABETO_DIGITOS:
+            return RotorAlfabeto<AlfabetoDigitos>::reducir(n);
+        case ALFABETO_IMPRIMIBLE:
+            return RotorAlfabeto<AlfabetoImprimible>::reducir(n);
+        case ALFABETO_BYTES:
+            return RotorAlfabeto<AlfabetoBytes>::reducir(n);
+        case ALFABETO_LATINO:
+        default:
+            return RotorAlfabeto<AlfabetoLatino>::reducir(n);
+    }
+}
 
 void RotorDeMapeo::rotar(int n) {
     if (cabeza == nullptr) {
         return;
     }
 
-    if (n > 0) {
-        for (int i = 0; i < n; ++i) {
-            cabeza = cabeza->siguiente; // Mover la cabeza hacia adelante (en sentido horario)
-        }
-    } else { // n <= 0
-        for (int i = 0; i > n; --i) { // Iterar abs(n) veces para n negativo
-            cabeza = cabeza->previo;    // Mover la cabeza hacia atrás (en sentido anti-horario)
-        }
+    // Reducir la rotación módulo el tamaño: girar una vuelta completa deja el rotor igual.
+    int pasos = reducirRotacion(n);
+    if (pasos == 0) {
+        return;
     }
+
+    desplazamiento += pasos;
+    if (desplazamiento >= tamano) {
+        desplazamiento -= tamano;
+    }
+    cabeza = nodos[desplazamiento];
+}
+
+int RotorDeMapeo::getTamano() const {
+    return tamano;
+}
+
+TipoAlfabeto RotorDeMapeo::getAlfabeto() const {
+    return alfabeto;
+}
+
+char RotorDeMapeo::getSimbolo(int indice) const {
+    return simbolos[indice];
 }
 
 char RotorDeMapeo::getMapeo(char in) {
     // Determinar el índice absoluto de 'in' en el alfabeto sin rotar (A=0, B=1, ..., ' '=26)
-    int absoluteIndex = -1;
-    char upperIn = toupper(in); // Convertir a mayúscula para la verificación A-Z
-
-    if (upperIn >= 'A' && upperIn <= 'Z') {
-        absoluteIndex = upperIn - 'A';
-    } else if (in == ' ') {
-        absoluteIndex = 26; // El espacio se considera después de 'Z'
-    } else {
+    int absoluteIndex = indiceAbsoluto[(unsigned char)in];
+    if (absoluteIndex < 0) {
         // Si el carácter no se encuentra en el alfabeto del rotor, devolverlo tal cual.
         return in;
     }
 
-    // Ahora, partiendo de la 'cabeza' actual, avanzar 'absoluteIndex' pasos
-    NodoCircular* temp = cabeza;
+    // Los símbolos están repetidos: equivale a avanzar 'absoluteIndex' pasos desde la 'cabeza'
+    return simbolos[absoluteIndex + desplazamiento]; // Este es el carácter mapeado
+}
+
+char RotorDeMapeo::getMapeoRecorrido(char in) const {
+    int absoluteIndex = indiceAbsoluto[(unsigned char)in];
+    if (absoluteIndex < 0 || cabeza == nullptr) {
+        return in;
+    }
+
+    // Avanzar 'absoluteIndex' pasos desde la 'cabeza' actual
+    const NodoCircular* actual = cabeza;
     for (int i = 0; i < absoluteIndex; ++i) {
-        temp = temp->siguiente;
+        actual = actual->siguiente;
+    }
+    return actual->dato;
+}
+
+int RotorDeMapeo::getDesplazamiento() const {
+    return desplazamiento;
+}
+
+char RotorDeMapeo::mapearConDesplazamiento(char in, int desplazamientoInicial) const {
+    int absoluteIndex = indiceAbsoluto[(unsigned char)in];
+    if (absoluteIndex < 0) {
+        return in;
+    }
+    return simbolos[absoluteIndex + desplazamientoInicial];
+}
+
+#if defined(PRT7_ROTOR_AVX2)
+/**
+ * @brief Mapea 32 bytes con la rotación `d` (equivale a getMapeo() con reglas ASCII).
+ */
+static inline __m256i mapearVector(__m256i v, __m256i d) {
+    // Índice de letra: (v | 0x20) - 'a', válido si es menor que 26 (sin signo)
+    __m256i letra = _mm256_sub_epi8(_mm256_or_si256(v, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+    __m256i esLetra = _mm256_cmpeq_epi8(_mm256_min_epu8(letra, _mm256_set1_epi8(25)), letra);
+    __m256i esEspacio = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(' '));
+    __m256i indice = _mm256_blendv_epi8(_mm256_set1_epi8(26), letra, esLetra);
+
+    // (indice + d) % 27: si la suma pasa de 26, restar 27 da un valor menor que la suma
+    __m256i suma = _mm256_add_epi8(indice, d);
+    suma = _mm256_min_epu8(suma, _mm256_sub_epi8(suma, _mm256_set1_epi8(27)));
+
+    __m256i esSalidaEspacio = _mm256_cmpeq_epi8(suma, _mm256_set1_epi8(26));
+    __m256i mapeado = _mm256_blendv_epi8(_mm256_add_epi8(suma, _mm256_set1_epi8('A')), _mm256_set1_epi8(' '), esSalidaEspacio);
+    return _mm256_blendv_epi8(v, mapeado, _mm256_or_si256(esLetra, esEspacio));
+}
+#elif defined(PRT7_ROTOR_SSE2)
+/**
+ * @brief Elige `b` donde la máscara está encendida y `a` en el resto (SSE2 no tiene blendv).
+ */
+static inline __m128i elegir(__m128i a, __m128i b, __m128i mascara) {
+    return _mm_or_si128(_mm_andnot_si128(mascara, a), _mm_and_si128(mascara, b));
+}
+
+/**
+ * @brief Mapea 16 bytes con la rotación `d` (equivale a getMapeo() con reglas ASCII).
+ */
+static inline __m128i mapearVector(__m128i v, __m128i d) {
+    // Índice de letra: (v | 0x20) - 'a', válido si es menor que 26 (sin signo)
+    __m128i letra = _mm_sub_epi8(_mm_or_si128(v, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    __m128i esLetra = _mm_cmpeq_epi8(_mm_min_epu8(letra, _mm_set1_epi8(25)), letra);
+    __m128i esEspacio = _mm_cmpeq_epi8(v, _mm_set1_epi8(' '));
+    __m128i indice = elegir(_mm_set1_epi8(26), letra, esLetra);
+
+    // (indice + d) % 27: si la suma pasa de 26, restar 27 da un valor menor que la suma
+    __m128i suma = _mm_add_epi8(indice, d);
+    suma = _mm_min_epu8(suma, _mm_sub_epi8(suma, _mm_set1_epi8(27)));
+
+    __m128i esSalidaEspacio = _mm_cmpeq_epi8(suma, _mm_set1_epi8(26));
+    __m128i mapeado = elegir(_mm_add_epi8(suma, _mm_set1_epi8('A')), _mm_set1_epi8(' '), esSalidaEspacio);
+    return elegir(v, mapeado, _mm_or_si128(esLetra, esEspacio));
+}
+#endif
+
+void RotorDeMapeo::mapearBloque(const char* in, char* out, size_t n) const {
+    size_t i = 0;
+    // Las versiones vectoriales solo conocen el alfabeto latino
+    if (alfabeto == ALFABETO_LATINO) {
+#if defined(PRT7_ROTOR_AVX2)
+        const __m256i d = _mm256_set1_epi8((char)desplazamiento);
+        for (; i + 32 <= n; i += 32) {
+            __m256i v = _mm256_loadu_si256((const __m256i*)(in + i));
+            _mm256_storeu_si256((__m256i*)(out + i), mapearVector(v, d));
+        }
+#elif defined(PRT7_ROTOR_SSE2)
+        const __m128i d = _mm_set1_epi8((char)desplazamiento);
+        for (; i + 16 <= n; i += 16) {
+            __m128i v = _mm_loadu_si128((const __m128i*)(in + i));
+            _mm_storeu_si128((__m128i*)(out + i), mapearVector(v, d));
+        }
+#endif
     }
-    return temp->dato; // Este es el carácter mapeado
-}
\ No newline at end of file
+
+    // Versión escalar (también para los últimos bytes); no prepara tablas para que
+    // las rachas cortas no paguen más que getMapeo()
+    for (; i < n; ++i) {
+        int indice = indiceAbsoluto[(unsigned char)in[i]];
+        if (indice < 0) {
+            out[i] = in[i];
+        } else {
+            out[i] = simbolos[indice + desplazamiento];
+        }
+    }
+}
+
+const char* implementacionRotor() {
+#if defined(PRT7_ROTOR_AVX2)
+    return "AVX2";
+#elif defined(PRT7_ROTOR_SSE2)
+    return "SSE2";
+#else
+    return "escalar";
+#endif
+}
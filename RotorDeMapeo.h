@@ -6,6 +6,9 @@
 #ifndef ROTOR_DE_MAPEO_H
 #define ROTOR_DE_MAPEO_H
 
+#include <cstddef>
+#include "RotorAlfabeto.h"
+
 /**
  * @struct NodoCircular
  * @brief Estructura de nodo para la lista circular doblemente enlazada.
@@ -27,19 +30,39 @@ struct NodoCircular {
  * @brief Implementación manual de una lista circular doblemente enlazada que actúa
  *        como un "disco de cifrado" o "RotorDeMapeo".
  *
- * Contiene el alfabeto (A-Z y espacio) y puede rotar, cambiando el mapeo
- * de los caracteres. El puntero `cabeza` indica la posición 'cero' actual.
+ * Contiene un alfabeto (por omisión A-Z y espacio, ver Alfabetos.h) y puede rotar, cambiando
+ * el mapeo de los caracteres. El puntero `cabeza` indica la posición 'cero' actual.
+ *
+ * La lista es el modelo del enunciado (ver README): rotar() deja `cabeza` en el nodo
+ * de la rotación actual y getMapeoRecorrido() mapea avanzando por ella, un nodo por
+ * paso. Es la referencia contra la que se comprueban las tablas (prt7_bench).
+ *
+ * El camino rápido no recorre la lista: getMapeo(), mapearConDesplazamiento() y
+ * mapearBloque() leen las tablas generadas al compilar para el alfabeto
+ * (TablasAlfabeto) y rotar() reduce con RotorAlfabeto::reducir(), así que con el
+ * alfabeto latino se comporta exactamente como `RotorAlfabeto<AlfabetoLatino>`.
+ * La lista cuesta un nodo por símbolo (256 con ALFABETO_BYTES), solo al construir.
  */
 class RotorDeMapeo {
+public:
+    static const int TAMANO_ALFABETO = AlfabetoLatino::TAMANO; /**< @brief Símbolos del alfabeto por omisión (A-Z y espacio), el único de la pila, el índice y los puntos de control. */
+
 private:
+    TipoAlfabeto alfabeto; /**< @brief Alfabeto del rotor. */
+    int tamano; /**< @brief Cantidad de símbolos del alfabeto. */
+    const int16_t* indiceAbsoluto; /**< @brief Índice absoluto de cada byte de entrada, o -1 si no pertenece al alfabeto. */
+    const char* simbolos; /**< @brief Símbolos del alfabeto repetidos dos veces (ver TablasAlfabeto). */
     NodoCircular* cabeza; /**< @brief Puntero a la 'cabeza' de la lista, que indica la posición 'cero' actual. */
+    NodoCircular** nodos; /**< @brief Acceso directo a cada nodo por su índice absoluto (p. ej. A=0, ..., ' '=26). */
+    int desplazamiento; /**< @brief Índice absoluto del nodo al que apunta `cabeza` (0..tamano-1). */
 
 public:
     /**
      * @brief Constructor de RotorDeMapeo.
-     * Inicializa la lista y carga el alfabeto (A-Z y espacio).
+     * Inicializa la lista y carga el alfabeto.
+     * @param alfabeto El alfabeto del rotor (por omisión A-Z y espacio).
      */
-    RotorDeMapeo();
+    explicit RotorDeMapeo(TipoAlfabeto alfabeto = ALFABETO_LATINO);
 
     /**
      * @brief Destructor de RotorDeMapeo.
@@ -47,8 +70,11 @@ public:
      */
     ~RotorDeMapeo();
 
+    RotorDeMapeo(const RotorDeMapeo&) = delete;
+    RotorDeMapeo& operator=(const RotorDeMapeo&) = delete;
+
     /**
-     * @brief Inicializa la lista circular con los caracteres del alfabeto (A-Z) y el espacio.
+     * @brief Inicializa la lista circular con los símbolos del alfabeto.
      * Se llama automáticamente desde el constructor.
      */
     void inicializarAlfabeto();
@@ -59,10 +85,43 @@ public:
      * Una rotación positiva (N > 0) mueve la cabeza hacia adelante (siguiente).
      * Una rotación negativa (N < 0) mueve la cabeza hacia atrás (previo).
      *
+     * La rotación se reduce primero módulo el tamaño del alfabeto (ver reducirRotacion()),
+     * por lo que el costo es constante sin importar la magnitud de `n` (p. ej. `M,2000000000`).
+     *
      * @param n El número de posiciones a rotar y la dirección.
      */
     void rotar(int n);
 
+    /**
+     * @brief Reduce una rotación al rango 0..getTamano()-1.
+     *
+     * Usa RotorAlfabeto::reducir() del alfabeto del rotor, cuyo módulo es una constante
+     * al compilar.
+     *
+     * @param n Rotación (negativa = hacia atrás).
+     * @return Los pasos hacia adelante equivalentes a `n`.
+     */
+    int reducirRotacion(int n) const;
+
+    /**
+     * @brief Obtiene la cantidad de símbolos del alfabeto del rotor.
+     * @return 27 con el alfabeto latino.
+     */
+    int getTamano() const;
+
+    /**
+     * @brief Obtiene el alfabeto del rotor.
+     * @return El alfabeto elegido al construirlo.
+     */
+    TipoAlfabeto getAlfabeto() const;
+
+    /**
+     * @brief Obtiene el símbolo de un índice absoluto.
+     * @param indice Índice en 0..getTamano()-1.
+     * @return El símbolo (p. ej. 'A' para el índice 0 del alfabeto latino).
+     */
+    char getSimbolo(int indice) const;
+
     /**
      * @brief Realiza el mapeo de un carácter de entrada según la rotación actual del rotor.
      *
@@ -70,11 +129,64 @@ public:
      * Luego, avanza ese mismo número de pasos desde la `cabeza` actual del rotor para encontrar
      * el carácter mapeado.
      *
+     * El resultado equivale a recorrer la lista circular, pero se obtiene en tiempo
+     * constante de la tabla de símbolos repetidos del alfabeto.
+     *
      * @param in El carácter de entrada a mapear.
      * @return El carácter mapeado según la configuración actual del rotor.
      *         Si el carácter no se encuentra en el alfabeto del rotor, se devuelve el carácter original.
      */
     char getMapeo(char in);
+
+    /**
+     * @brief Mapea un carácter recorriendo la lista circular, como lo describe el enunciado.
+     *
+     * Avanza desde la `cabeza` tantos nodos como el índice absoluto de `in` y devuelve
+     * el símbolo de ese nodo. Da el mismo resultado que getMapeo(), pero en tiempo
+     * proporcional al tamaño del alfabeto: sirve para comprobar las tablas.
+     *
+     * @param in El carácter de entrada a mapear.
+     * @return El carácter mapeado, o `in` si no pertenece al alfabeto.
+     */
+    char getMapeoRecorrido(char in) const;
+
+    /**
+     * @brief Obtiene la rotación actual del rotor.
+     * @return El índice absoluto (0..getTamano()-1) del carácter en la `cabeza`.
+     */
+    int getDesplazamiento() const;
+
+    /**
+     * @brief Mapea un carácter como si el rotor tuviera la rotación indicada.
+     *
+     * No modifica el estado del rotor, por lo que varios hilos pueden usarlo a la vez
+     * (p. ej. en la decodificación por lotes, donde cada fragmento conoce su rotación).
+     *
+     * @param in El carácter de entrada a mapear.
+     * @param desplazamientoInicial Rotación a aplicar, en el rango 0..getTamano()-1.
+     * @return El carácter que devolvería getMapeo() con esa rotación.
+     */
+    char mapearConDesplazamiento(char in, int desplazamientoInicial) const;
+
+    /**
+     * @brief Mapea un bloque de caracteres con la rotación actual.
+     *
+     * Equivale a `out[i] = getMapeo(in[i])` para cada i, incluidas las minúsculas
+     * y los bytes fuera del alfabeto (se copian tal cual). Con el alfabeto latino
+     * procesa 16 o 32 bytes por instrucción con SSE2/AVX2 cuando el compilador los
+     * habilita. No modifica el rotor.
+     *
+     * @param in Caracteres de entrada.
+     * @param out Salida de `n` bytes; puede ser el mismo buffer que `in`.
+     * @param n Número de caracteres.
+     */
+    void mapearBloque(const char* in, char* out, size_t n) const;
 };
 
+/**
+ * @brief Indica qué implementación usa RotorDeMapeo::mapearBloque().
+ * @return "AVX2", "SSE2" o "escalar".
+ */
+const char* implementacionRotor();
+
 #endif // ROTOR_DE_MAPEO_H
\ No newline at end of file
@@ -0,0 +1,292 @@
+/**
+ * @file SalidaTramas.cpp
+ * @brief Implementación de los destinos de la salida por trama.
+ */
+
+#include "SalidaTramas.h"
+#include "ParserTramas.h"
+#include <cstdint>
+#include <cstring>  // Para strchr, strncmp, memcpy
+#include <iostream>
+
+/**
+ * @brief Identificador al inicio de todo archivo en formato binario.
+ */
+static const char FIRMA_SALIDA[8] = {'P', 'R', 'T', '7', '-', 'S', 'A', 'L'};
+
+/**
+ * @brief Versión del formato binario.
+ */
+static const uint32_t VERSION_SALIDA = 1;
+
+/**
+ * @brief Bytes que ocupa como máximo un registro JSONL (cada carácter de la línea
+ *        escapado como `\u00XX` más los campos fijos).
+ */
+static const size_t LONGITUD_MAXIMA_JSONL = 6 * LONGITUD_MAXIMA_LINEA + 160;
+
+/**
+ * @brief Nombres de los formatos en `--salida`, en el orden de FormatoSalida.
+ */
+static const char* const NOMBRES_FORMATO[] = {"consola", "jsonl", "binario"};
+
+/**
+ * @brief Nombres de los tipos de línea en JSONL, en el orden de TipoResultado.
+ */
+static const char* const NOMBRES_RESULTADO[] = {"info", "invalida", "carga", "mapa"};
+
+/**
+ * @brief Escribe un entero en little-endian.
+ */
+static void escribirEntero(unsigned char* destino, uint64_t valor, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        destino[i] = (unsigned char)(valor >> (8 * i));
+    }
+}
+
+/**
+ * @brief Escribe un entero en decimal.
+ * @return Posición siguiente al último dígito.
+ */
+static char* escribirDecimal(char* destino, long long valor) {
+    unsigned long long magnitud = valor < 0 ? 0ULL - (unsigned long long)valor : (unsigned long long)valor;
+    if (valor < 0) {
+        *destino++ = '-';
+    }
+    char digitos[20];
+    int n = 0;
+    do {
+        digitos[n++] = (char)('0' + magnitud % 10);
+        magnitud /= 10;
+    } while (magnitud != 0);
+    while (n > 0) {
+        *destino++ = digitos[--n];
+    }
+    return destino;
+}
+
+/**
+ * @brief Copia un texto al final de un buffer.
+ * @return Posición siguiente al texto copiado.
+ */
+static char* escribirTexto(char* destino, const char* texto) {
+    while (*texto != '\0') {
+        *destino++ = *texto++;
+    }
+    return destino;
+}
+
+/**
+ * @brief Escribe una cadena JSON escapando comillas, barras y bytes no imprimibles.
+ * @return Posición siguiente a la comilla de cierre.
+ */
+static char* escribirTextoJson(char* destino, const char* texto, size_t longitud) {
+    static const char HEXADECIMAL[] = "0123456789abcdef";
+    *destino++ = '"';
+    for (size_t i = 0; i < longitud; ++i) {
+        unsigned char c = (unsigned char)texto[i];
+        if (c == '"' || c == '\\') {
+            *destino++ = '\\';
+            *destino++ = (char)c;
+        } else if (c < 0x20 || c >= 0x7F) {
+            destino = escribirTexto(destino, "\\u00"); // Bytes de ruido: válidos en JSON aunque no sean UTF-8
+            *destino++ = HEXADECIMAL[c >> 4];
+            *destino++ = HEXADECIMAL[c & 0xF];
+        } else {
+            *destino++ = (char)c;
+        }
+    }
+    *destino++ = '"';
+    return destino;
+}
+
+/**
+ * @brief Visitante que copia un bloque del mensaje a un EscritorAsincrono.
+ */
+static void escribirBloque(const char* datos, size_t cantidad, void* contexto) {
+    static_cast<EscritorAsincrono*>(contexto)->escribir(datos, cantidad);
+}
+
+SalidaTramas::SalidaTramas(ModoSalida modo, bool descartarSiLleno)
+    : numDestinos(0), modo(modo), descartarSiLleno(descartarSiLleno), conTiempo(false),
+      inicio(std::chrono::steady_clock::now()) {}
+
+bool SalidaTramas::leerEspecificacion(const char* especificacion, FormatoSalida* formato, const char** ruta) {
+    const char* separador = strchr(especificacion, ':');
+    size_t longitud = separador != nullptr ? (size_t)(separador - especificacion) : strlen(especificacion);
+    for (int f = FORMATO_CONSOLA; f <= FORMATO_BINARIO; ++f) {
+        if (strlen(NOMBRES_FORMATO[f]) == longitud && strncmp(especificacion, NOMBRES_FORMATO[f], longitud) == 0) {
+            *formato = (FormatoSalida)f;
+            *ruta = separador != nullptr && separador[1] != '\0' ? separador + 1 : "-";
+            return true;
+        }
+    }
+    return false;
+}
+
+bool SalidaTramas::agregar(FormatoSalida formato, const char* ruta) {
+    if (numDestinos == MAXIMO_DESTINOS) {
+        std::cerr << "Demasiados destinos de salida (máximo " << MAXIMO_DESTINOS << ")." << std::endl;
+        return false;
+    }
+    if (numDestinos == 0 && !errores.abrirDescriptor(2, descartarSiLleno)) {
+        return false;
+    }
+    DestinoSalida* destino = &destinos[numDestinos];
+    if (!destino->escritor.abrir(ruta, descartarSiLleno)) {
+        return false;
+    }
+    destino->formato = formato;
+    destino->ruta = ruta;
+    numDestinos++;
+
+    if (formato == FORMATO_BINARIO) {
+        unsigned char encabezado[TAMANO_ENCABEZADO_SALIDA];
+        memcpy(encabezado, FIRMA_SALIDA, sizeof(FIRMA_SALIDA));
+        escribirEntero(encabezado + 8, VERSION_SALIDA, 4);
+        escribirEntero(encabezado + 12, TAMANO_REGISTRO_SALIDA, 4);
+        destino->escritor.escribir((const char*)encabezado, TAMANO_ENCABEZADO_SALIDA);
+    }
+    if (formato != FORMATO_CONSOLA) {
+        conTiempo = true;
+    }
+    return true;
+}
+
+bool SalidaTramas::activa() const {
+    return numDestinos > 0;
+}
+
+void SalidaTramas::escribirConsola(EscritorAsincrono* escritor, const VistaLinea& linea, const ResultadoLinea& resultado,
+                                   ListaDeCarga* mensaje) {
+    if (resultado.tipo == RESULTADO_INFO) {
+        if (!escritor->comenzarRegistro(LONGITUD_MAXIMA_LINEA + 32)) {
+            return;
+        }
+        escritor->escribir("[INFO Arduino]: ", 16);
+        escritor->escribir(linea.datos, linea.longitud);
+        escritor->escribir("\n", 1);
+        return;
+    }
+
+    // Cota del registro: el mensaje completo o, en modo incremental, lo que aún no se escribió
+    size_t maximo = LONGITUD_MAXIMA_LINEA + LONGITUD_MAXIMA_DETALLE + 64 +
+                    (modo == SALIDA_INCREMENTAL ? mensaje->getLongitudNuevos() : mensaje->getLongitud());
+    if (!escritor->comenzarRegistro(maximo)) {
+        return;
+    }
+    escritor->escribir("Trama recibida: [", 17);
+    escritor->escribir(linea.datos, linea.longitud);
+    escritor->escribir("] -> Procesando... -> ", 22);
+    if (resultado.tipo == RESULTADO_INVALIDA) {
+        return; // Como en consola: el error va a std::cerr y la línea queda abierta
+    }
+
+    char detalle[LONGITUD_MAXIMA_DETALLE];
+    escritor->escribir(detalle, formatearDetalle(resultado, detalle));
+    if (modo == SALIDA_INCREMENTAL) {
+        escritor->escribir("Mensaje += [", 12);
+        mensaje->recorrerNuevos(escribirBloque, escritor);
+    } else {
+        escritor->escribir("Mensaje: [", 10);
+        mensaje->recorrerBloques(escribirBloque, escritor);
+    }
+    escritor->escribir("]\n", 2);
+}
+
+void SalidaTramas::registrar(unsigned long trama, const VistaLinea& linea, const ResultadoLinea& resultado,
+                             ListaDeCarga* mensaje) {
+    if (resultado.tipo == RESULTADO_INVALIDA && errores.comenzarRegistro(LONGITUD_MAXIMA_LINEA + 40)) {
+        errores.escribir("Error: No se pudo parsear la trama: ", 36);
+        errores.escribir(linea.datos, linea.longitud);
+        errores.escribir("\n", 1);
+    }
+    long long microsegundos = 0;
+    if (conTiempo) {
+        microsegundos = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - inicio).count();
+    }
+
+    for (int d = 0; d < numDestinos; ++d) {
+        EscritorAsincrono* escritor = &destinos[d].escritor;
+        if (destinos[d].formato == FORMATO_CONSOLA) {
+            escribirConsola(escritor, linea, resultado, mensaje);
+        } else if (destinos[d].formato == FORMATO_JSONL) {
+            if (!escritor->comenzarRegistro(LONGITUD_MAXIMA_JSONL)) {
+                continue;
+            }
+            char registro[LONGITUD_MAXIMA_JSONL];
+            char* p = escribirTexto(registro, "{\"trama\":");
+            p = escribirDecimal(p, (long long)trama);
+            p = escribirTexto(p, ",\"t_us\":");
+            p = escribirDecimal(p, microsegundos);
+            p = escribirTexto(p, ",\"tipo\":\"");
+            p = escribirTexto(p, NOMBRES_RESULTADO[resultado.tipo]);
+            *p++ = '"';
+            if (resultado.tipo == RESULTADO_CARGA) {
+                p = escribirTexto(p, ",\"original\":");
+                p = escribirTextoJson(p, &resultado.original, 1);
+                p = escribirTexto(p, ",\"decodificado\":");
+                p = escribirTextoJson(p, &resultado.decodificado, 1);
+                p = escribirTexto(p, ",\"rotacion\":");
+                p = escribirDecimal(p, resultado.rotacion);
+            } else if (resultado.tipo == RESULTADO_MAPA) {
+                p = escribirTexto(p, ",\"rotacion\":");
+                p = escribirDecimal(p, resultado.rotacion);
+                p = escribirTexto(p, ",\"rotor\":");
+                p = escribirDecimal(p, resultado.rotor);
+            } else {
+                p = escribirTexto(p, ",\"linea\":");
+                p = escribirTextoJson(p, linea.datos, linea.longitud);
+            }
+            p = escribirTexto(p, "}\n");
+            escritor->escribir(registro, (size_t)(p - registro));
+        } else {
+            if (!escritor->comenzarRegistro(TAMANO_REGISTRO_SALIDA)) {
+                continue;
+            }
+            unsigned char registro[TAMANO_REGISTRO_SALIDA];
+            escribirEntero(registro, trama, 8);
+            escribirEntero(registro + 8, (uint64_t)microsegundos, 8);
+            escribirEntero(registro + 16, (uint32_t)resultado.rotacion, 4);
+            registro[20] = (unsigned char)resultado.tipo;
+            registro[21] = (unsigned char)resultado.original;
+            registro[22] = (unsigned char)resultado.decodificado;
+            registro[23] = (unsigned char)resultado.rotor;
+            escritor->escribir((const char*)registro, TAMANO_REGISTRO_SALIDA);
+        }
+    }
+}
+
+void SalidaTramas::vaciar() {
+    for (int d = 0; d < numDestinos; ++d) {
+        destinos[d].escritor.vaciar();
+    }
+    errores.vaciar();
+}
+
+void SalidaTramas::cerrar() {
+    for (int d = 0; d < numDestinos; ++d) {
+        destinos[d].escritor.cerrar();
+    }
+    errores.cerrar();
+}
+
+void SalidaTramas::imprimirResumen() const {
+    for (int d = 0; d < numDestinos; ++d) {
+        const EscritorAsincrono& escritor = destinos[d].escritor;
+        std::cout << "Salida " << NOMBRES_FORMATO[destinos[d].formato] << " (" << destinos[d].ruta << "): "
+                  << escritor.getBytesEscritos() << " bytes en " << escritor.getEscrituras() << " escrituras";
+        if (descartarSiLleno) {
+            std::cout << ", " << escritor.getDescartados() << " registros descartados";
+        }
+        std::cout << "." << std::endl;
+    }
+    if (numDestinos > 0 && (errores.getBytesEscritos() > 0 || errores.getDescartados() > 0)) {
+        std::cout << "Errores de parseo (error estándar): " << errores.getBytesEscritos() << " bytes";
+        if (descartarSiLleno) {
+            std::cout << ", " << errores.getDescartados() << " mensajes descartados";
+        }
+        std::cout << "." << std::endl;
+    }
+}
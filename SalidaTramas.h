@@ -0,0 +1,146 @@
+/**
+ * @file SalidaTramas.h
+ * @brief Define los destinos de la salida por trama (`--salida`) y sus formatos.
+ */
+
+#ifndef SALIDA_TRAMAS_H
+#define SALIDA_TRAMAS_H
+
+#include <chrono>
+#include "EscritorAsincrono.h"
+#include "FuenteTramas.h"
+#include "ListaDeCarga.h"
+#include "ProcesadorLineas.h"
+
+/**
+ * @enum FormatoSalida
+ * @brief Cómo se escribe cada trama en un destino.
+ */
+enum FormatoSalida {
+    FORMATO_CONSOLA, /**< @brief El texto de mostrarResultado() (completo o incremental). */
+    FORMATO_JSONL,   /**< @brief Un objeto JSON por línea con la trama, el tiempo y los caracteres. */
+    FORMATO_BINARIO  /**< @brief Registros de TAMANO_REGISTRO_SALIDA bytes tras un encabezado. */
+};
+
+/**
+ * @brief Tamaño del encabezado del formato binario.
+ *
+ * Firma `PRT7-SAL` (8 bytes), versión (uint32) y tamaño de registro (uint32),
+ * todo en little-endian.
+ */
+const size_t TAMANO_ENCABEZADO_SALIDA = 16;
+
+/**
+ * @brief Tamaño de un registro del formato binario.
+ *
+ * | Bytes | Campo |
+ * | :---  | :---  |
+ * | 0-7   | Número de trama (uint64) |
+ * | 8-15  | Microsegundos desde que se abrió la salida (uint64) |
+ * | 16-19 | Rotación recibida (MAP) o desplazamiento del rotor al decodificar (LOAD) (int32) |
+ * | 20    | TipoResultado |
+ * | 21    | Carácter recibido (LOAD) |
+ * | 22    | Carácter decodificado (LOAD) |
+ * | 23    | Rotor girado (MAP con `--rotores`) |
+ */
+const size_t TAMANO_REGISTRO_SALIDA = 24;
+
+/**
+ * @class SalidaTramas
+ * @brief Escribe cada trama procesada en uno o varios destinos, sin esperar a la E/S.
+ *
+ * Cada destino tiene su EscritorAsincrono: el hilo que llama a registrar() solo
+ * formatea y copia a memoria; la escritura la hace el hilo del escritor. Los errores
+ * de parseo van al error estándar por otro EscritorAsincrono, así que tampoco esperan
+ * a la E/S, pero ya no quedan intercalados en orden con un destino en consola.
+ */
+class SalidaTramas {
+public:
+    static const int MAXIMO_DESTINOS = 4; /**< @brief Destinos de `--salida` admitidos. */
+
+private:
+    /**
+     * @struct DestinoSalida
+     * @brief Un destino abierto.
+     */
+    struct DestinoSalida {
+        FormatoSalida formato;       /**< @brief Formato de los registros. */
+        const char* ruta;            /**< @brief Archivo ("-" = salida estándar). */
+        EscritorAsincrono escritor;  /**< @brief Buffers y hilo de escritura. */
+    };
+
+    DestinoSalida destinos[MAXIMO_DESTINOS]; /**< @brief Destinos abiertos. */
+    int numDestinos;                         /**< @brief Número de destinos en `destinos`. */
+    EscritorAsincrono errores;               /**< @brief Mensajes de error de parseo (error estándar). */
+    ModoSalida modo;                         /**< @brief Completo o incremental, para FORMATO_CONSOLA. */
+    bool descartarSiLleno;                   /**< @brief Omitir registros en lugar de esperar a la E/S. */
+    bool conTiempo;                          /**< @brief Algún destino guarda la marca de tiempo. */
+    std::chrono::steady_clock::time_point inicio; /**< @brief Tiempo 0 de las marcas. */
+
+    /**
+     * @brief Escribe una trama en formato de consola.
+     */
+    void escribirConsola(EscritorAsincrono* escritor, const VistaLinea& linea, const ResultadoLinea& resultado,
+                         ListaDeCarga* mensaje);
+
+public:
+    /**
+     * @brief Constructor de SalidaTramas. Empieza sin destinos.
+     * @param modo SALIDA_COMPLETA o SALIDA_INCREMENTAL (para FORMATO_CONSOLA).
+     * @param descartarSiLleno `true` para omitir registros cuando los buffers de un destino están llenos.
+     */
+    SalidaTramas(ModoSalida modo, bool descartarSiLleno);
+
+    SalidaTramas(const SalidaTramas&) = delete;
+    SalidaTramas& operator=(const SalidaTramas&) = delete;
+
+    /**
+     * @brief Interpreta el argumento de `--salida`: `<formato>[:<ruta>]`.
+     * @param especificacion Texto del argumento; sin ruta se usa la salida estándar.
+     * @param formato Salida: formato elegido.
+     * @param ruta Salida: archivo ("-" = salida estándar); apunta dentro de `especificacion`.
+     * @return `false` si el formato no es `consola`, `jsonl` ni `binario`.
+     */
+    static bool leerEspecificacion(const char* especificacion, FormatoSalida* formato, const char** ruta);
+
+    /**
+     * @brief Abre un destino.
+     * @param formato Formato de los registros.
+     * @param ruta Archivo ("-" = salida estándar); debe vivir tanto como el objeto.
+     * @return `true` si el destino quedó abierto.
+     */
+    bool agregar(FormatoSalida formato, const char* ruta);
+
+    /**
+     * @brief Indica si hay algún destino abierto.
+     * @return `true` si la salida por trama va a los destinos y no a `std::cout`.
+     */
+    bool activa() const;
+
+    /**
+     * @brief Escribe una línea ya procesada en todos los destinos.
+     * @param trama Número de la línea (desde 1).
+     * @param linea Línea recibida.
+     * @param resultado Resultado de procesarLinea().
+     * @param mensaje Mensaje ensamblado hasta esta línea (incluida).
+     */
+    void registrar(unsigned long trama, const VistaLinea& linea, const ResultadoLinea& resultado, ListaDeCarga* mensaje);
+
+    /**
+     * @brief Entrega a los hilos de escritura lo acumulado (p. ej. mientras no llegan datos).
+     */
+    void vaciar();
+
+    /**
+     * @brief Escribe todo lo pendiente y cierra los destinos.
+     */
+    void cerrar();
+
+    /**
+     * @brief Muestra por destino (y para los errores) los bytes, las escrituras y los registros descartados.
+     * @details Llamar después de cerrar().
+     */
+    void imprimirResumen() const;
+};
+
+#endif // SALIDA_TRAMAS_H
@@ -4,12 +4,20 @@
  */
 
 #include "SerialPort.h"
+#include "ContadorAsignaciones.h"
+#include "Metricas.h"
+#include "Traza.h"
+#include "ParserTramas.h"
 #include <iostream>
-#include <cstdlib>  // Para malloc, free
-#include <cstring>  // Para memset
+#include <chrono>
+#include <cstdio>   // Para snprintf
+#include <cstdlib>  // Para malloc, free, atoi
+#include <cstring>  // Para memset, memmove
 
 #ifndef _WIN32
     #include <fcntl.h>  // Para flags de apertura de archivo
+    #include <poll.h>   // Para poll
+    #include <cerrno>
 #endif
 
 /**
@@ -38,20 +46,61 @@ static char* manual_strcpy(char* dest, const char* src) {
     return original_dest;
 }
 
-SerialPort::SerialPort() : connected(false), bufferPos(0) {
+SerialPort::SerialPort() : modoEventos(true), colgado(false), connected(false), bufferPos(0), bufferLen(0), lecturas(0), bytesLeidos(0),
+                           posGuardada(-1), caracterGuardado('\0'), modoBinario(false), asciiPendiente(false), posicionRacha(0),
+                           tramasBinarias(0), descartesBinarios(0) {
 #ifdef _WIN32
     hSerial = INVALID_HANDLE_VALUE;
 #else
     fd = -1;
+    despertador[0] = -1;
+    despertador[1] = -1;
 #endif
     memset(readBuffer, 0, sizeof(readBuffer));
+    memset(&tramaActual, 0, sizeof(tramaActual));
+    lineaBinaria[0] = '\0';
 }
 
+#ifndef _WIN32
+/**
+ * @brief Convierte una velocidad en baudios a la constante de termios.
+ * @return La constante, o B0 si el sistema no la admite.
+ */
+static speed_t velocidadTermios(int baudRate) {
+    switch (baudRate) {
+        case 9600: return B9600;
+        case 19200: return B19200;
+        case 38400: return B38400;
+        case 57600: return B57600;
+        case 115200: return B115200;
+#ifdef B230400
+        case 230400: return B230400;
+#endif
+#ifdef B460800
+        case 460800: return B460800;
+#endif
+#ifdef B500000
+        case 500000: return B500000;
+#endif
+#ifdef B921600
+        case 921600: return B921600;
+#endif
+#ifdef B1000000
+        case 1000000: return B1000000;
+#endif
+#ifdef B2000000
+        case 2000000: return B2000000;
+#endif
+        default: return B0;
+    }
+}
+#endif
+
 SerialPort::~SerialPort() {
     close();
 }
 
-bool SerialPort::open(const char* portName, int baudRate) {
+bool SerialPort::open(const char* portName, int baudRate, bool esperarReinicio) {
     if (connected) {
         return true; // Ya está conectado
     }
@@ -129,7 +178,11 @@ bool SerialPort::open(const char* portName, int baudRate) {
     std::cout << "Conexión establecida con " << portName << " a " << baudRate << " baudios." << std::endl;
 
     // Esperar a que el Arduino se reinicie (los Arduino se reinician al abrir el puerto)
-    Sleep(2000);
+    if (esperarReinicio) {
+        uint64_t inicioEspera = comenzarIntervalo();
+        Sleep(2000);
+        terminarIntervalo(TRAZA_ESPERA, inicioEspera, 2000, "reinicio", 8);
+    }
 
     return true;
 
@@ -154,14 +207,9 @@ bool SerialPort::open(const char* portName, int baudRate) {
     }
 
     // Configurar velocidad
-    speed_t speed;
-    switch(baudRate) {
-        case 9600: speed = B9600; break;
-        case 19200: speed = B19200; break;
-        case 38400: speed = B38400; break;
-        case 57600: speed = B57600; break;
-        case 115200: speed = B115200; break;
-        default: speed = B9600; break;
+    speed_t speed = velocidadTermios(baudRate);
+    if (speed == B0) {
+        speed = B9600;
     }
 
     cfsetospeed(&tty, speed);
@@ -191,8 +239,13 @@ bool SerialPort::open(const char* portName, int baudRate) {
     tty.c_oflag &= ~ONLCR;
 
     // Configurar timeouts
-    tty.c_cc[VTIME] = 1;  // Timeout de 0.1 segundos
-    tty.c_cc[VMIN] = 0;   // Lectura no bloqueante
+    if (modoEventos) {
+        tty.c_cc[VTIME] = 0; // read() nunca espera: la espera la hace poll() en esperarDatos()
+        tty.c_cc[VMIN] = 0;
+    } else {
+        tty.c_cc[VTIME] = 1;  // Timeout de 0.1 segundos
+        tty.c_cc[VMIN] = 0;   // Lectura no bloqueante
+    }
 
     // Aplicar configuración
     if (tcsetattr(fd, TCSANOW, &tty) != 0) {
@@ -202,77 +255,329 @@ bool SerialPort::open(const char* portName, int baudRate) {
         return false;
     }
 
+    if (modoEventos) {
+        // Pipe no bloqueante para que despertar() pueda interrumpir poll()
+        if (pipe(despertador) != 0) {
+            std::cerr << "Error: No se pudo crear el pipe de despertar" << std::endl;
+            ::close(fd);
+            fd = -1;
+            return false;
+        }
+        for (int i = 0; i < 2; ++i) {
+            fcntl(despertador[i], F_SETFL, fcntl(despertador[i], F_GETFL) | O_NONBLOCK);
+            fcntl(despertador[i], F_SETFD, FD_CLOEXEC);
+        }
+    } else {
+        // Con O_NDELAY, read() ignora VTIME: quitarlo para que el timeout tenga efecto
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+    }
+
     connected = true;
     std::cout << "Conexión establecida con " << portName << " a " << baudRate << " baudios." << std::endl;
 
     // Esperar a que el Arduino se reinicie
-    sleep(2);
+    if (esperarReinicio) {
+        uint64_t inicioEspera = comenzarIntervalo();
+        sleep(2);
+        terminarIntervalo(TRAZA_ESPERA, inicioEspera, 2000, "reinicio", 8);
+    }
 
     return true;
 #endif
 }
 
-bool SerialPort::readByte(char* buffer) {
+bool SerialPort::rellenarBuffer() {
     if (!connected) {
         return false;
     }
 
+    // Compactar: mover al inicio la línea parcial pendiente
+    if (bufferPos > 0) {
+        int pendientes = bufferLen - bufferPos;
+        if (pendientes > 0) {
+            memmove(readBuffer, readBuffer + bufferPos, pendientes);
+        }
+        bufferLen = pendientes;
+        bufferPos = 0;
+    }
+
+    int espacio = (int)sizeof(readBuffer) - 1 - bufferLen; // Reservar un byte para el '\0' final
+    if (espacio <= 0) {
+        return false;
+    }
+
+    lecturas++;
+    uint64_t inicioLectura = comenzarIntervalo();
 #ifdef _WIN32
-    DWORD bytesRead;
-    if (ReadFile(hSerial, buffer, 1, &bytesRead, NULL)) {
-        return (bytesRead > 0);
+    DWORD bytesRead = 0;
+    BOOL leido = ReadFile(hSerial, readBuffer + bufferLen, espacio, &bytesRead, NULL);
+    terminarIntervalo(TRAZA_LECTURA, inicioLectura, (int64_t)bytesRead);
+    if (!leido || bytesRead == 0) {
+        return false;
     }
-    return false;
+    int n = (int)bytesRead;
 #else
-    int n = read(fd, buffer, 1);
-    return (n > 0);
+    int n = read(fd, readBuffer + bufferLen, espacio);
+    terminarIntervalo(TRAZA_LECTURA, inicioLectura, n);
+    if (n <= 0) {
+        // Con VMIN = VTIME = 0, read() devuelve 0 si no hay datos; tras un cuelgue
+        // (visto por poll()) o con un error como EIO, el puerto se perdió
+        bool error = n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR;
+        if (modoEventos && (colgado || error)) {
+            std::cerr << "Error: El puerto serial se desconectó." << std::endl;
+            close();
+        }
+        return false;
+    }
 #endif
+    bufferLen += n;
+    bytesLeidos += n;
+    marcarLlegada((size_t)n);
+    return true;
 }
 
-char* SerialPort::readLine() {
-    if (!connected) {
-        return nullptr;
+bool SerialPort::leerLinea(VistaLinea* linea) {
+    if (!connected || linea == nullptr) {
+        return false;
+    }
+    if (modoBinario && !asciiPendiente) {
+        return leerLineaBinaria(linea);
     }
 
-    static char lineBuffer[256];
-    int linePos = 0;
-    char c;
+    // Restaurar el dato que la línea anterior tapó con su '\0'
+    if (posGuardada >= 0) {
+        readBuffer[posGuardada] = caracterGuardado;
+        posGuardada = -1;
+    }
 
-    // Leer hasta encontrar '\n' o '\r'
-    while (linePos < 255) {
-        if (readByte(&c)) {
-            // Ignorar \r y \n al inicio
-            if (linePos == 0 && (c == '\n' || c == '\r')) {
-                continue;
+    while (true) {
+        size_t inicio, longitud, consumidos;
+        bool completa = separarLinea(readBuffer + bufferPos, (size_t)(bufferLen - bufferPos), asciiPendiente,
+                                     &inicio, &longitud, &consumidos);
+        if (!completa) {
+            bufferPos += (int)consumidos;
+            if (asciiPendiente) {
+                // Se entregaron las líneas previas a la respuesta al saludo: pasar a binario
+                asciiPendiente = false;
+                bufferPos = 0;
+                bufferLen = 0;
+                return leerLineaBinaria(linea);
             }
-
-            // Si encontramos fin de línea, terminar
-            if (c == '\n' || c == '\r') {
-                break;
+            // La línea está incompleta: traer más bytes del puerto en un solo bloque
+            if (!rellenarBuffer()) {
+                return false; // No hay más datos por ahora; la línea parcial se conserva
             }
+            continue;
+        }
 
-            lineBuffer[linePos++] = c;
+        int principio = bufferPos + (int)inicio;
+        int fin = principio + (int)longitud;
+        if ((size_t)consumidos > inicio + longitud) {
+            // El terminador se consume: se puede sobrescribir con '\0'
+            readBuffer[fin] = '\0';
         } else {
-            // No hay más datos disponibles por ahora
-            if (linePos > 0) {
-                break; // Retornar lo que tenemos
+            // Línea demasiado larga: se corta aquí y el byte tapado se restaura después
+            posGuardada = fin;
+            caracterGuardado = readBuffer[fin];
+            readBuffer[fin] = '\0';
+        }
+        bufferPos += (int)consumidos;
+
+        linea->datos = readBuffer + principio;
+        linea->longitud = longitud;
+        return true;
+    }
+}
+
+bool SerialPort::leerLineaBinaria(VistaLinea* linea) {
+    while (posicionRacha >= tramaActual.longitud) {
+        size_t consumidos;
+        EstadoExtraccion estado = extraerTramaBinaria((const unsigned char*)readBuffer + bufferPos,
+                                                      (size_t)(bufferLen - bufferPos), &tramaActual, &consumidos);
+        bufferPos += (int)consumidos;
+        if (estado == EXTRACCION_INCOMPLETA) {
+            if (!rellenarBuffer()) {
+                return false; // La trama parcial se conserva hasta la próxima lectura
+            }
+            continue;
+        }
+        if (estado == EXTRACCION_DESCARTE) {
+            descartesBinarios++;
+            continue;
+        }
+
+        tramasBinarias++;
+        posicionRacha = 0;
+        if (tramaActual.tipo == TRAMA_MAPA) {
+            // Una trama MAP equivale a una sola línea
+            int longitud;
+            if (tramaActual.rotor == 0) {
+                longitud = snprintf(lineaBinaria, sizeof(lineaBinaria), "M,%d", (int)tramaActual.rotacion);
+            } else {
+                longitud = snprintf(lineaBinaria, sizeof(lineaBinaria), "M,%d,%d", (int)tramaActual.rotor,
+                                    (int)tramaActual.rotacion);
             }
-            return nullptr; // No hay datos
+            tramaActual.longitud = 0;
+            linea->datos = lineaBinaria;
+            linea->longitud = (size_t)longitud;
+            return true;
         }
     }
 
-    if (linePos == 0) {
-        return nullptr; // Línea vacía
+    // Cada carácter de una racha LOAD se entrega como su propia línea "L,X"
+    lineaBinaria[0] = 'L';
+    lineaBinaria[1] = ',';
+    lineaBinaria[2] = tramaActual.datos[posicionRacha++];
+    lineaBinaria[3] = '\0';
+    linea->datos = lineaBinaria;
+    linea->longitud = 3;
+    return true;
+}
+
+bool SerialPort::escribir(const char* datos, size_t longitud) {
+#ifdef _WIN32
+    DWORD escritos = 0;
+    return WriteFile(hSerial, datos, (DWORD)longitud, &escritos, NULL) && escritos == longitud;
+#else
+    size_t enviados = 0;
+    while (enviados < longitud) {
+        ssize_t n = write(fd, datos + enviados, longitud - enviados);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                struct pollfd pfd = {fd, POLLOUT, 0};
+                poll(&pfd, 1, 100);
+                continue;
+            }
+            return false;
+        }
+        enviados += (size_t)n;
     }
+    return true;
+#endif
+}
 
-    lineBuffer[linePos] = '\0';
+bool SerialPort::cambiarVelocidad(int baudios) {
+#ifdef _WIN32
+    DCB dcbSerialParams = {0};
+    dcbSerialParams.DCBlength = sizeof(dcbSerialParams);
+    if (!GetCommState(hSerial, &dcbSerialParams)) {
+        return false;
+    }
+    dcbSerialParams.BaudRate = baudios;
+    if (!SetCommState(hSerial, &dcbSerialParams)) {
+        return false;
+    }
+    PurgeComm(hSerial, PURGE_RXCLEAR);
+    return true;
+#else
+    speed_t speed = velocidadTermios(baudios);
+    if (speed == B0) {
+        return false;
+    }
+    cfsetospeed(&tty, speed);
+    cfsetispeed(&tty, speed);
+    if (tcsetattr(fd, TCSANOW, &tty) != 0) {
+        return false;
+    }
+    tcflush(fd, TCIFLUSH); // Lo recibido durante el cambio de velocidad es basura
+    return true;
+#endif
+}
+
+bool SerialPort::negociarBinario(int baudios, int plazoMilisegundos) {
+    if (!connected) {
+        return false;
+    }
+    if (modoBinario) {
+        return true;
+    }
+    if (posGuardada >= 0) {
+        readBuffer[posGuardada] = caracterGuardado; // El buffer se revisa completo
+        posGuardada = -1;
+    }
+
+    char saludo[32];
+    int longitud = snprintf(saludo, sizeof(saludo), "H,B,%d\n", baudios);
+    if (!escribir(saludo, (size_t)longitud)) {
+        std::cerr << "Error: No se pudo enviar el saludo al Arduino." << std::endl;
+        return false;
+    }
+
+    // Buscar la respuesta "H,OK,<baudios>" al inicio de una línea sin consumir nada más:
+    // si el Arduino no la entiende, lo recibido se procesa después como ASCII
+    const char respuesta[] = "H,OK,";
+    const int longitudRespuesta = (int)sizeof(respuesta) - 1;
+    auto limite = std::chrono::steady_clock::now() + std::chrono::milliseconds(plazoMilisegundos);
+    while (connected) {
+        // El buffer mide como mucho 4 KB: se revisa completo en cada vuelta
+        for (int i = bufferPos; i + longitudRespuesta <= bufferLen; ++i) {
+            bool inicioDeLinea = i == bufferPos || readBuffer[i - 1] == '\n' || readBuffer[i - 1] == '\r';
+            if (!inicioDeLinea || memcmp(readBuffer + i, respuesta, (size_t)longitudRespuesta) != 0) {
+                continue;
+            }
+            int fin = i + longitudRespuesta;
+            while (fin < bufferLen && readBuffer[fin] != '\n') {
+                fin++;
+            }
+            if (fin == bufferLen) {
+                break; // Respuesta incompleta: esperar el resto
+            }
+            readBuffer[fin] = '\0';
+            int aceptados = atoi(readBuffer + i + longitudRespuesta);
+            if (aceptados != baudios || !cambiarVelocidad(baudios)) {
+                std::cerr << "Error: El Arduino respondió " << (readBuffer + i) << " pero no se pudo usar "
+                          << baudios << " baudios." << std::endl;
+                return false;
+            }
+            // Lo anterior a la respuesta son tramas ASCII que aún se entregan;
+            // lo posterior llegó a la velocidad vieja y se descarta
+            bufferLen = i;
+            asciiPendiente = bufferLen > bufferPos;
+            if (!asciiPendiente) {
+                bufferPos = 0;
+                bufferLen = 0;
+            }
+            modoBinario = true;
+            std::cout << "Modo binario negociado a " << baudios << " baudios." << std::endl;
+            return true;
+        }
+
+        auto ahora = std::chrono::steady_clock::now();
+        if (ahora >= limite || bufferLen - bufferPos >= (int)sizeof(readBuffer) - 1) {
+            break; // Sin respuesta a tiempo, o el buffer se llenó con tramas ASCII
+        }
+        if (!rellenarBuffer()) {
+            int restante = (int)std::chrono::duration_cast<std::chrono::milliseconds>(limite - ahora).count();
+            esperarDatos(restante > 0 ? restante : 1);
+        }
+    }
+    return false;
+}
+
+bool SerialPort::esBinario() const {
+    return modoBinario;
+}
+
+unsigned long SerialPort::getTramasBinarias() const {
+    return tramasBinarias;
+}
+
+unsigned long SerialPort::getDescartesBinarios() const {
+    return descartesBinarios;
+}
+
+char* SerialPort::readLine() {
+    VistaLinea linea;
+    if (!leerLinea(&linea)) {
+        return nullptr;
+    }
 
     // Alocar memoria y copiar
-    char* result = (char*)malloc(linePos + 1);
+    char* result = (char*)malloc(linea.longitud + 1);
     if (result) {
-        manual_strcpy(result, lineBuffer);
+        registrarAsignacion();
+        manual_strcpy(result, linea.datos);
     }
-
     return result;
 }
 
@@ -291,12 +596,103 @@ void SerialPort::close() {
         ::close(fd);
         fd = -1;
     }
+    for (int i = 0; i < 2; ++i) {
+        if (despertador[i] != -1) {
+            ::close(despertador[i]);
+            despertador[i] = -1;
+        }
+    }
 #endif
 
     connected = false;
+    colgado = false;
+    modoBinario = false;
+    asciiPendiente = false;
+    tramaActual.longitud = 0;
+    posicionRacha = 0;
+    bufferPos = 0;
+    bufferLen = 0;
+    posGuardada = -1;
     std::cout << "Puerto serial cerrado." << std::endl;
 }
 
 bool SerialPort::isConnected() const {
     return connected;
+}
+
+bool SerialPort::agotada() const {
+    return !connected;
+}
+
+bool SerialPort::esperarDatos(int milisegundos) {
+    if (!connected) {
+        return false;
+    }
+#ifdef _WIN32
+    (void)milisegundos;
+    return true; // ReadFile ya espera según los COMMTIMEOUTS
+#else
+    if (!modoEventos) {
+        return true; // read() ya espera hasta VTIME
+    }
+
+    struct pollfd fds[2];
+    fds[0].fd = fd;
+    fds[0].events = POLLIN;
+    fds[0].revents = 0;
+    fds[1].fd = despertador[0];
+    fds[1].events = POLLIN;
+    fds[1].revents = 0;
+
+    int listos = poll(fds, 2, milisegundos);
+    if (listos <= 0) {
+        return false; // Plazo vencido o señal (EINTR)
+    }
+
+    if (fds[1].revents & POLLIN) {
+        // Consumir los avisos pendientes para que la próxima espera sí duerma
+        char basura[64];
+        while (read(despertador[0], basura, sizeof(basura)) > 0) {
+        }
+        return false;
+    }
+
+    if (fds[0].revents & (POLLHUP | POLLERR | POLLNVAL)) {
+        // Leer lo que quede: rellenarBuffer() cierra el puerto cuando ya no haya nada
+        colgado = true;
+        return true;
+    }
+    return (fds[0].revents & POLLIN) != 0;
+#endif
+}
+
+void SerialPort::despertar() {
+#ifndef _WIN32
+    int escritura = despertador[1];
+    if (escritura != -1) {
+        char aviso = 1;
+        ssize_t escritos = write(escritura, &aviso, 1); // Si el pipe está lleno ya hay un aviso pendiente
+        (void)escritos;
+    }
+#endif
+}
+
+void SerialPort::setModoEventos(bool porEventos) {
+    modoEventos = porEventos;
+}
+
+int SerialPort::descriptor() const {
+#ifdef _WIN32
+    return -1;
+#else
+    return connected ? fd : -1;
+#endif
+}
+
+unsigned long SerialPort::getLecturas() const {
+    return lecturas;
+}
+
+unsigned long SerialPort::getBytesLeidos() const {
+    return bytesLeidos;
 }
\ No newline at end of file
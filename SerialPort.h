@@ -13,6 +13,9 @@
     #include <unistd.h>
 #endif
 
+#include "FuenteTramas.h"
+#include "TramaBinaria.h"
+
 /**
  * @class SerialPort
  * @brief Clase para comunicación serial real con Arduino.
@@ -21,19 +24,43 @@
  * - Windows: COM1, COM2, COM3, etc.
  * - Linux/macOS: /dev/ttyUSB0, /dev/ttyACM0, etc.
  *
+ * En Linux/macOS el puerto funciona por eventos: esperarDatos() duerme en `poll()`
+ * sobre el puerto y un pipe de despertar, así que no consume CPU mientras no llegan
+ * bytes y reacciona en cuanto llegan. setModoEventos(false) vuelve al sondeo con VTIME.
+ *
+ * El puerto empieza siempre en ASCII. negociarBinario() pide al Arduino el formato
+ * binario compacto (ver TramaBinaria.h) a mayor velocidad; si el Arduino acepta,
+ * leerLinea() convierte cada trama binaria en las líneas `L,X` / `M,N` equivalentes,
+ * de modo que el resto del programa no distingue entre ambos formatos.
+ *
  * @note Configuración por defecto: 9600 baudios, 8N1 (8 bits, sin paridad, 1 bit de parada)
  */
-class SerialPort {
+class SerialPort : public FuenteTramas {
 private:
 #ifdef _WIN32
     HANDLE hSerial;  /**< @brief Handle del puerto serial en Windows. */
 #else
     int fd;          /**< @brief File descriptor del puerto serial en Linux/macOS. */
     struct termios tty; /**< @brief Configuración del terminal en Linux/macOS. */
+    int despertador[2]; /**< @brief Pipe para interrumpir poll() (lectura, escritura), o -1. */
 #endif
+    bool modoEventos; /**< @brief Esperar con poll() en lugar de sondear con VTIME. */
+    bool colgado;     /**< @brief poll() informó un cuelgue; al agotarse los datos se cierra el puerto. */
     bool connected;  /**< @brief Estado de la conexión. */
-    char readBuffer[256]; /**< @brief Buffer interno para lectura. */
-    int bufferPos;   /**< @brief Posición actual en el buffer. */
+    char readBuffer[4096 + 1]; /**< @brief Buffer interno de lecturas en bloque (+1 para el '\0' de la última línea). */
+    int bufferPos;   /**< @brief Posición del primer byte aún no consumido en el buffer. */
+    int bufferLen;   /**< @brief Cantidad de bytes válidos en el buffer. */
+    unsigned long lecturas;    /**< @brief Número de llamadas al sistema de lectura realizadas. */
+    unsigned long bytesLeidos; /**< @brief Total de bytes recibidos del puerto. */
+    int posGuardada;       /**< @brief Posición donde leerLinea() escribió un '\0' sobre un dato, o -1. */
+    char caracterGuardado; /**< @brief Dato original en `posGuardada`, que se restaura en la siguiente lectura. */
+    bool modoBinario;      /**< @brief El Arduino aceptó el formato binario. */
+    bool asciiPendiente;   /**< @brief Quedan en el buffer líneas ASCII recibidas antes de la respuesta al saludo. */
+    TramaBinaria tramaActual; /**< @brief Última trama binaria extraída. */
+    size_t posicionRacha;  /**< @brief Siguiente carácter de `tramaActual` a entregar como línea. */
+    char lineaBinaria[24]; /**< @brief Línea de texto equivalente a la trama binaria en curso. */
+    unsigned long tramasBinarias;   /**< @brief Tramas binarias válidas recibidas. */
+    unsigned long descartesBinarios; /**< @brief Veces que se descartaron bytes (ruido o CRC incorrecto). */
 
 public:
     /**
@@ -46,7 +73,7 @@ public:
      * @brief Destructor de SerialPort.
      * Asegura que el puerto serial se cierre correctamente.
      */
-    ~SerialPort();
+    ~SerialPort() override;
 
     /**
      * @brief Abre y configura el puerto serial real.
@@ -55,22 +82,107 @@ public:
      *                 - Linux: "/dev/ttyUSB0", "/dev/ttyACM0", etc.
      *                 - macOS: "/dev/tty.usbserial-*", "/dev/tty.usbmodem*", etc.
      * @param baudRate Velocidad de transmisión (por defecto 9600).
+     * @param esperarReinicio Esperar 2 s a que el Arduino se reinicie. Al abrir muchos
+     *                        puertos conviene pasar `false` y esperar una sola vez.
      * @return `true` si el puerto se abrió correctamente, `false` en caso contrario.
      */
-    bool open(const char* portName, int baudRate = 9600);
+    bool open(const char* portName, int baudRate = 9600, bool esperarReinicio = true);
 
     /**
      * @brief Lee una línea de datos del puerto serial.
      * @details
-     * La función lee caracteres hasta encontrar un '\n' o '\r'.
+     * Los bytes se leen del puerto en bloques de hasta `sizeof(readBuffer)` y las
+     * líneas se separan dentro del buffer interno, de modo que una sola llamada al
+     * sistema sirve para muchas tramas. Una línea incompleta se conserva en el
+     * buffer hasta que llega su '\n' o '\r' en una lectura posterior.
      * Elimina los caracteres de nueva línea del final de la cadena.
      * La memoria para la línea leída se asigna dinámicamente y el llamador es
      * responsable de liberarla usando `free()`.
      * @return Un puntero a un array de caracteres `char*` con la línea leída,
      *         o `nullptr` si no hay datos disponibles o hubo un error.
+     * @note Se conserva por compatibilidad; asigna memoria en cada línea.
+     *       Para el bucle de decodificación use leerLinea().
      */
     char* readLine();
 
+    /**
+     * @brief Lee una línea sin copiarla ni asignar memoria.
+     * @details
+     * Tiene las mismas reglas que readLine(), pero `linea` apunta directamente al
+     * buffer interno del puerto: el terminador de línea se reemplaza por '\0' en
+     * el propio buffer, por lo que la vista también es una cadena C válida. La vista deja de ser válida en la siguiente llamada a
+     * leerLinea(), readLine() o close().
+     * @param linea Salida: vista de la línea leída.
+     * @return `true` si se leyó una línea, `false` si no hay datos disponibles o hubo un error.
+     */
+    bool leerLinea(VistaLinea* linea) override;
+
+    /**
+     * @brief Indica si el puerto ya no entregará más líneas.
+     * @return `true` si el puerto no está conectado.
+     */
+    bool agotada() const override;
+
+    /**
+     * @brief Duerme hasta que el puerto tenga bytes, se llame a despertar() o venza el plazo.
+     * @details En modo de sondeo (o en Windows) regresa de inmediato; la espera la hacen
+     *          los timeouts de lectura del puerto. Si el puerto se desconecta, lo cierra.
+     * @param milisegundos Plazo máximo, o -1 para esperar sin límite.
+     * @return `true` si hay bytes por leer, `false` si venció el plazo o se interrumpió la espera.
+     */
+    bool esperarDatos(int milisegundos) override;
+
+    /**
+     * @brief Interrumpe la espera de esperarDatos() escribiendo en el pipe de despertar.
+     * @details Solo llama a `write()`, por lo que es segura en un manejador de señales.
+     */
+    void despertar() override;
+
+    /**
+     * @brief Elige entre el modo por eventos (por defecto) y el sondeo con VTIME.
+     * @details Debe llamarse antes de open().
+     * @param porEventos `true` para esperar con poll(), `false` para sondear.
+     */
+    void setModoEventos(bool porEventos);
+
+    /**
+     * @brief Obtiene el descriptor del puerto para vigilarlo con poll()/epoll.
+     * @return El descriptor en Linux/macOS mientras el puerto está abierto; -1 en otro caso.
+     */
+    int descriptor() const override;
+
+    /**
+     * @brief Negocia el formato binario con el Arduino mediante una línea de saludo.
+     * @details
+     * Envía `H,B,<baudios>` y espera la respuesta `H,OK,<baudios>`. Al recibirla cambia
+     * la velocidad del puerto y pasa al formato binario. Si el Arduino no responde en
+     * el plazo (p. ej. un firmware antiguo), el puerto sigue en ASCII y lo recibido
+     * mientras tanto se conserva para leerLinea(). Las líneas ASCII que llegaron antes
+     * de la respuesta también se entregan, antes de la primera trama binaria.
+     * @param baudios Velocidad del modo binario (115200 o más).
+     * @param plazoMilisegundos Tiempo máximo de espera de la respuesta.
+     * @return `true` si el puerto quedó en modo binario.
+     */
+    bool negociarBinario(int baudios = 115200, int plazoMilisegundos = 3000);
+
+    /**
+     * @brief Indica si el puerto está en modo binario.
+     * @return `true` después de una negociación exitosa.
+     */
+    bool esBinario() const;
+
+    /**
+     * @brief Obtiene el número de tramas binarias válidas recibidas.
+     * @return Tramas binarias recibidas.
+     */
+    unsigned long getTramasBinarias() const;
+
+    /**
+     * @brief Obtiene cuántas veces se descartaron bytes en modo binario.
+     * @return Descartes por ruido, encabezado inválido o CRC incorrecto.
+     */
+    unsigned long getDescartesBinarios() const;
+
     /**
      * @brief Cierra el puerto serial.
      */
@@ -82,13 +194,49 @@ public:
      */
     bool isConnected() const;
 
+    /**
+     * @brief Obtiene el número de llamadas al sistema de lectura realizadas.
+     * @return Cantidad de llamadas a `read`/`ReadFile` desde que se creó el objeto.
+     */
+    unsigned long getLecturas() const;
+
+    /**
+     * @brief Obtiene el total de bytes recibidos del puerto.
+     * @return Cantidad de bytes leídos desde que se creó el objeto.
+     */
+    unsigned long getBytesLeidos() const;
+
 private:
     /**
-     * @brief Lee un solo byte del puerto serial.
-     * @param buffer Puntero al buffer donde se almacenará el byte leído.
-     * @return `true` si se leyó un byte correctamente, `false` en caso contrario.
+     * @brief Lee del puerto tantos bytes como quepan en el espacio libre del buffer.
+     *
+     * Antes de leer, desplaza al inicio del buffer los bytes aún no consumidos.
+     *
+     * @return `true` si se recibió al menos un byte, `false` si no hay datos o hubo un error.
+     */
+    bool rellenarBuffer();
+
+    /**
+     * @brief Variante de leerLinea() para el modo binario.
+     * @param linea Salida: línea de texto equivalente a la siguiente trama.
+     * @return `true` si se entregó una línea.
+     */
+    bool leerLineaBinaria(VistaLinea* linea);
+
+    /**
+     * @brief Escribe bytes en el puerto.
+     * @param datos Bytes a enviar.
+     * @param longitud Número de bytes.
+     * @return `true` si se enviaron todos.
+     */
+    bool escribir(const char* datos, size_t longitud);
+
+    /**
+     * @brief Cambia la velocidad del puerto abierto.
+     * @param baudios Nueva velocidad.
+     * @return `true` si el sistema aceptó la velocidad.
      */
-    bool readByte(char* buffer);
+    bool cambiarVelocidad(int baudios);
 };
 
 #endif // SERIAL_PORT_H
\ No newline at end of file
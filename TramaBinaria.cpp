@@ -0,0 +1,183 @@
+/**
+ * @file TramaBinaria.cpp
+ * @brief Implementación de la codificación y decodificación de tramas binarias.
+ */
+
+#include "TramaBinaria.h"
+#include "Crc8.h"
+#include <cstring>  // Para memchr, memcpy
+
+/**
+ * @brief Símbolo de cada valor de 5 bits (A=0, ..., ' '=26).
+ */
+static const char SIMBOLOS_BINARIOS[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ ";
+
+/**
+ * @brief Número de símbolos empacables.
+ */
+static const unsigned int NUMERO_SIMBOLOS = 27;
+
+/**
+ * @brief Bytes de carga útil que siguen a un encabezado.
+ * @param encabezado Segundo byte de la trama.
+ * @return Longitud de la carga útil, o 0 si la clase no existe.
+ */
+static size_t longitudCargaUtil(unsigned char encabezado) {
+    size_t valor = encabezado & 0x3F;
+    switch (encabezado >> 6) {
+        case CLASE_CARGA_EMPACADA:
+            return ((valor + 1) * 5 + 7) / 8;
+        case CLASE_MAPA:
+            return (encabezado & 0x20) ? 4 : 1;
+        case CLASE_CARGA_CRUDA:
+            return valor + 1;
+        default:
+            return 0;
+    }
+}
+
+EstadoExtraccion extraerTramaBinaria(const unsigned char* datos, size_t disponibles,
+                                     TramaBinaria* trama, size_t* consumidos) {
+    // Saltar el ruido anterior al byte de sincronía
+    const unsigned char* sincronia = (const unsigned char*)memchr(datos, SINCRONIA_BINARIA, disponibles);
+    if (sincronia == nullptr) {
+        *consumidos = disponibles;
+        return disponibles > 0 ? EXTRACCION_DESCARTE : EXTRACCION_INCOMPLETA;
+    }
+    if (sincronia != datos) {
+        *consumidos = (size_t)(sincronia - datos);
+        return EXTRACCION_DESCARTE;
+    }
+
+    *consumidos = 0;
+    if (disponibles < 2) {
+        return EXTRACCION_INCOMPLETA;
+    }
+    unsigned char encabezado = datos[1];
+    size_t carga = longitudCargaUtil(encabezado);
+    if (carga == 0) {
+        *consumidos = 1; // Clase reservada: el byte de sincronía era parte de otra cosa
+        return EXTRACCION_DESCARTE;
+    }
+    size_t total = 2 + carga + 1;
+    if (disponibles < total) {
+        return EXTRACCION_INCOMPLETA;
+    }
+    if (calcularCrc8(datos + 1, 1 + carga) != datos[total - 1]) {
+        *consumidos = 1;
+        return EXTRACCION_DESCARTE;
+    }
+
+    const unsigned char* util = datos + 2;
+    trama->rotor = 0;
+    trama->longitud = 0;
+    trama->rotacion = 0;
+    switch (encabezado >> 6) {
+        case CLASE_CARGA_EMPACADA: {
+            size_t longitud = (size_t)(encabezado & 0x3F) + 1;
+            unsigned int acumulador = 0;
+            int bits = 0;
+            size_t leido = 0;
+            for (size_t i = 0; i < longitud; ++i) {
+                if (bits < 5) {
+                    acumulador |= (unsigned int)util[leido++] << bits;
+                    bits += 8;
+                }
+                unsigned int simbolo = acumulador & 0x1F;
+                acumulador >>= 5;
+                bits -= 5;
+                if (simbolo >= NUMERO_SIMBOLOS) {
+                    *consumidos = 1; // Valor imposible pese al CRC: tratar como ruido
+                    return EXTRACCION_DESCARTE;
+                }
+                trama->datos[i] = SIMBOLOS_BINARIOS[simbolo];
+            }
+            trama->tipo = TRAMA_CARGA;
+            trama->longitud = (uint8_t)longitud;
+            break;
+        }
+        case CLASE_CARGA_CRUDA:
+            trama->tipo = TRAMA_CARGA;
+            trama->longitud = (uint8_t)carga;
+            memcpy(trama->datos, util, carga);
+            break;
+        default: // CLASE_MAPA
+            trama->tipo = TRAMA_MAPA;
+            trama->rotor = encabezado & 0x1F;
+            if (carga == 4) {
+                uint32_t valor = (uint32_t)util[0] | ((uint32_t)util[1] << 8) |
+                                 ((uint32_t)util[2] << 16) | ((uint32_t)util[3] << 24);
+                trama->rotacion = (int32_t)valor;
+            } else {
+                trama->rotacion = (int8_t)util[0];
+            }
+            break;
+    }
+    *consumidos = total;
+    return EXTRACCION_TRAMA;
+}
+
+/**
+ * @brief Cierra una trama: escribe la sincronía y el CRC alrededor de encabezado y carga útil.
+ * @param salida Trama con el encabezado en salida[1] y la carga útil a continuación.
+ * @param carga Bytes de carga útil.
+ * @return Bytes totales de la trama.
+ */
+static size_t cerrarTrama(unsigned char* salida, size_t carga) {
+    salida[0] = SINCRONIA_BINARIA;
+    salida[2 + carga] = calcularCrc8(salida + 1, 1 + carga);
+    return 3 + carga;
+}
+
+size_t codificarCargasBinarias(const char* datos, size_t longitud, unsigned char* salida) {
+    if (longitud == 0 || longitud > MAXIMO_RACHA_BINARIA) {
+        return 0;
+    }
+
+    bool empacable = true;
+    for (size_t i = 0; i < longitud && empacable; ++i) {
+        empacable = (datos[i] >= 'A' && datos[i] <= 'Z') || datos[i] == ' ';
+    }
+    if (!empacable) {
+        salida[1] = (unsigned char)((CLASE_CARGA_CRUDA << 6) | (longitud - 1));
+        memcpy(salida + 2, datos, longitud);
+        return cerrarTrama(salida, longitud);
+    }
+
+    salida[1] = (unsigned char)((CLASE_CARGA_EMPACADA << 6) | (longitud - 1));
+    unsigned int acumulador = 0;
+    int bits = 0;
+    size_t escrito = 0;
+    for (size_t i = 0; i < longitud; ++i) {
+        unsigned int simbolo = datos[i] == ' ' ? 26u : (unsigned int)(datos[i] - 'A');
+        acumulador |= simbolo << bits;
+        bits += 5;
+        while (bits >= 8) {
+            salida[2 + escrito++] = (unsigned char)(acumulador & 0xFF);
+            acumulador >>= 8;
+            bits -= 8;
+        }
+    }
+    if (bits > 0) {
+        salida[2 + escrito++] = (unsigned char)acumulador;
+    }
+    return cerrarTrama(salida, escrito);
+}
+
+size_t codificarMapaBinario(int rotor, int32_t rotacion, unsigned char* salida) {
+    if (rotor < 0 || rotor > 0x1F) {
+        return 0;
+    }
+    if (rotacion >= -128 && rotacion <= 127) {
+        salida[1] = (unsigned char)((CLASE_MAPA << 6) | rotor);
+        salida[2] = (unsigned char)(int8_t)rotacion;
+        return cerrarTrama(salida, 1);
+    }
+    uint32_t valor = (uint32_t)rotacion;
+    salida[1] = (unsigned char)((CLASE_MAPA << 6) | 0x20 | rotor);
+    salida[2] = (unsigned char)(valor & 0xFF);
+    salida[3] = (unsigned char)((valor >> 8) & 0xFF);
+    salida[4] = (unsigned char)((valor >> 16) & 0xFF);
+    salida[5] = (unsigned char)(valor >> 24);
+    return cerrarTrama(salida, 4);
+}
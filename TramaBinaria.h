@@ -0,0 +1,102 @@
+/**
+ * @file TramaBinaria.h
+ * @brief Define el formato binario compacto de las tramas PRT-7 y su decodificación.
+ */
+
+#ifndef TRAMA_BINARIA_H
+#define TRAMA_BINARIA_H
+
+#include <cstddef>
+#include <cstdint>
+#include "TramaCompacta.h"
+
+/**
+ * @brief Byte de sincronía con el que empieza toda trama binaria.
+ */
+const unsigned char SINCRONIA_BINARIA = 0xA5;
+
+/**
+ * @brief Máximo de caracteres en una racha LOAD binaria (6 bits de longitud).
+ */
+const size_t MAXIMO_RACHA_BINARIA = 64;
+
+/**
+ * @brief Tamaño máximo de una trama binaria completa (sincronía, encabezado, racha cruda y CRC).
+ */
+const size_t MAXIMO_TRAMA_BINARIA = 3 + MAXIMO_RACHA_BINARIA;
+
+/**
+ * @enum ClaseBinaria
+ * @brief Clase de trama, en los 2 bits altos del encabezado.
+ *
+ * Formato: `A5 | encabezado | carga útil | CRC-8(encabezado + carga útil)`.
+ * - CLASE_CARGA_EMPACADA: bits 0-5 = longitud - 1; cada carácter (A-Z = 0..25,
+ *   espacio = 26) ocupa 5 bits, empezando por el bit menos significativo.
+ * - CLASE_MAPA: bits 0-4 = rotor; bit 5 = rotación de 4 bytes (int32 little-endian)
+ *   en lugar de 1 (int8).
+ * - CLASE_CARGA_CRUDA: bits 0-5 = longitud - 1; un byte por carácter (para
+ *   minúsculas u otros bytes que no se pueden empacar).
+ */
+enum ClaseBinaria : uint8_t {
+    CLASE_CARGA_EMPACADA = 0, /**< @brief Racha LOAD de símbolos de 5 bits. */
+    CLASE_MAPA = 1,           /**< @brief Trama MAP (`M,<rotor>,N`). */
+    CLASE_CARGA_CRUDA = 2     /**< @brief Racha LOAD de bytes sin empacar. */
+};
+
+/**
+ * @struct TramaBinaria
+ * @brief Contenido de una trama binaria ya verificada.
+ */
+struct TramaBinaria {
+    TipoTrama tipo;    /**< @brief TRAMA_CARGA (una racha) o TRAMA_MAPA. */
+    uint8_t rotor;     /**< @brief Rotor de una trama MAP. */
+    uint8_t longitud;  /**< @brief Caracteres de la racha (1..64) de una trama LOAD. */
+    int32_t rotacion;  /**< @brief Rotación de una trama MAP. */
+    char datos[MAXIMO_RACHA_BINARIA]; /**< @brief Caracteres de la racha. */
+};
+
+/**
+ * @enum EstadoExtraccion
+ * @brief Resultado de extraerTramaBinaria().
+ */
+enum EstadoExtraccion {
+    EXTRACCION_INCOMPLETA, /**< @brief Faltan bytes para completar la trama. */
+    EXTRACCION_TRAMA,      /**< @brief Se extrajo una trama válida. */
+    EXTRACCION_DESCARTE    /**< @brief Se descartaron bytes (ruido, encabezado inválido o CRC incorrecto). */
+};
+
+/**
+ * @brief Busca y verifica la siguiente trama binaria en un buffer.
+ *
+ * Los bytes anteriores al byte de sincronía se descartan. Si el encabezado no es
+ * válido o el CRC no coincide, se descarta solo el byte de sincronía y la búsqueda
+ * se reanuda en el siguiente, de modo que una trama dañada no arrastra a las demás.
+ *
+ * @param datos Bytes recibidos aún no consumidos.
+ * @param disponibles Número de bytes en `datos`.
+ * @param trama Salida: trama extraída (solo con EXTRACCION_TRAMA).
+ * @param consumidos Salida: bytes que se pueden descartar del buffer.
+ * @return El estado de la extracción.
+ */
+EstadoExtraccion extraerTramaBinaria(const unsigned char* datos, size_t disponibles,
+                                     TramaBinaria* trama, size_t* consumidos);
+
+/**
+ * @brief Codifica una racha LOAD, empacada si todos sus caracteres son A-Z o espacio.
+ * @param datos Caracteres de la racha.
+ * @param longitud Número de caracteres (1..MAXIMO_RACHA_BINARIA).
+ * @param salida Buffer de al menos MAXIMO_TRAMA_BINARIA bytes.
+ * @return Bytes escritos, o 0 si la longitud no es válida.
+ */
+size_t codificarCargasBinarias(const char* datos, size_t longitud, unsigned char* salida);
+
+/**
+ * @brief Codifica una trama MAP.
+ * @param rotor Rotor al que va dirigida (0..31).
+ * @param rotacion Rotación a transportar.
+ * @param salida Buffer de al menos 7 bytes.
+ * @return Bytes escritos, o 0 si el rotor no cabe en el encabezado.
+ */
+size_t codificarMapaBinario(int rotor, int32_t rotacion, unsigned char* salida);
+
+#endif // TRAMA_BINARIA_H
@@ -0,0 +1,49 @@
+/**
+ * @file TramaCompacta.cpp
+ * @brief Implementación de las funciones de TramaCompacta.
+ */
+
+#include "TramaCompacta.h"
+#include "ParserTramas.h"
+#include "TramaLoad.h"
+#include "TramaMap.h"
+
+bool parsearTrama(const char* linea, size_t longitud, TramaCompacta* trama, bool variosRotores) {
+    char dato;
+    int rotacion;
+    int rotor = 0;
+    TipoLinea tipo = clasificarLinea(linea, longitud, &dato, &rotacion, variosRotores ? &rotor : nullptr);
+
+    trama->rotor = 0;
+    trama->reservado = 0;
+    trama->dato = '\0';
+    trama->rotacion = 0;
+    switch (tipo) {
+        case LINEA_CARGA:
+            trama->tipo = TRAMA_CARGA;
+            trama->dato = dato;
+            return true;
+        case LINEA_MAPA:
+            trama->tipo = TRAMA_MAPA;
+            trama->rotor = (uint8_t)rotor;
+            trama->rotacion = rotacion;
+            return true;
+        default:
+            trama->tipo = TRAMA_NINGUNA;
+            return false;
+    }
+}
+
+TramaBase* crearTrama(const TramaCompacta& trama) {
+    switch (trama.tipo) {
+        case TRAMA_CARGA:
+            return new TramaLoad(trama.dato);
+        case TRAMA_MAPA:
+            if (trama.rotor != 0) {
+                return nullptr;
+            }
+            return new TramaMap(trama.rotacion);
+        default:
+            return nullptr;
+    }
+}
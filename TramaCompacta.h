@@ -0,0 +1,86 @@
+/**
+ * @file TramaCompacta.h
+ * @brief Define una representación compacta (sin herencia ni memoria dinámica) de las tramas.
+ */
+
+#ifndef TRAMA_COMPACTA_H
+#define TRAMA_COMPACTA_H
+
+#include <cstddef>
+#include <cstdint>
+#include "ListaDeCarga.h"
+#include "RotorDeMapeo.h"
+
+class TramaBase;
+
+/**
+ * @enum TipoTrama
+ * @brief Tipo de una TramaCompacta.
+ */
+enum TipoTrama : uint8_t {
+    TRAMA_NINGUNA = 0, /**< @brief La línea no es una trama válida. */
+    TRAMA_CARGA = 1,   /**< @brief Trama LOAD (`L,X`). */
+    TRAMA_MAPA = 2     /**< @brief Trama MAP (`M,N` o `M,<rotor>,N`). */
+};
+
+/**
+ * @struct TramaCompacta
+ * @brief Trama de 8 bytes que el parser llena en el lugar.
+ *
+ * Equivale a TramaLoad/TramaMap pero sin tabla virtual ni `new`/`delete`:
+ * el tipo se consulta con un `switch` en lugar de `dynamic_cast`.
+ */
+struct TramaCompacta {
+    TipoTrama tipo;     /**< @brief Tipo de la trama. */
+    char dato;          /**< @brief Carácter transportado (solo TRAMA_CARGA). */
+    uint8_t rotor;      /**< @brief Rotor al que va dirigida (solo TRAMA_MAPA; 0 en `M,N`). */
+    uint8_t reservado;  /**< @brief Relleno explícito; siempre 0. */
+    int32_t rotacion;   /**< @brief Rotación transportada (solo TRAMA_MAPA). */
+};
+
+static_assert(sizeof(TramaCompacta) == 8, "TramaCompacta debe ocupar 8 bytes");
+
+/**
+ * @brief Parsea una línea en una TramaCompacta, con las mismas reglas que parseLine().
+ * @param linea Inicio de la línea (no necesita terminar en '\0').
+ * @param longitud Número de caracteres de la línea.
+ * @param trama Salida: trama parseada (tipo TRAMA_NINGUNA si la línea no es válida).
+ * @param variosRotores `true` para reconocer `M,<rotor>,N` (pila de más de un rotor);
+ *                      si no, `M,a,b` rota `a` como el parser original (ver clasificarLinea()).
+ * @return `true` si la línea es una trama LOAD o MAP válida.
+ */
+bool parsearTrama(const char* linea, size_t longitud, TramaCompacta* trama, bool variosRotores = false);
+
+/**
+ * @brief Procesa una trama: equivale a TramaBase::procesar() sin llamada virtual.
+ * @details Se define en el encabezado para que el compilador pueda integrarla en el bucle principal.
+ * @param trama Trama a procesar.
+ * @param carga Lista donde se agrega el carácter decodificado de una trama LOAD.
+ * @param rotor Rotor que decodifica (LOAD) o se rota (MAP). Una trama MAP para otro
+ *              rotor que no sea el 0 no tiene efecto (ver PilaDeRotores).
+ */
+inline void procesarTrama(const TramaCompacta& trama, ListaDeCarga* carga, RotorDeMapeo* rotor) {
+    switch (trama.tipo) {
+        case TRAMA_CARGA:
+            carga->insertarAlFinal(rotor->getMapeo(trama.dato));
+            break;
+        case TRAMA_MAPA:
+            if (trama.rotor == 0) {
+                rotor->rotar(trama.rotacion);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Crea el objeto polimórfico equivalente a una TramaCompacta.
+ * @param trama Trama compacta de origen.
+ * @return Una nueva TramaLoad o TramaMap que el llamador debe liberar con `delete`,
+ *         o `nullptr` si la trama es TRAMA_NINGUNA o va dirigida a un rotor distinto del 0
+ *         (TramaMap solo modela un rotor).
+ */
+TramaBase* crearTrama(const TramaCompacta& trama);
+
+#endif // TRAMA_COMPACTA_H
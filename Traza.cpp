@@ -0,0 +1,240 @@
+/**
+ * @file Traza.cpp
+ * @brief Implementación del registro y el volcado de la traza.
+ */
+
+#include "Traza.h"
+#include "AnilloSPSC.h"
+#include <cstring>  // Para memcpy
+#include <iostream>
+
+bool trazaActiva = false;
+
+/**
+ * @struct AnilloTraza
+ * @brief Anillo de eventos de un hilo, con su nombre y sus descartes.
+ */
+struct AnilloTraza {
+    AnilloSPSC<EventoTraza, EscritorTraza::CAPACIDAD_ANILLO> eventos; /**< @brief Hilo que registra → EscritorTraza. */
+    std::atomic<const char*> nombre;         /**< @brief Nombre del hilo, o `nullptr`. */
+    std::atomic<unsigned long> descartados;  /**< @brief Eventos perdidos con el anillo lleno (solo los suma el dueño). */
+};
+
+static AnilloTraza* anillos = nullptr;       /**< @brief Conjunto de anillos reservado por EscritorTraza::iniciar(). */
+static std::atomic<int> anillosTomados(0);  /**< @brief Anillos ya asignados a un hilo (puede pasar de MAXIMO_HILOS). */
+static std::atomic<unsigned long> descartadosSinAnillo(0); /**< @brief Eventos de hilos que no consiguieron anillo. */
+
+/**
+ * @brief Anillo del hilo actual, o `nullptr` si aún no tomó uno.
+ */
+static thread_local constinit AnilloTraza* anilloDelHilo = nullptr;
+
+/**
+ * @brief El hilo actual intentó tomar un anillo y ya no quedaban.
+ */
+static thread_local constinit bool hiloSinAnillo = false;
+
+/**
+ * @brief Nombres de los eventos, en el orden de TipoTraza.
+ */
+static const char* const NOMBRES_TRAZA[NUM_TIPOS_TRAZA] = {"trama", "salida", "lectura", "espera", "punto de control"};
+
+/**
+ * @brief Nombre del argumento `valor` de cada tipo de evento.
+ */
+static const char* const ARGUMENTOS_TRAZA[NUM_TIPOS_TRAZA] = {"trama", "trama", "bytes", "plazo_ms", "trama"};
+
+/**
+ * @brief Obtiene el anillo del hilo actual, tomando uno libre la primera vez.
+ * @return El anillo, o `nullptr` si ya no quedan.
+ */
+static AnilloTraza* anilloPropio() {
+    AnilloTraza* anillo = anilloDelHilo;
+    if (anillo != nullptr || hiloSinAnillo) {
+        return anillo;
+    }
+    int indice = anillosTomados.fetch_add(1, std::memory_order_relaxed);
+    if (indice >= EscritorTraza::MAXIMO_HILOS) {
+        hiloSinAnillo = true;
+        return nullptr;
+    }
+    anilloDelHilo = &anillos[indice];
+    return anilloDelHilo;
+}
+
+void registrarIntervalo(TipoTraza tipo, uint64_t inicio, uint64_t fin, int64_t valor, const char* texto, size_t longitud) {
+    AnilloTraza* anillo = anilloPropio();
+    if (anillo == nullptr) {
+        descartadosSinAnillo.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    EventoTraza* evento = anillo->eventos.reservar();
+    if (evento == nullptr) {
+        anillo->descartados.store(anillo->descartados.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+    }
+    if (longitud > LONGITUD_TEXTO_TRAZA) {
+        longitud = LONGITUD_TEXTO_TRAZA;
+    }
+    evento->inicio = inicio;
+    evento->duracion = fin - inicio;
+    evento->valor = valor;
+    evento->tipo = (uint8_t)tipo;
+    evento->longitudTexto = (uint8_t)longitud;
+    if (longitud > 0) {
+        memcpy(evento->texto, texto, longitud);
+    }
+    anillo->eventos.publicar();
+}
+
+void nombrarHiloTraza(const char* nombre) {
+    if (!trazaActiva) {
+        return;
+    }
+    AnilloTraza* anillo = anilloPropio();
+    if (anillo != nullptr) {
+        anillo->nombre.store(nombre, std::memory_order_release);
+    }
+}
+
+/**
+ * @brief Escribe una cadena JSON escapando comillas, barras y bytes no imprimibles.
+ */
+static void escribirTextoJson(FILE* archivo, const char* texto, size_t longitud) {
+    fputc('"', archivo);
+    for (size_t i = 0; i < longitud; ++i) {
+        unsigned char c = (unsigned char)texto[i];
+        if (c == '"' || c == '\\') {
+            fputc('\\', archivo);
+            fputc(c, archivo);
+        } else if (c < 0x20 || c >= 0x7F) {
+            fprintf(archivo, "\\u%04x", c); // Bytes de ruido: válidos en JSON aunque no sean UTF-8
+        } else {
+            fputc(c, archivo);
+        }
+    }
+    fputc('"', archivo);
+}
+
+EscritorTraza::EscritorTraza() : archivo(nullptr), ticksBase(0), detener(false), escritos(0), descartados(0) {}
+
+EscritorTraza::~EscritorTraza() {
+    cerrar();
+}
+
+bool EscritorTraza::iniciar(const char* ruta) {
+    if (archivo != nullptr) {
+        return true;
+    }
+    archivo = fopen(ruta, "w");
+    if (archivo == nullptr) {
+        std::cerr << "Error: No se pudo crear la traza " << ruta << std::endl;
+        return false;
+    }
+    anillos = new AnilloTraza[MAXIMO_HILOS];
+    for (int i = 0; i < MAXIMO_HILOS; ++i) {
+        anillos[i].nombre.store(nullptr);
+        anillos[i].descartados.store(0);
+    }
+    anillosTomados.store(0);
+    descartadosSinAnillo.store(0);
+    fprintf(archivo, "[{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"Decodificador PRT-7\"}}");
+    ticksBase = leerTicks();
+    detener = false;
+    escritos = 0;
+    descartados = 0;
+
+    trazaActiva = true;
+    nombrarHiloTraza("principal");
+    hilo = std::thread(&EscritorTraza::ejecutar, this);
+    return true;
+}
+
+size_t EscritorTraza::vaciarAnillos() {
+    // Se recalibra en cada vaciado: el error de la conversión no crece con la duración de la traza
+    double microsegundosPorTick = nanosegundosPorTick() / 1000.0;
+    size_t vaciados = 0;
+    int tomados = anillosTomados.load(std::memory_order_relaxed);
+    if (tomados > MAXIMO_HILOS) {
+        tomados = MAXIMO_HILOS;
+    }
+    for (int h = 0; h < tomados; ++h) {
+        EventoTraza* evento;
+        while ((evento = anillos[h].eventos.frente()) != nullptr) {
+            double inicio = ((double)evento->inicio - (double)ticksBase) * microsegundosPorTick;
+            fprintf(archivo, ",\n{\"name\":\"%s\",\"cat\":\"prt7\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,"
+                    "\"args\":{\"%s\":%lld",
+                    NOMBRES_TRAZA[evento->tipo], h + 1, inicio, (double)evento->duracion * microsegundosPorTick,
+                    ARGUMENTOS_TRAZA[evento->tipo], (long long)evento->valor);
+            if (evento->longitudTexto > 0) {
+                fputs(evento->tipo == TRAZA_ESPERA ? ",\"motivo\":" : ",\"linea\":", archivo);
+                escribirTextoJson(archivo, evento->texto, evento->longitudTexto);
+            }
+            fputs("}}", archivo);
+            anillos[h].eventos.liberar();
+            vaciados++;
+        }
+    }
+    escritos += vaciados;
+    return vaciados;
+}
+
+void EscritorTraza::ejecutar() {
+    std::unique_lock<std::mutex> cerrojo(mutex);
+    size_t vaciados = 0;
+    while (!detener) {
+        // Si el último vaciado casi llenaba un anillo, seguir sin esperar
+        if (vaciados < CAPACIDAD_ANILLO / 4) {
+            despertador.wait_for(cerrojo, std::chrono::milliseconds(INTERVALO_VACIADO_MS));
+        }
+        cerrojo.unlock();
+        vaciados = vaciarAnillos();
+        cerrojo.lock();
+    }
+}
+
+void EscritorTraza::cerrar() {
+    if (archivo == nullptr) {
+        return;
+    }
+    if (hilo.joinable()) {
+        {
+            std::lock_guard<std::mutex> cerrojo(mutex);
+            detener = true;
+        }
+        despertador.notify_one();
+        hilo.join();
+    }
+    trazaActiva = false;
+    vaciarAnillos();
+
+    // Nombres de los hilos al final: un hilo puede nombrarse después de registrar
+    int tomados = anillosTomados.load(std::memory_order_relaxed);
+    for (int h = 0; h < tomados && h < MAXIMO_HILOS; ++h) {
+        const char* nombre = anillos[h].nombre.load(std::memory_order_acquire);
+        fprintf(archivo, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", h + 1);
+        if (nombre != nullptr) {
+            escribirTextoJson(archivo, nombre, strlen(nombre));
+        } else {
+            fprintf(archivo, "\"hilo %d\"", h + 1);
+        }
+        fputs("}}", archivo);
+    }
+    fputs("\n]\n", archivo);
+    if (fclose(archivo) != 0) {
+        std::cerr << "Error: No se pudo escribir la traza." << std::endl;
+    }
+    archivo = nullptr;
+
+    descartados = descartadosSinAnillo.load(std::memory_order_relaxed);
+    for (int h = 0; h < tomados && h < MAXIMO_HILOS; ++h) {
+        descartados += anillos[h].descartados.load(std::memory_order_relaxed);
+    }
+    delete[] anillos;
+    anillos = nullptr;
+}
+
+void EscritorTraza::imprimirResumen() const {
+    std::cout << "Traza: " << escritos << " eventos escritos, " << descartados
+              << " descartados con el anillo lleno." << std::endl;
+}
@@ -0,0 +1,173 @@
+/**
+ * @file Traza.h
+ * @brief Traza por trama en el formato de eventos de Chrome (chrome://tracing, Perfetto).
+ *
+ * A diferencia de las métricas (Metricas.h), que solo guardan histogramas, la traza
+ * conserva cada intervalo por separado: sirve para encontrar la trama lenta concreta
+ * (un `M,n` enorme, una consola que se trabó en imprimirMensaje(), una espera del puerto).
+ *
+ * Se activa en tiempo de ejecución con `--traza <ruta>`. Sin ella, cada punto de
+ * registro cuesta una lectura de `trazaActiva` y un salto que siempre se predice bien.
+ * Con ella, cada hilo escribe en su propio AnilloSPSC, tomado de un conjunto reservado
+ * al iniciar: registrar no asigna memoria ni toma cerrojos y, si el anillo está lleno,
+ * el evento se descarta y se cuenta. EscritorTraza vacía los anillos en segundo plano.
+ */
+
+#ifndef TRAZA_H
+#define TRAZA_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include "RelojTicks.h"
+
+/**
+ * @enum TipoTraza
+ * @brief Qué representa un intervalo de la traza.
+ */
+enum TipoTraza {
+    TRAZA_TRAMA,          /**< @brief Parseo y decodificación de una línea. */
+    TRAZA_SALIDA,         /**< @brief Escritura en consola (de una trama o del buffer acumulado). */
+    TRAZA_LECTURA,        /**< @brief Llamada al sistema de lectura del puerto. */
+    TRAZA_ESPERA,         /**< @brief Espera de datos o pausa. */
+    TRAZA_PUNTO_CONTROL,  /**< @brief Registro de un punto de control. */
+    NUM_TIPOS_TRAZA
+};
+
+/**
+ * @brief Caracteres de la línea que se guardan con cada evento.
+ */
+const size_t LONGITUD_TEXTO_TRAZA = 14;
+
+/**
+ * @struct EventoTraza
+ * @brief Un intervalo de la traza (40 bytes).
+ */
+struct EventoTraza {
+    uint64_t inicio;                   /**< @brief Ticks al empezar. */
+    uint64_t duracion;                 /**< @brief Duración en ticks. */
+    int64_t valor;                     /**< @brief Número de trama, bytes leídos, etc. (según el tipo). */
+    uint8_t tipo;                      /**< @brief Un TipoTraza. */
+    uint8_t longitudTexto;             /**< @brief Caracteres usados de `texto`. */
+    char texto[LONGITUD_TEXTO_TRAZA];  /**< @brief Inicio de la línea o motivo de la espera (sin '\0'). */
+};
+
+/**
+ * @brief `true` mientras hay una traza en curso. Solo cambia antes de lanzar los
+ *        hilos que registran y después de que terminan.
+ */
+extern bool trazaActiva;
+
+/**
+ * @brief Guarda un intervalo en el anillo del hilo actual.
+ * @details No asigna memoria ni toma cerrojos. Si el hilo no consiguió anillo o
+ *          el suyo está lleno, el evento se cuenta como descartado.
+ */
+void registrarIntervalo(TipoTraza tipo, uint64_t inicio, uint64_t fin, int64_t valor, const char* texto, size_t longitud);
+
+/**
+ * @brief Empieza un intervalo.
+ * @return Ticks actuales, o 0 si no hay traza en curso.
+ */
+inline uint64_t comenzarIntervalo() {
+    return trazaActiva ? leerTicks() : 0;
+}
+
+/**
+ * @brief Termina un intervalo empezado con comenzarIntervalo().
+ * @param tipo Qué representa.
+ * @param inicio Valor devuelto por comenzarIntervalo() (0 = no se registra).
+ * @param valor Dato numérico asociado (número de trama, bytes...).
+ * @param texto Texto asociado (se guardan los primeros LONGITUD_TEXTO_TRAZA caracteres), o `nullptr`.
+ * @param longitud Caracteres de `texto`.
+ */
+inline void terminarIntervalo(TipoTraza tipo, uint64_t inicio, int64_t valor = 0, const char* texto = nullptr,
+                              size_t longitud = 0) {
+    if (inicio != 0) {
+        registrarIntervalo(tipo, inicio, leerTicks(), valor, texto, longitud);
+    }
+}
+
+/**
+ * @brief Da nombre al hilo actual en la traza (p. ej. "principal").
+ * @details Toma un anillo para el hilo si aún no tenía. Sin traza en curso no hace nada.
+ * @param nombre Cadena que debe vivir hasta el final de la traza (normalmente un literal).
+ */
+void nombrarHiloTraza(const char* nombre);
+
+/**
+ * @class EscritorTraza
+ * @brief Reserva los anillos de la traza y los vuelca a un archivo JSON en segundo plano.
+ *
+ * El archivo usa el formato de arreglo de eventos de Chrome (`[{...},{...}`): cada
+ * intervalo es un evento completo (`"ph":"X"`) con el hilo, el inicio y la duración en
+ * microsegundos y sus datos en `args`. El cierre `]` es opcional en ese formato, así
+ * que el archivo de un programa interrumpido también se puede abrir.
+ */
+class EscritorTraza {
+public:
+    static constexpr size_t CAPACIDAD_ANILLO = 16384; /**< @brief Eventos por hilo entre dos vaciados. */
+    static constexpr int MAXIMO_HILOS = 16;           /**< @brief Hilos con anillo propio. */
+    static constexpr int INTERVALO_VACIADO_MS = 50;   /**< @brief Cada cuánto se vacían los anillos. */
+
+private:
+    FILE* archivo;              /**< @brief Archivo de la traza, o `nullptr` (solo lo usa el hilo que vacía). */
+    uint64_t ticksBase;         /**< @brief Ticks al iniciar la traza (tiempo 0 del archivo). */
+    std::thread hilo;           /**< @brief Hilo que vacía los anillos. */
+    std::mutex mutex;           /**< @brief Protege `detener` para la variable de condición. */
+    std::condition_variable despertador; /**< @brief Despierta al hilo para que termine sin esperar. */
+    bool detener;               /**< @brief Pide al hilo que termine. */
+    unsigned long escritos;     /**< @brief Eventos escritos en el archivo. */
+    unsigned long descartados;  /**< @brief Eventos perdidos, sumados al cerrar. */
+
+    /**
+     * @brief Cuerpo del hilo: vacía los anillos cada INTERVALO_VACIADO_MS.
+     */
+    void ejecutar();
+
+    /**
+     * @brief Escribe en el archivo todos los eventos que hay ahora en los anillos.
+     * @return Eventos escritos.
+     */
+    size_t vaciarAnillos();
+
+public:
+    /**
+     * @brief Constructor de EscritorTraza. No inicia ninguna traza.
+     */
+    EscritorTraza();
+
+    /**
+     * @brief Destructor de EscritorTraza. Cierra la traza si sigue en curso.
+     */
+    ~EscritorTraza();
+
+    EscritorTraza(const EscritorTraza&) = delete;
+    EscritorTraza& operator=(const EscritorTraza&) = delete;
+
+    /**
+     * @brief Crea el archivo, reserva los anillos y lanza el hilo que los vacía.
+     * @details Debe llamarse antes de lanzar los hilos que registran.
+     * @param ruta Archivo de la traza.
+     * @return `true` si la traza quedó en curso.
+     */
+    bool iniciar(const char* ruta);
+
+    /**
+     * @brief Termina la traza: detiene el hilo, vuelca lo pendiente y cierra el archivo.
+     * @details Debe llamarse después de que terminen los hilos que registran.
+     */
+    void cerrar();
+
+    /**
+     * @brief Muestra cuántos eventos se escribieron y cuántos se descartaron.
+     * @details Llamar después de cerrar().
+     */
+    void imprimirResumen() const;
+};
+
+#endif // TRAZA_H
@@ -0,0 +1,269 @@
+/**
+ * @file TuberiaTramas.cpp
+ * @brief Implementación de la clase TuberiaTramas.
+ */
+
+#include "TuberiaTramas.h"
+#include "Metricas.h"
+#include "Traza.h"
+#include <chrono>
+#include <cstring>  // Para memcpy
+#include <iostream>
+#include <thread>
+
+/**
+ * @brief Espera un turno cuando un anillo está vacío o lleno.
+ *
+ * Primero cede el procesador unas cuantas veces (la otra etapa suele estar a
+ * punto de avanzar), después duerme brevemente y, si la espera se alarga
+ * (el puerto no envía nada), duerme más para no consumir CPU en reposo.
+ *
+ * @param intentos Intentos consecutivos; el llamador lo reinicia al avanzar.
+ */
+static void esperarTurno(unsigned int* intentos) {
+    if (++*intentos < 64) {
+        std::this_thread::yield();
+    } else if (*intentos < 64 + 500) {
+        std::this_thread::sleep_for(std::chrono::microseconds(200)); // ~100 ms con reacción rápida
+    } else {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+}
+
+TuberiaTramas::TuberiaTramas(FuenteTramas* fuente, ModoSalida modo, PoliticaContrapresion politica,
+                             SalidaTramas* salidas)
+    : fuente(fuente), modo(modo), politica(politica), salidas(salidas), detener(nullptr),
+      lineas(new AnilloSPSC<LineaCopiada, CAPACIDAD_LINEAS>()),
+      eventos(new AnilloSPSC<EventoSalida, CAPACIDAD_EVENTOS>()),
+      caracteres(new AnilloSPSC<char, CAPACIDAD_CARACTERES>()),
+      lecturaTerminada(false), decodificacionTerminada(false),
+      lineasLeidas(0), eventosDescartados(0) {}
+
+TuberiaTramas::~TuberiaTramas() {
+    delete lineas;
+    delete eventos;
+    delete caracteres;
+}
+
+void TuberiaTramas::etapaLectura() {
+    nombrarHiloTraza("lectura");
+    unsigned int intentos = 0;
+    VistaLinea linea;
+
+    while (detener == nullptr || !*detener) {
+        if (!fuente->leerLinea(&linea)) {
+            if (fuente->agotada()) {
+                break; // Fin de la captura o puerto desconectado
+            }
+            uint64_t inicioEspera = comenzarIntervalo();
+            fuente->esperarDatos(-1); // Dormir hasta que lleguen bytes o se pida detener
+            terminarIntervalo(TRAZA_ESPERA, inicioEspera, -1);
+            continue;
+        }
+        marcarInicioTrama();
+        lineasLeidas++;
+
+        // La vista solo es válida hasta la próxima lectura: copiarla al anillo
+        LineaCopiada* hueco;
+        while ((hueco = lineas->reservar()) == nullptr) {
+            esperarTurno(&intentos);
+        }
+        intentos = 0;
+        memcpy(hueco->datos, linea.datos, linea.longitud);
+        hueco->longitud = linea.longitud;
+        lineas->publicar();
+    }
+    lecturaTerminada.store(true, std::memory_order_release);
+}
+
+void TuberiaTramas::entregarCaracteres(const ListaDeCarga& carga, CursorCarga* cursor) {
+    char bloque[256];
+    while (cursor->entregados < carga.getLongitud()) {
+        size_t libres = caracteres->getEspacioLibre();
+        if (libres == 0) {
+            return;
+        }
+        size_t copiados = carga.copiarNuevos(cursor, bloque, libres < sizeof(bloque) ? libres : sizeof(bloque));
+        for (size_t i = 0; i < copiados; ++i) {
+            *caracteres->reservar() = bloque[i]; // Cabe: se comprobó el espacio libre
+            caracteres->publicar();
+        }
+    }
+}
+
+void TuberiaTramas::etapaDecodificacion(ListaDeCarga* carga, RotorDeMapeo* rotor) {
+    nombrarHiloTraza("decodificacion");
+    unsigned int intentos = 0;
+    unsigned long omitidos = 0;
+    unsigned long tramas = 0;
+    bool conCaracteres = modo != SALIDA_SILENCIOSA; // Solo la salida por trama necesita el mensaje
+    CursorCarga entregados;       // Caracteres de `carga` ya copiados al anillo `caracteres`
+    size_t longitudPublicada = 0; // Caracteres que necesitan los eventos ya publicados
+
+    while (true) {
+        LineaCopiada* copia = lineas->frente();
+        if (copia == nullptr) {
+            if (conCaracteres) {
+                entregarCaracteres(*carga, &entregados);
+            }
+            if (!lecturaTerminada.load(std::memory_order_acquire)) {
+                esperarTurno(&intentos);
+                continue;
+            }
+            // La lectura terminó: vaciar lo que haya quedado
+            copia = lineas->frente();
+            if (copia == nullptr) {
+                break;
+            }
+        }
+        intentos = 0;
+
+        marcarInicioEtapa();
+        uint64_t inicioTrama = comenzarIntervalo();
+        VistaLinea linea = {copia->datos, copia->longitud};
+        ResultadoLinea resultado;
+        procesarLinea(linea, carga, rotor, &resultado);
+        tramas++;
+        terminarIntervalo(TRAZA_TRAMA, inicioTrama, (int64_t)tramas, copia->datos, copia->longitud);
+
+        // En modo silencioso solo se muestran los errores
+        if (modo != SALIDA_SILENCIOSA || resultado.tipo == RESULTADO_INVALIDA) {
+            if (conCaracteres) {
+                entregarCaracteres(*carga, &entregados);
+            }
+
+            EventoSalida* evento = eventos->reservar();
+            if (evento == nullptr && politica == CONTRAPRESION_ESPERAR) {
+                while ((evento = eventos->reservar()) == nullptr) {
+                    // La salida puede estar esperando caracteres de un evento ya publicado
+                    if (conCaracteres) {
+                        entregarCaracteres(*carga, &entregados);
+                    }
+                    esperarTurno(&intentos);
+                }
+            }
+            if (evento != nullptr) {
+                memcpy(evento->linea.datos, copia->datos, copia->longitud);
+                evento->linea.longitud = copia->longitud;
+                evento->resultado = resultado;
+                evento->longitudMensaje = carga->getLongitud();
+                evento->trama = tramas;
+                evento->omitidos = omitidos;
+                eventos->publicar();
+                longitudPublicada = carga->getLongitud();
+                omitidos = 0;
+            } else {
+                omitidos++;
+                eventosDescartados++;
+            }
+            intentos = 0;
+        }
+        lineas->liberar();
+    }
+
+    // La salida aún puede necesitar caracteres para los últimos eventos publicados; los
+    // que solo corresponden a eventos descartados ya no hace falta entregarlos
+    while (conCaracteres && entregados.entregados < longitudPublicada) {
+        entregarCaracteres(*carga, &entregados);
+        esperarTurno(&intentos);
+    }
+    decodificacionTerminada.store(true, std::memory_order_release);
+}
+
+void TuberiaTramas::etapaSalida() {
+    ListaDeCarga espejo; // Copia del mensaje que pertenece solo a esta etapa
+    unsigned int intentos = 0;
+    bool salidaPendiente = false;
+    unsigned long ultimaTrama = 0;
+
+    while (true) {
+        EventoSalida* evento = eventos->frente();
+        if (evento == nullptr) {
+            // Nada que mostrar: vaciar lo acumulado antes de esperar
+            if (salidaPendiente) {
+                uint64_t inicioVaciado = comenzarIntervalo();
+                if (salidas != nullptr) {
+                    salidas->vaciar();
+                } else {
+                    std::cout.flush();
+                }
+                salidaPendiente = false;
+                terminarIntervalo(TRAZA_SALIDA, inicioVaciado, (int64_t)ultimaTrama, "flush", 5);
+            }
+            if (!decodificacionTerminada.load(std::memory_order_acquire)) {
+                esperarTurno(&intentos);
+                continue;
+            }
+            evento = eventos->frente();
+            if (evento == nullptr) {
+                break;
+            }
+        }
+        intentos = 0;
+
+        if (modo != SALIDA_SILENCIOSA) {
+            // La decodificación entrega los caracteres sin esperar a la salida, así que los
+            // de este evento pueden llegar después que él
+            while (espejo.getLongitud() < evento->longitudMensaje) {
+                char* c = caracteres->frente();
+                if (c == nullptr) {
+                    esperarTurno(&intentos);
+                    continue;
+                }
+                intentos = 0;
+                espejo.insertarAlFinal(*c);
+                caracteres->liberar();
+            }
+        }
+
+        marcarInicioEtapa();
+        uint64_t inicioSalida = comenzarIntervalo();
+        VistaLinea linea = {evento->linea.datos, evento->linea.longitud};
+        ultimaTrama = evento->trama;
+        if (salidas != nullptr) {
+            // Los huecos en la numeración de los registros muestran los eventos omitidos
+            salidas->registrar(evento->trama, linea, evento->resultado, &espejo);
+            salidaPendiente = true;
+        } else {
+            if (evento->omitidos > 0) {
+                std::cout << "[" << evento->omitidos << " tramas sin mostrar]\n";
+            }
+            if (mostrarResultado(linea, evento->resultado, modo, &espejo)) {
+                salidaPendiente = true;
+            }
+        }
+        terminarIntervalo(TRAZA_SALIDA, inicioSalida, (int64_t)ultimaTrama);
+        marcarEtapa(ETAPA_SALIDA);
+        eventos->liberar();
+    }
+    std::cout.flush();
+}
+
+void TuberiaTramas::ejecutar(ListaDeCarga* carga, RotorDeMapeo* rotor, volatile sig_atomic_t* detener) {
+    this->detener = detener;
+    lecturaTerminada.store(false);
+    decodificacionTerminada.store(false);
+
+    std::thread lector(&TuberiaTramas::etapaLectura, this);
+    std::thread decodificador(&TuberiaTramas::etapaDecodificacion, this, carga, rotor);
+    etapaSalida();
+    decodificador.join();
+    lector.join();
+}
+
+unsigned long TuberiaTramas::getLineasLeidas() const {
+    return lineasLeidas;
+}
+
+void TuberiaTramas::imprimirMetricas() const {
+    std::cout << "Tubería (ocupación máxima / media / reservas con el anillo lleno):" << std::endl;
+    std::cout << "  lectura -> decodificación: " << lineas->getOcupacionMaxima() << "/" << CAPACIDAD_LINEAS
+              << " / " << lineas->getOcupacionMedia() << " / " << lineas->getVecesLleno() << std::endl;
+    std::cout << "  decodificación -> salida:  " << eventos->getOcupacionMaxima() << "/" << CAPACIDAD_EVENTOS
+              << " / " << eventos->getOcupacionMedia() << " / " << eventos->getVecesLleno() << std::endl;
+    std::cout << "  caracteres decodificados:  " << caracteres->getOcupacionMaxima() << "/" << CAPACIDAD_CARACTERES
+              << " / " << caracteres->getOcupacionMedia() << " / " << caracteres->getVecesLleno() << std::endl;
+    if (politica == CONTRAPRESION_DESCARTAR) {
+        std::cout << "  Tramas sin mostrar: " << eventosDescartados << std::endl;
+    }
+}
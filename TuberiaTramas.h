@@ -0,0 +1,153 @@
+/**
+ * @file TuberiaTramas.h
+ * @brief Define la tubería de tres hilos lectura → decodificación → salida.
+ */
+
+#ifndef TUBERIA_TRAMAS_H
+#define TUBERIA_TRAMAS_H
+
+#include <atomic>
+#include <csignal>
+#include "AnilloSPSC.h"
+#include "FuenteTramas.h"
+#include "ParserTramas.h"
+#include "ProcesadorLineas.h"
+#include "SalidaTramas.h"
+
+/**
+ * @enum PoliticaContrapresion
+ * @brief Qué hace la etapa de decodificación cuando la etapa de salida no da abasto.
+ */
+enum PoliticaContrapresion {
+    CONTRAPRESION_ESPERAR,  /**< @brief Esperar a que la salida libere espacio (no se pierde nada). */
+    CONTRAPRESION_DESCARTAR /**< @brief No mostrar las tramas que no caben; la salida no frena la lectura. */
+};
+
+/**
+ * @struct LineaCopiada
+ * @brief Copia de una línea recibida, para que sobreviva a la siguiente lectura de la fuente.
+ */
+struct LineaCopiada {
+    char datos[LONGITUD_MAXIMA_LINEA]; /**< @brief Caracteres de la línea. */
+    size_t longitud;                   /**< @brief Número de caracteres. */
+};
+
+/**
+ * @struct EventoSalida
+ * @brief Lo que la etapa de decodificación envía a la etapa de salida por cada línea.
+ */
+struct EventoSalida {
+    LineaCopiada linea;        /**< @brief Línea recibida. */
+    ResultadoLinea resultado;  /**< @brief Resultado de procesarLinea(). */
+    size_t longitudMensaje;    /**< @brief Longitud del mensaje después de esta línea. */
+    unsigned long trama;       /**< @brief Número de la línea (desde 1). */
+    unsigned long omitidos;    /**< @brief Eventos descartados justo antes de este. */
+};
+
+/**
+ * @class TuberiaTramas
+ * @brief Separa en hilos la lectura de la fuente, la decodificación y la escritura en consola.
+ *
+ * - Lectura: copia cada línea de la fuente a un anillo SPSC.
+ * - Decodificación: es la única dueña del RotorDeMapeo y la ListaDeCarga.
+ * - Salida (hilo que llama a ejecutar()): escribe en `std::cout` o en los destinos de SalidaTramas.
+ *
+ * Las etapas se comunican con anillos AnilloSPSC acotados. Una consola lenta
+ * solo frena la lectura si la política es CONTRAPRESION_ESPERAR y ambos anillos
+ * se llenan; con CONTRAPRESION_DESCARTAR se dejan de mostrar tramas, pero el
+ * mensaje decodificado siempre está completo. Los caracteres decodificados
+ * viajan por un tercer anillo, de modo que la etapa de salida mantiene su propia
+ * copia del mensaje aunque se omitan eventos. La decodificación nunca espera a
+ * ese anillo: lo que no cabe queda en la ListaDeCarga y se entrega después (solo
+ * al terminar espera a que la salida reciba lo que piden los eventos publicados).
+ */
+class TuberiaTramas {
+public:
+    static const size_t CAPACIDAD_LINEAS = 1024;      /**< @brief Líneas entre lectura y decodificación. */
+    static const size_t CAPACIDAD_EVENTOS = 1024;     /**< @brief Eventos entre decodificación y salida. */
+    static const size_t CAPACIDAD_CARACTERES = 65536; /**< @brief Caracteres decodificados en tránsito. */
+
+private:
+    FuenteTramas* fuente;              /**< @brief Origen de las líneas. */
+    ModoSalida modo;                   /**< @brief Formato de la salida por trama. */
+    PoliticaContrapresion politica;    /**< @brief Política cuando el anillo de eventos está lleno. */
+    SalidaTramas* salidas;             /**< @brief Destinos de `--salida`, o `nullptr` para `std::cout`. */
+    volatile sig_atomic_t* detener;    /**< @brief Bandera de detención (Ctrl+C), o `nullptr`. */
+
+    AnilloSPSC<LineaCopiada, CAPACIDAD_LINEAS>* lineas;      /**< @brief Lectura → decodificación. */
+    AnilloSPSC<EventoSalida, CAPACIDAD_EVENTOS>* eventos;    /**< @brief Decodificación → salida. */
+    AnilloSPSC<char, CAPACIDAD_CARACTERES>* caracteres;      /**< @brief Decodificación → salida (sin pérdidas ni esperas). */
+
+    std::atomic<bool> lecturaTerminada;        /**< @brief La etapa de lectura ya no publicará más líneas. */
+    std::atomic<bool> decodificacionTerminada; /**< @brief La etapa de decodificación ya no publicará más. */
+    unsigned long lineasLeidas;                /**< @brief Líneas leídas de la fuente. */
+    unsigned long eventosDescartados;          /**< @brief Eventos no mostrados por CONTRAPRESION_DESCARTAR. */
+
+    /**
+     * @brief Etapa de lectura: copia las líneas de la fuente al anillo `lineas`.
+     */
+    void etapaLectura();
+
+    /**
+     * @brief (Decodificación) Copia al anillo `caracteres` lo que quepa del mensaje sin esperar.
+     * @param carga Mensaje ensamblado.
+     * @param cursor Caracteres de `carga` ya entregados; avanza con lo copiado.
+     */
+    void entregarCaracteres(const ListaDeCarga& carga, CursorCarga* cursor);
+
+    /**
+     * @brief Etapa de decodificación: procesa las líneas y publica eventos y caracteres.
+     * @param carga Lista donde se ensambla el mensaje.
+     * @param rotor Rotor de mapeo.
+     */
+    void etapaDecodificacion(ListaDeCarga* carga, RotorDeMapeo* rotor);
+
+    /**
+     * @brief Etapa de salida: muestra los eventos en consola o los pasa a los destinos.
+     */
+    void etapaSalida();
+
+public:
+    /**
+     * @brief Constructor de TuberiaTramas.
+     * @param fuente Origen de las líneas.
+     * @param modo Formato de la salida por trama.
+     * @param politica Política cuando la salida no da abasto.
+     * @param salidas Destinos de la salida por trama, o `nullptr` para escribir en `std::cout`.
+     */
+    TuberiaTramas(FuenteTramas* fuente, ModoSalida modo, PoliticaContrapresion politica, SalidaTramas* salidas = nullptr);
+
+    /**
+     * @brief Destructor de TuberiaTramas. Libera los anillos.
+     */
+    ~TuberiaTramas();
+
+    TuberiaTramas(const TuberiaTramas&) = delete;
+    TuberiaTramas& operator=(const TuberiaTramas&) = delete;
+
+    /**
+     * @brief Ejecuta la tubería hasta que la fuente se agota o se pide detener.
+     *
+     * Lanza los hilos de lectura y decodificación, ejecuta la etapa de salida en
+     * el hilo actual y regresa cuando las tres etapas terminaron.
+     *
+     * @param carga Lista donde se ensambla el mensaje.
+     * @param rotor Rotor de mapeo.
+     * @param detener Bandera que, al ponerse en 1, detiene la lectura (o `nullptr`).
+     */
+    void ejecutar(ListaDeCarga* carga, RotorDeMapeo* rotor, volatile sig_atomic_t* detener);
+
+    /**
+     * @brief Obtiene el número de líneas leídas de la fuente.
+     * @return Líneas leídas.
+     */
+    unsigned long getLineasLeidas() const;
+
+    /**
+     * @brief Muestra la ocupación de cada anillo y los eventos descartados.
+     * @details Llamar después de ejecutar().
+     */
+    void imprimirMetricas() const;
+};
+
+#endif // TUBERIA_TRAMAS_H
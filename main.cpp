@@ -2,238 +2,825 @@
  * @file main.cpp
  * @brief Programa principal para el decodificador de protocolo industrial PRT-7.
  *
- * Implementa la lógica principal de lectura de tramas desde un puerto serial REAL,
- * parseo, procesamiento polimórfico y ensamblaje del mensaje oculto.
+ * Implementa la lógica principal de lectura de tramas desde un puerto serial REAL
+ * (o desde una captura grabada),
+ * parseo, procesamiento de tramas y ensamblaje del mensaje oculto.
  */
 
 #include <iostream>
 #include <cstdlib>
+#include <cstring>
+#include <csignal>
+#include <chrono>
+#include <thread>
 
 // Inclusiones de las clases del proyecto
 #include "ListaDeCarga.h"
 #include "RotorDeMapeo.h"
-#include "TramaBase.h"
-#include "TramaLoad.h"
-#include "TramaMap.h"
+#include "PilaDeRotores.h"
+#include "ProcesadorLineas.h"
+#include "AgrupadorTramas.h"
+#include "TuberiaTramas.h"
+#include "GrupoSesiones.h"
 #include "SerialPort.h"
+#include "FuenteArchivo.h"
+#include "FuenteSecuenciada.h"
+#include "PuntoDeControl.h"
+#include "ParserTramas.h"
+#include "ArchivoMapeado.h"
+#include "DecodificadorLote.h"
+#include "IndiceCaptura.h"
+#include "ContadorAsignaciones.h"
+#include "Metricas.h"
+#include "Traza.h"
+#include "SalidaTramas.h"
 
 /**
- * @brief Implementación manual de strlen.
+ * @brief Se pone en 1 cuando el usuario pide detener el programa (Ctrl+C).
  */
-static size_t manual_strlen(const char* str) {
-    size_t len = 0;
-    while (str && str[len] != '\0') {
-        len++;
+static volatile sig_atomic_t detenerSolicitado = 0;
+
+/**
+ * @brief Fuente que se está leyendo, para despertarla desde el manejador de SIGINT.
+ */
+static FuenteTramas* volatile fuenteActiva = nullptr;
+
+/**
+ * @brief Grupo de sesiones en ejecución (modo multipuerto), para despertarlo desde el manejador.
+ */
+static GrupoSesiones* volatile grupoActivo = nullptr;
+
+/**
+ * @brief Manejador de SIGINT: marca la solicitud y despierta a quien espera datos;
+ *        el bucle principal termina solo.
+ */
+static void manejarInterrupcion(int) {
+    detenerSolicitado = 1;
+    if (fuenteActiva != nullptr) {
+        fuenteActiva->despertar();
+    }
+    if (grupoActivo != nullptr) {
+        grupoActivo->despertar();
     }
-    return len;
 }
 
 /**
- * @brief Convierte un entero a una cadena de caracteres.
+ * @brief Número máximo de puertos y capturas en el modo multipuerto.
  */
-char* itoa_custom(int val, char* buf) {
-    if (buf == nullptr) return nullptr;
+static const int MAXIMO_SESIONES = 256;
 
-    int i = 0;
-    int isNegative = 0;
+/**
+ * @struct OpcionesPrograma
+ * @brief Opciones leídas de la línea de comandos.
+ */
+struct OpcionesPrograma {
+    const char* rutaLote;  /**< @brief Captura a decodificar por lotes, o `nullptr`. */
+    const char* rutaIndexar; /**< @brief Captura a la que generarle el índice, o `nullptr`. */
+    const char* rutaConsulta; /**< @brief Captura indexada de la que decodificar un rango, o `nullptr`. */
+    unsigned long long consultaDesde; /**< @brief Primer carácter del rango a consultar. */
+    unsigned long long consultaHasta; /**< @brief Carácter siguiente al último del rango a consultar. */
+    const char* rutaArchivo; /**< @brief Captura a reproducir trama por trama ("-" = entrada estándar), o `nullptr`. */
+    ModoSalida modoSalida; /**< @brief Formato de la salida por trama. */
+    bool tuberia;          /**< @brief Leer, decodificar y mostrar en hilos separados. */
+    bool sondeo;           /**< @brief Sondear el puerto con VTIME en lugar de esperar con poll(). */
+    PoliticaContrapresion contrapresion; /**< @brief Política de la tubería cuando la consola no da abasto. */
+    const char* rutasSesion[MAXIMO_SESIONES]; /**< @brief Puertos y capturas del modo multipuerto. */
+    bool sesionEsPuerto[MAXIMO_SESIONES];     /**< @brief `true` si la ruta es un puerto serial. */
+    int numSesiones;       /**< @brief Número de rutas en `rutasSesion`. */
+    int numHilos;          /**< @brief Hilos trabajadores del modo multipuerto (0 = uno por núcleo). */
+    int numRotores;        /**< @brief Rotores de la pila (0 = un solo RotorDeMapeo). */
+    bool avance;           /**< @brief Avanzar la pila de rotores tras cada trama LOAD. */
+    int baudiosBinario;    /**< @brief Velocidad del formato binario a negociar con el Arduino (0 = solo ASCII). */
+    bool secuencia;        /**< @brief Validar y reordenar las tramas `F,<seq>,<cuerpo>,<crc>`. */
+    const char* rutaPuntoControl; /**< @brief Base de los archivos del punto de control, o `nullptr`. */
+    bool reanudar;         /**< @brief Continuar desde el punto de control en lugar de empezar de cero. */
+    const char* rutaMetricas; /**< @brief Archivo de Prometheus a mantener actualizado, o `nullptr`. */
+    const char* rutaTraza; /**< @brief Archivo de la traza de Chrome, o `nullptr`. */
+    FormatoSalida formatosSalida[SalidaTramas::MAXIMO_DESTINOS]; /**< @brief Formato de cada `--salida`. */
+    const char* rutasSalida[SalidaTramas::MAXIMO_DESTINOS];      /**< @brief Archivo de cada `--salida` ("-" = salida estándar). */
+    int numSalidas;        /**< @brief Destinos de `--salida` (0 = salida por trama en `std::cout`). */
+    TipoAlfabeto alfabeto; /**< @brief Alfabeto del rotor (`--alfabeto`). */
+};
+
+/**
+ * @brief Muestra la forma de uso del programa.
+ * @param programa Nombre con el que se invocó el programa.
+ */
+static void mostrarUso(const char* programa) {
+    std::cerr << "Uso: " << programa << " [opciones]" << std::endl;
+    std::cerr << "  --lote <captura>  Decodifica en paralelo una captura grabada." << std::endl;
+    std::cerr << "  --indexar <captura>  Genera <captura>.idx para consultar rangos del mensaje." << std::endl;
+    std::cerr << "  --consultar <captura> <desde> <hasta>" << std::endl;
+    std::cerr << "                    Decodifica solo los caracteres [desde, hasta) usando <captura>.idx." << std::endl;
+    std::cerr << "  --archivo <ruta>  Lee las tramas de una captura (\"-\" = entrada estándar) en lugar del puerto." << std::endl;
+    std::cerr << "  --incremental     Por cada trama, muestra solo los caracteres nuevos del mensaje." << std::endl;
+    std::cerr << "  --quiet           No muestra nada por trama; solo el mensaje final." << std::endl;
+    std::cerr << "  --pipeline        Lee, decodifica y muestra en hilos separados." << std::endl;
+    std::cerr << "  --sondeo          Sondea el puerto con VTIME en lugar de esperar eventos con poll()." << std::endl;
+    std::cerr << "  --puerto <disp>   Agrega un puerto serial al modo multipuerto (repetible)." << std::endl;
+    std::cerr << "  --captura <ruta>  Agrega una captura grabada al modo multipuerto (repetible)." << std::endl;
+    std::cerr << "  --hilos <N>       Hilos trabajadores del modo multipuerto (por defecto, uno por núcleo)." << std::endl;
+    std::cerr << "  --rotores <K>     Decodifica con una pila de K rotores (tramas M,<rotor>,N; máximo "
+              << PilaDeRotores::MAXIMO_ROTORES << ")." << std::endl;
+    std::cerr << "  --avance          Con --rotores: avanza la pila tras cada trama LOAD, con arrastre." << std::endl;
+    std::cerr << "  --binario [baud]  Negocia con el Arduino el formato binario compacto (por defecto 115200 baudios)." << std::endl;
+    std::cerr << "  --secuencia       Valida el CRC de las tramas F,<seq>,<cuerpo>,<crc> y las reordena." << std::endl;
+    std::cerr << "  --checkpoint <base>  Guarda el estado en <base>.chk y el mensaje en <base>.log cada "
+              << INTERVALO_PUNTO_CONTROL_MS << " ms." << std::endl;
+    std::cerr << "  --resume          Con --checkpoint: continúa desde el último punto de control." << std::endl;
+    std::cerr << "  --metricas <ruta> Escribe las métricas por etapa en formato Prometheus cada "
+              << ExportadorMetricas::INTERVALO_EXPORTACION_MS << " ms (requiere PRT7_METRICAS)." << std::endl;
+    std::cerr << "  --traza <ruta>    Guarda una traza por trama para chrome://tracing o Perfetto." << std::endl;
+    std::cerr << "  --salida <formato>[:<ruta>]" << std::endl;
+    std::cerr << "                    Escribe cada trama en segundo plano, en consola, jsonl o binario"
+              << " (repetible; sin ruta, en la salida estándar)." << std::endl;
+    std::cerr << "  --contrapresion <esperar|descartar>" << std::endl;
+    std::cerr << "                    Con --pipeline o --salida: esperar a la consola o dejar de mostrar tramas." << std::endl;
+    std::cerr << "  --alfabeto <latino|digitos|imprimible|bytes>" << std::endl;
+    std::cerr << "                    Alfabeto del rotor (por defecto latino: A-Z y espacio)." << std::endl;
+}
 
-    if (val == 0) {
-        buf[i++] = '0';
-        buf[i] = '\0';
-        return buf;
+/**
+ * @brief Lee las opciones de la línea de comandos.
+ * @param argc Número de argumentos.
+ * @param argv Argumentos del programa.
+ * @param opciones Salida: opciones leídas.
+ * @return `true` si todas las opciones son válidas, `false` en caso contrario.
+ */
+static bool leerOpciones(int argc, char* argv[], OpcionesPrograma* opciones) {
+    opciones->rutaLote = nullptr;
+    opciones->rutaIndexar = nullptr;
+    opciones->rutaConsulta = nullptr;
+    opciones->consultaDesde = 0;
+    opciones->consultaHasta = 0;
+    opciones->rutaArchivo = nullptr;
+    opciones->modoSalida = SALIDA_COMPLETA;
+    opciones->tuberia = false;
+    opciones->sondeo = false;
+    opciones->numSesiones = 0;
+    opciones->numHilos = 0;
+    opciones->numRotores = 0;
+    opciones->avance = false;
+    opciones->baudiosBinario = 0;
+    opciones->secuencia = false;
+    opciones->rutaPuntoControl = nullptr;
+    opciones->reanudar = false;
+    opciones->rutaMetricas = nullptr;
+    opciones->rutaTraza = nullptr;
+    opciones->numSalidas = 0;
+    opciones->contrapresion = CONTRAPRESION_ESPERAR;
+    opciones->alfabeto = ALFABETO_LATINO;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--lote") == 0 && i + 1 < argc) {
+            opciones->rutaLote = argv[++i];
+        } else if (strcmp(argv[i], "--indexar") == 0 && i + 1 < argc) {
+            opciones->rutaIndexar = argv[++i];
+        } else if (strcmp(argv[i], "--consultar") == 0 && i + 3 < argc) {
+            opciones->rutaConsulta = argv[++i];
+            opciones->consultaDesde = strtoull(argv[++i], nullptr, 10);
+            opciones->consultaHasta = strtoull(argv[++i], nullptr, 10);
+            if (opciones->consultaHasta <= opciones->consultaDesde) {
+                std::cerr << "Rango vacío: " << argv[i - 1] << " - " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (strcmp(argv[i], "--archivo") == 0 && i + 1 < argc) {
+            opciones->rutaArchivo = argv[++i];
+        } else if (strcmp(argv[i], "--incremental") == 0) {
+            opciones->modoSalida = SALIDA_INCREMENTAL;
+        } else if (strcmp(argv[i], "--quiet") == 0) {
+            opciones->modoSalida = SALIDA_SILENCIOSA;
+        } else if (strcmp(argv[i], "--pipeline") == 0) {
+            opciones->tuberia = true;
+        } else if (strcmp(argv[i], "--sondeo") == 0) {
+            opciones->sondeo = true;
+        } else if ((strcmp(argv[i], "--puerto") == 0 || strcmp(argv[i], "--captura") == 0) && i + 1 < argc) {
+            if (opciones->numSesiones == MAXIMO_SESIONES) {
+                std::cerr << "Demasiadas sesiones (máximo " << MAXIMO_SESIONES << ")." << std::endl;
+                return false;
+            }
+            opciones->sesionEsPuerto[opciones->numSesiones] = strcmp(argv[i], "--puerto") == 0;
+            opciones->rutasSesion[opciones->numSesiones++] = argv[++i];
+        } else if (strcmp(argv[i], "--hilos") == 0 && i + 1 < argc) {
+            opciones->numHilos = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--rotores") == 0 && i + 1 < argc) {
+            opciones->numRotores = atoi(argv[++i]);
+            if (opciones->numRotores < 1 || opciones->numRotores > PilaDeRotores::MAXIMO_ROTORES) {
+                std::cerr << "Número de rotores fuera de rango: " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (strcmp(argv[i], "--avance") == 0) {
+            opciones->avance = true;
+        } else if (strcmp(argv[i], "--binario") == 0) {
+            opciones->baudiosBinario = 115200;
+            if (i + 1 < argc && argv[i + 1][0] >= '0' && argv[i + 1][0] <= '9') {
+                opciones->baudiosBinario = atoi(argv[++i]);
+            }
+        } else if (strcmp(argv[i], "--secuencia") == 0) {
+            opciones->secuencia = true;
+        } else if (strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc) {
+            opciones->rutaPuntoControl = argv[++i];
+        } else if (strcmp(argv[i], "--resume") == 0) {
+            opciones->reanudar = true;
+        } else if (strcmp(argv[i], "--metricas") == 0 && i + 1 < argc) {
+            opciones->rutaMetricas = argv[++i];
+        } else if (strcmp(argv[i], "--traza") == 0 && i + 1 < argc) {
+            opciones->rutaTraza = argv[++i];
+        } else if (strcmp(argv[i], "--salida") == 0 && i + 1 < argc) {
+            if (opciones->numSalidas == SalidaTramas::MAXIMO_DESTINOS) {
+                std::cerr << "Demasiados destinos de salida (máximo " << SalidaTramas::MAXIMO_DESTINOS << ")." << std::endl;
+                return false;
+            }
+            int n = opciones->numSalidas;
+            if (!SalidaTramas::leerEspecificacion(argv[++i], &opciones->formatosSalida[n], &opciones->rutasSalida[n])) {
+                std::cerr << "Formato de salida no reconocido: " << argv[i] << std::endl;
+                return false;
+            }
+            for (int j = 0; j < n; ++j) {
+                if (opciones->formatosSalida[j] == FORMATO_CONSOLA && opciones->formatosSalida[n] == FORMATO_CONSOLA) {
+                    std::cerr << "--salida consola solo puede aparecer una vez." << std::endl;
+                    return false;
+                }
+            }
+            opciones->numSalidas++;
+        } else if (strcmp(argv[i], "--contrapresion") == 0 && i + 1 < argc) {
+            const char* politica = argv[++i];
+            if (strcmp(politica, "esperar") == 0) {
+                opciones->contrapresion = CONTRAPRESION_ESPERAR;
+            } else if (strcmp(politica, "descartar") == 0) {
+                opciones->contrapresion = CONTRAPRESION_DESCARTAR;
+            } else {
+                std::cerr << "Política de contrapresión no reconocida: " << politica << std::endl;
+                return false;
+            }
+        } else if (strcmp(argv[i], "--alfabeto") == 0 && i + 1 < argc) {
+            if (!leerAlfabeto(argv[++i], &opciones->alfabeto)) {
+                return false;
+            }
+        } else {
+            std::cerr << "Opción no reconocida: " << argv[i] << std::endl;
+            return false;
+        }
     }
 
-    if (val < 0) {
-        isNegative = 1;
-        val = -val;
+    if (opciones->avance && opciones->numRotores == 0) {
+        opciones->numRotores = 1; // --avance solo tiene sentido con la pila
+    }
+    if (opciones->numRotores > 0 && (opciones->rutaLote != nullptr || opciones->tuberia || opciones->numSesiones > 0)) {
+        std::cerr << "--rotores solo está disponible en el modo trama por trama." << std::endl;
+        return false;
+    }
+    if (opciones->secuencia && opciones->rutaLote != nullptr) {
+        std::cerr << "--secuencia no está disponible con --lote." << std::endl;
+        return false;
+    }
+    if (opciones->reanudar && opciones->rutaPuntoControl == nullptr) {
+        std::cerr << "--resume necesita --checkpoint <base>." << std::endl;
+        return false;
+    }
+    if (opciones->rutaPuntoControl != nullptr &&
+        (opciones->rutaLote != nullptr || opciones->tuberia || opciones->numSesiones > 0)) {
+        std::cerr << "--checkpoint solo está disponible en el modo trama por trama." << std::endl;
+        return false;
+    }
+    if (opciones->rutaTraza != nullptr &&
+        (opciones->rutaLote != nullptr || opciones->rutaIndexar != nullptr || opciones->rutaConsulta != nullptr)) {
+        std::cerr << "--traza no está disponible con --lote, --indexar ni --consultar." << std::endl;
+        return false;
+    }
+    if (opciones->numSalidas > 0 && (opciones->rutaLote != nullptr || opciones->rutaIndexar != nullptr ||
+                                      opciones->rutaConsulta != nullptr || opciones->numSesiones > 0)) {
+        std::cerr << "--salida solo está disponible en el modo trama por trama y con --pipeline." << std::endl;
+        return false;
+    }
+    if (opciones->numSalidas > 0 && opciones->modoSalida == SALIDA_SILENCIOSA) {
+        std::cerr << "--salida reemplaza la salida por trama: no se combina con --quiet." << std::endl;
+        return false;
+    }
+    // La pila, el formato binario, los puntos de control y el índice solo conocen A-Z y espacio
+    if (opciones->alfabeto != ALFABETO_LATINO &&
+        (opciones->numRotores > 0 || opciones->baudiosBinario > 0 || opciones->rutaPuntoControl != nullptr ||
+         opciones->rutaIndexar != nullptr || opciones->rutaConsulta != nullptr)) {
+        std::cerr << "--alfabeto " << describirAlfabeto(opciones->alfabeto).nombre
+                  << " no está disponible con --rotores, --binario, --checkpoint, --indexar ni --consultar." << std::endl;
+        return false;
+    }
+    if (opciones->rutaMetricas != nullptr && !metricasInstrumentadas()) {
+        std::cerr << "--metricas requiere compilar con -DPRT7_METRICAS=ON." << std::endl;
+        return false;
     }
+    return true;
+}
 
-    int start = 0;
-    while (val != 0) {
-        buf[i++] = (val % 10) + '0';
-        val /= 10;
+/**
+ * @brief Decodifica por lotes una captura grabada y muestra el mensaje final.
+ * @param ruta Ruta del archivo de captura (formato de líneas `L,X` / `M,N`).
+ * @param alfabeto Alfabeto del rotor.
+ * @return Código de salida del programa.
+ */
+static int ejecutarLote(const char* ruta, TipoAlfabeto alfabeto) {
+    ArchivoMapeado captura;
+    if (!captura.abrir(ruta)) {
+        return 1;
     }
 
-    if (isNegative) {
-        buf[i++] = '-';
+    ListaDeCarga miListaDeCarga;
+    RotorDeMapeo miRotorDeMapeo(alfabeto);
+    DecodificadorLote decodificador;
+
+    std::cout << "Decodificando por lotes " << ruta << " (" << captura.getLongitud() << " bytes, "
+              << decodificador.getNumHilos() << " hilos)..." << std::endl;
+    size_t caracteres = decodificador.decodificar(captura.getDatos(), captura.getLongitud(),
+                                                  &miListaDeCarga, &miRotorDeMapeo);
+
+    std::cout << "------------------------------------------" << std::endl;
+    std::cout << "Flujo de datos terminado (" << caracteres << " fragmentos)." << std::endl;
+    std::cout << "MENSAJE OCULTO ENSAMBLADO:" << std::endl;
+    miListaDeCarga.imprimirMensaje();
+    std::cout << std::endl;
+    std::cout << "Liberando memoria... Sistema apagado." << std::endl;
+    return 0;
+}
+
+/**
+ * @brief Arma la ruta del índice de una captura (`<captura>.idx`).
+ * @param captura Ruta de la captura.
+ * @return La ruta (liberar con free()), o `nullptr` si no hay memoria.
+ */
+static char* rutaDeIndice(const char* captura) {
+    size_t longitud = strlen(captura);
+    char* ruta = (char*)malloc(longitud + 5);
+    if (ruta != nullptr) {
+        memcpy(ruta, captura, longitud);
+        memcpy(ruta + longitud, ".idx", 5);
     }
+    return ruta;
+}
 
-    buf[i] = '\0';
+/**
+ * @brief Genera el índice disperso de una captura grabada.
+ * @param ruta Ruta del archivo de captura.
+ * @return Código de salida del programa.
+ */
+static int ejecutarIndexado(const char* ruta) {
+    ArchivoMapeado captura;
+    char* rutaIndice = rutaDeIndice(ruta);
+    if (rutaIndice == nullptr || !captura.abrir(ruta)) {
+        free(rutaIndice);
+        return 1;
+    }
 
-    // Invertir la cadena
-    int end = i - 1;
-    while (start < end) {
-        char temp = buf[start];
-        buf[start] = buf[end];
-        buf[end] = temp;
-        start++;
-        end--;
+    auto inicio = std::chrono::steady_clock::now();
+    uint64_t caracteres = 0;
+    uint64_t puntos = 0;
+    bool correcto = IndiceCaptura::construir(captura.getDatos(), captura.getLongitud(), rutaIndice, &caracteres, &puntos);
+    auto duracion = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - inicio);
+    if (correcto) {
+        std::cout << "Índice " << rutaIndice << ": " << puntos << " puntos cada " << INTERVALO_INDICE << " líneas, "
+                  << caracteres << " caracteres (" << duracion.count() << " ms)." << std::endl;
     }
-    return buf;
+    free(rutaIndice);
+    return correcto ? 0 : 1;
 }
 
 /**
- * @brief Parsea una línea de texto recibida y crea el objeto TramaBase correspondiente.
+ * @brief Decodifica un rango del mensaje de una captura ya indexada.
+ * @param ruta Ruta del archivo de captura.
+ * @param desde Primer carácter del rango.
+ * @param hasta Carácter siguiente al último del rango.
+ * @return Código de salida del programa.
  */
-TramaBase* parseLine(char* line, char* originalDataBuffer, int* rotationValue) {
-    if (line == nullptr || manual_strlen(line) < 3) {
-        originalDataBuffer[0] = '\0';
-        *rotationValue = 0;
-        return nullptr;
+static int ejecutarConsulta(const char* ruta, unsigned long long desde, unsigned long long hasta) {
+    ArchivoMapeado captura;
+    IndiceCaptura indice;
+    char* rutaIndice = rutaDeIndice(ruta);
+    bool abierto = rutaIndice != nullptr && captura.abrir(ruta) && indice.abrir(rutaIndice, captura.getLongitud());
+    free(rutaIndice);
+    if (!abierto) {
+        return 1;
+    }
+    if (hasta > indice.getTotalCaracteres()) {
+        hasta = indice.getTotalCaracteres();
+    }
+    if (desde >= hasta) {
+        std::cerr << "El mensaje tiene " << indice.getTotalCaracteres() << " caracteres." << std::endl;
+        return 1;
     }
 
-    char type = line[0];
+    char* salida = (char*)malloc((size_t)(hasta - desde));
+    if (salida == nullptr) {
+        return 1;
+    }
+    auto inicio = std::chrono::steady_clock::now();
+    size_t escritos = indice.consultar(captura.getDatos(), desde, hasta, salida);
+    auto duracion = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - inicio);
 
-    // Verificar que hay una coma en la posición correcta
-    if (line[1] != ',') {
-        originalDataBuffer[0] = '\0';
-        *rotationValue = 0;
-        return nullptr;
+    std::cout << "Caracteres " << desde << " a " << desde + escritos << " de " << indice.getTotalCaracteres()
+              << " (" << duracion.count() << " us):" << std::endl;
+    std::cout.write(salida, (std::streamsize)escritos);
+    std::cout << std::endl;
+    free(salida);
+    return 0;
+}
+
+/**
+ * @brief Reúne el estado del decodificador para un punto de control.
+ * @param tramas Líneas procesadas.
+ * @param captura Captura que se reproduce, o `nullptr` si se lee del puerto.
+ * @param secuenciada Ventana de reordenamiento, o `nullptr` sin `--secuencia`.
+ * @param rotor Rotor único.
+ * @param pila Pila de rotores, o `nullptr` si se usa el rotor único.
+ * @param estado Salida: estado reunido (sin `longitudMensaje`).
+ * @return `false` si la ventana retiene tramas: el estado no marcaría dónde seguir.
+ */
+static bool reunirEstado(unsigned long tramas, const FuenteArchivo* captura, const FuenteSecuenciada* secuenciada,
+                         const RotorDeMapeo& rotor, const PilaDeRotores* pila, EstadoDecodificador* estado) {
+    if (secuenciada != nullptr && !secuenciada->sinRetenidas()) {
+        return false;
     }
+    estado->tramas = tramas;
+    estado->posicion = captura != nullptr ? captura->getPosicion() : 0;
+    estado->secuencia = secuenciada != nullptr ? secuenciada->getSiguiente() : -1;
+    estado->longitudMensaje = 0;
+    if (pila != nullptr) {
+        estado->numRotores = pila->getNumRotores();
+        for (int r = 0; r < estado->numRotores; ++r) {
+            estado->desplazamientos[r] = pila->getDesplazamiento(r);
+        }
+    } else {
+        estado->numRotores = 1;
+        estado->desplazamientos[0] = rotor.getDesplazamiento();
+    }
+    return true;
+}
 
-    char* token = line + 2; // Avanzar 2 posiciones para saltar "X,"
+/**
+ * @brief Detiene el exportador de métricas y la traza y muestra sus resúmenes.
+ * @details Sin métricas compiladas ni `--traza` no muestra nada.
+ * @param exportador Exportador lanzado al empezar a decodificar.
+ * @param traza Traza en curso.
+ * @param rutaTraza Archivo de la traza, o `nullptr` si no se pidió.
+ */
+static void cerrarInstrumentacion(ExportadorMetricas* exportador, EscritorTraza* traza, const char* rutaTraza) {
+    exportador->detenerYExportar();
+    if (metricasInstrumentadas()) {
+        volcarMetricas(std::cout);
+    }
+    if (rutaTraza != nullptr) {
+        traza->cerrar();
+        traza->imprimirResumen();
+    }
+}
 
-    if (type == 'L') {
-        char dataChar = *token;
-        // Manejar el caso especial del espacio
-        if (dataChar == '\0' || dataChar == ' ') {
-            dataChar = ' '; // Asegurar que sea un espacio
+/**
+ * @brief Decodifica a la vez varios puertos y capturas, cada uno con su propio rotor y mensaje.
+ * @param opciones Opciones con las rutas de las sesiones.
+ * @param exportador Exportador de métricas, ya lanzado.
+ * @param traza Traza en curso (si se pidió `--traza`).
+ * @return Código de salida del programa.
+ */
+static int ejecutarSesiones(const OpcionesPrograma& opciones, ExportadorMetricas* exportador, EscritorTraza* traza) {
+    GrupoSesiones grupo(opciones.numHilos);
+    SerialPort* puertos[MAXIMO_SESIONES];
+    int numPuertos = 0;
+    FuenteSecuenciada* secuenciadas[MAXIMO_SESIONES];
+
+    for (int i = 0; i < opciones.numSesiones; ++i) {
+        const char* ruta = opciones.rutasSesion[i];
+        FuenteTramas* fuente = nullptr;
+        if (opciones.sesionEsPuerto[i]) {
+            SerialPort* puerto = new SerialPort();
+            // Sin esperar el reinicio aquí: se espera una sola vez por todos los puertos
+            if (!puerto->open(ruta, 9600, false)) {
+                delete puerto;
+                continue;
+            }
+            fuente = puerto;
+            puertos[numPuertos++] = puerto;
+        } else {
+            FuenteArchivo* captura = new FuenteArchivo();
+            if (!captura->abrir(ruta)) {
+                std::cerr << "ERROR: No se pudo abrir la captura " << ruta << std::endl;
+                delete captura;
+                continue;
+            }
+            fuente = captura;
         }
-        originalDataBuffer[0] = dataChar;
-        originalDataBuffer[1] = '\0';
-        *rotationValue = 0;
-        return new TramaLoad(dataChar);
-    } else if (type == 'M') {
-        int sign = 1;
-        if (*token == '-') {
-            sign = -1;
-            token++;
-        } else if (*token == '+') {
-            token++;
+        if (opciones.secuencia) {
+            FuenteSecuenciada* secuenciada = new FuenteSecuenciada(fuente, true);
+            secuenciadas[grupo.getNumSesiones()] = secuenciada;
+            fuente = secuenciada;
+        }
+        grupo.agregar(new SesionDecodificacion(ruta, fuente, opciones.alfabeto));
+    }
+    if (grupo.getNumSesiones() == 0) {
+        std::cerr << "ERROR: No se pudo abrir ninguna fuente." << std::endl;
+        return 1;
+    }
+    if (numPuertos > 0) {
+        std::cout << "Esperando el reinicio de los Arduino..." << std::endl;
+        std::this_thread::sleep_for(std::chrono::seconds(2));
+    }
+    if (opciones.baudiosBinario > 0) {
+        // Un puerto que no responde a tiempo sigue en ASCII
+        for (int i = 0; i < numPuertos; ++i) {
+            puertos[i]->negociarBinario(opciones.baudiosBinario);
         }
+    }
+
+    std::cout << "Decodificando " << grupo.getNumSesiones() << " fuentes. Presiona Ctrl+C para detener." << std::endl;
+    grupoActivo = &grupo;
+    std::signal(SIGINT, manejarInterrupcion);
+    std::chrono::steady_clock::time_point inicio = std::chrono::steady_clock::now();
+    grupo.ejecutar(&detenerSolicitado);
+    double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+    grupoActivo = nullptr;
 
-        int rot = 0;
-        while (*token >= '0' && *token <= '9') {
-            rot = rot * 10 + (*token - '0');
-            token++;
+    unsigned long totalTramas = 0;
+    std::cout << "------------------------------------------" << std::endl;
+    for (size_t i = 0; i < grupo.getNumSesiones(); ++i) {
+        SesionDecodificacion* sesion = grupo.getSesion(i);
+        totalTramas += sesion->getTramas();
+        std::cout << "[" << sesion->getNombre() << "] " << sesion->getTramas() << " tramas, "
+                  << sesion->getErrores() << " errores. MENSAJE OCULTO ENSAMBLADO:" << std::endl;
+        sesion->getCarga()->imprimirMensaje();
+        std::cout << std::endl;
+        if (opciones.secuencia) {
+            secuenciadas[i]->imprimirContadores();
         }
-        *rotationValue = rot * sign;
-        originalDataBuffer[0] = '\0';
-        return new TramaMap(*rotationValue);
     }
-    originalDataBuffer[0] = '\0';
-    *rotationValue = 0;
-    return nullptr;
+    std::cout << "Total: " << totalTramas << " tramas en " << segundos << " s con "
+              << grupo.getNumTrabajadores() << " hilos";
+    if (segundos > 0) {
+        std::cout << " (" << (double)totalTramas / segundos / 1e6 << " M tramas/s)";
+    }
+    std::cout << "." << std::endl;
+    cerrarInstrumentacion(exportador, traza, opciones.rutaTraza);
+    std::cout << "Liberando memoria... Sistema apagado." << std::endl;
+    return 0;
 }
 
 /**
  * @brief Función principal del programa.
+ *
+ * Uso:
+ * - Sin argumentos: modo interactivo, lee tramas desde un puerto serial.
+ * - `--lote <captura>`: decodifica en paralelo una captura grabada.
+ * - `--indexar <captura>` / `--consultar <captura> <desde> <hasta>`: índice disperso (ver IndiceCaptura).
+ * - `--archivo <ruta>`: reproduce una captura (o la entrada estándar) trama por trama.
+ * - `--incremental` / `--quiet`: reducen la salida por trama (ver mostrarUso()).
+ * - `--pipeline`: lectura, decodificación y salida en hilos separados (ver TuberiaTramas).
+ * - `--puerto <disp>` / `--captura <ruta>` (repetibles): modo multipuerto (ver GrupoSesiones).
+ * - `--rotores <K>` / `--avance`: decodifica con una pila de rotores (ver PilaDeRotores).
+ * - `--secuencia`: valida y reordena las tramas con secuencia y CRC (ver FuenteSecuenciada).
+ * - `--checkpoint <base>` / `--resume`: guarda el estado periódicamente y lo retoma (ver PuntoDeControl).
+ * - `--metricas <ruta>`: exporta las métricas por etapa en formato Prometheus (ver Metricas.h).
+ * - `--traza <ruta>`: guarda una traza por trama en el formato de Chrome (ver Traza.h).
+ * - `--salida <formato>[:<ruta>]` (repetible): salida por trama en segundo plano (ver SalidaTramas).
+ * - `--alfabeto <nombre>`: alfabeto del rotor (ver Alfabetos.h).
  */
-int main() {
+int main(int argc, char* argv[]) {
+    OpcionesPrograma opciones;
+    if (!leerOpciones(argc, argv, &opciones)) {
+        mostrarUso(argv[0]);
+        return 1;
+    }
+    if (opciones.rutaLote != nullptr) {
+        return ejecutarLote(opciones.rutaLote, opciones.alfabeto);
+    }
+    if (opciones.rutaIndexar != nullptr) {
+        return ejecutarIndexado(opciones.rutaIndexar);
+    }
+    if (opciones.rutaConsulta != nullptr) {
+        return ejecutarConsulta(opciones.rutaConsulta, opciones.consultaDesde, opciones.consultaHasta);
+    }
+    // Con PRT7_METRICAS: SIGUSR1 vuelca las métricas en stderr y, con --metricas, se exportan
+    ExportadorMetricas exportador;
+    exportador.iniciar(opciones.rutaMetricas);
+    EscritorTraza traza;
+    if (opciones.rutaTraza != nullptr && !traza.iniciar(opciones.rutaTraza)) {
+        return 1;
+    }
+    if (opciones.numSesiones > 0) {
+        return ejecutarSesiones(opciones, &exportador, &traza);
+    }
+    ModoSalida modoSalida = opciones.modoSalida;
+
     std::cout << "==================================================" << std::endl;
     std::cout << "           DECODIFICADOR DE PROTOCOLO             " << std::endl;
     std::cout << "==================================================" << std::endl;
     std::cout << std::endl;
 
-    // Solicitar el puerto COM al usuario
-    std::cout << "Ingrese el nombre del puerto serial:" << std::endl;
-    std::cout << "  - Windows: COM3, COM4, etc." << std::endl;
-    std::cout << "  - Linux: /dev/ttyUSB0, /dev/ttyACM0, etc." << std::endl;
-    std::cout << "  - macOS: /dev/tty.usbserial-*, /dev/tty.usbmodem*, etc." << std::endl;
-    std::cout << std::endl;
-    std::cout << "Puerto: ";
-
-    char portName[50];
-    std::cin.getline(portName, 50);
+    SerialPort serial;
+    FuenteArchivo captura;
+    FuenteTramas* fuente = nullptr;
+
+    if (opciones.rutaArchivo != nullptr) {
+        // Reproducir una captura grabada: sin puerto ni espera de reinicio del Arduino
+        std::cout << "Iniciando Decodificador PRT-7. Reproduciendo captura " << opciones.rutaArchivo << "..." << std::endl;
+        if (!captura.abrir(opciones.rutaArchivo)) {
+            std::cerr << "ERROR: No se pudo abrir la captura " << opciones.rutaArchivo << std::endl;
+            return 1;
+        }
+        fuente = &captura;
+    } else {
+        // Solicitar el puerto COM al usuario
+        std::cout << "Ingrese el nombre del puerto serial:" << std::endl;
+        std::cout << "  - Windows: COM3, COM4, etc." << std::endl;
+        std::cout << "  - Linux: /dev/ttyUSB0, /dev/ttyACM0, etc." << std::endl;
+        std::cout << "  - macOS: /dev/tty.usbserial-*, /dev/tty.usbmodem*, etc." << std::endl;
+        std::cout << std::endl;
+        std::cout << "Puerto: ";
+
+        char portName[50];
+        std::cin.getline(portName, 50);
+
+        std::cout << std::endl;
+        std::cout << "Iniciando Decodificador PRT-7. Conectando a puerto " << portName << "..." << std::endl;
+
+        serial.setModoEventos(!opciones.sondeo);
+        if (!serial.open(portName, 9600)) {
+            std::cerr << std::endl;
+            std::cerr << "ERROR: No se pudo abrir el puerto serial." << std::endl;
+            std::cerr << "Verifica que:" << std::endl;
+            std::cerr << "  1. El Arduino esté conectado" << std::endl;
+            std::cerr << "  2. El nombre del puerto sea correcto" << std::endl;
+            std::cerr << "  3. Tengas permisos suficientes (en Linux, agrega tu usuario al grupo 'dialout')" << std::endl;
+            return 1;
+        }
+        fuente = &serial;
 
-    std::cout << std::endl;
-    std::cout << "Iniciando Decodificador PRT-7. Conectando a puerto " << portName << "..." << std::endl;
+        if (opciones.baudiosBinario > 0 && !serial.negociarBinario(opciones.baudiosBinario)) {
+            std::cout << "El Arduino no aceptó el formato binario; se continúa en ASCII." << std::endl;
+        }
 
-    SerialPort serial;
-    if (!serial.open(portName, 9600)) {
-        std::cerr << std::endl;
-        std::cerr << "ERROR: No se pudo abrir el puerto serial." << std::endl;
-        std::cerr << "Verifica que:" << std::endl;
-        std::cerr << "  1. El Arduino esté conectado" << std::endl;
-        std::cerr << "  2. El nombre del puerto sea correcto" << std::endl;
-        std::cerr << "  3. Tengas permisos suficientes (en Linux, agrega tu usuario al grupo 'dialout')" << std::endl;
-        return 1;
+        std::cout << "Esperando tramas del Arduino..." << std::endl;
+        std::cout << std::endl;
     }
 
-    std::cout << "Esperando tramas del Arduino..." << std::endl;
-    std::cout << std::endl;
+    // La ventana de reordenamiento va delante de todo el procesamiento
+    FuenteSecuenciada secuenciada(fuente, false);
+    if (opciones.secuencia) {
+        fuente = &secuenciada;
+    }
 
     ListaDeCarga miListaDeCarga;
-    RotorDeMapeo miRotorDeMapeo;
-
-    char* receivedLine;
-    char originalCharBuffer[2];
-    int rotationAmount = 0;
-    bool running = true;
-
-    std::cout << std::endl;
-    std::cout << "Presiona 'Q' + ENTER en cualquier momento para detener el programa." << std::endl;
-    std::cout << std::endl;
-
-    while (running) {
-        receivedLine = serial.readLine();
-
-        if (receivedLine == nullptr) {
-            // No hay datos disponibles, continuar esperando
-            continue;
+    RotorDeMapeo miRotorDeMapeo(opciones.alfabeto);
+    PilaDeRotores miPilaDeRotores(opciones.numRotores, opciones.avance);
+    bool usarPila = opciones.numRotores > 0;
+    AgrupadorTramas agrupador(&miListaDeCarga, &miRotorDeMapeo);
+    bool agrupar = modoSalida == SALIDA_SILENCIOSA && !usarPila; // Sin salida por trama: decodificar por rachas
+
+    unsigned long tramasRecibidas = 0;
+
+    // Punto de control: ubicar la captura, los rotores y la ventana donde quedaron
+    PuntoDeControl puntoDeControl;
+    const FuenteArchivo* capturaPunto = opciones.rutaArchivo != nullptr ? &captura : nullptr;
+    const FuenteSecuenciada* secuenciadaPunto = opciones.secuencia ? &secuenciada : nullptr;
+    const PilaDeRotores* pilaPunto = usarPila ? &miPilaDeRotores : nullptr;
+    EstadoDecodificador estado;
+    if (opciones.reanudar) {
+        auto inicioCarga = std::chrono::steady_clock::now();
+        if (!PuntoDeControl::cargar(opciones.rutaPuntoControl, &estado, &miListaDeCarga)) {
+            return 1;
         }
-
-        // Ignorar líneas que no son tramas (mensajes del Arduino)
-        if (receivedLine[0] != 'L' && receivedLine[0] != 'M') {
-            // Es un mensaje informativo del Arduino, no una trama
-            std::cout << "[INFO Arduino]: " << receivedLine << std::endl;
-            free(receivedLine);
-            continue;
+        if (estado.numRotores != (usarPila ? opciones.numRotores : 1)) {
+            std::cerr << "ERROR: El punto de control es de " << estado.numRotores << " rotores." << std::endl;
+            return 1;
         }
+        if (capturaPunto != nullptr && !captura.saltarHasta((size_t)estado.posicion)) {
+            std::cerr << "ERROR: La captura es más corta que la posición del punto de control." << std::endl;
+            return 1;
+        }
+        if (usarPila) {
+            for (int r = 0; r < estado.numRotores; ++r) {
+                miPilaDeRotores.rotar(r, estado.desplazamientos[r] - miPilaDeRotores.getDesplazamiento(r));
+            }
+        } else {
+            miRotorDeMapeo.rotar(estado.desplazamientos[0] - miRotorDeMapeo.getDesplazamiento());
+        }
+        if (opciones.secuencia && estado.secuencia >= 0) {
+            secuenciada.reanudarEn((uint16_t)estado.secuencia);
+        }
+        tramasRecibidas = (unsigned long)estado.tramas;
+        auto duracion = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - inicioCarga);
+        std::cout << "Reanudando desde " << opciones.rutaPuntoControl << ".chk: " << estado.tramas << " tramas, "
+                  << estado.longitudMensaje << " caracteres del mensaje (" << duracion.count() << " us)." << std::endl;
+    } else {
+        reunirEstado(0, capturaPunto, secuenciadaPunto, miRotorDeMapeo, pilaPunto, &estado);
+    }
+    if (opciones.rutaPuntoControl != nullptr &&
+        !puntoDeControl.abrir(opciones.rutaPuntoControl, opciones.reanudar, estado, miListaDeCarga)) {
+        return 1;
+    }
+    unsigned long tramasEnPunto = tramasRecibidas; // Tramas que ya cubre el último punto de control
 
-        TramaBase* trama = parseLine(receivedLine, originalCharBuffer, &rotationAmount);
+    unsigned long asignacionesIniciales = getAsignaciones();
 
-        std::cout << "Trama recibida: [" << receivedLine << "] -> Procesando... -> ";
+    // Los destinos de --salida se abren después de todo lo que se escribe con std::cout antes de empezar
+    SalidaTramas salidas(modoSalida, opciones.contrapresion == CONTRAPRESION_DESCARTAR);
 
-        if (trama != nullptr) {
-            // Usar dynamic_cast para determinar el tipo real de la trama
-            if (dynamic_cast<TramaLoad*>(trama) != nullptr) {
-                char originalInputChar = originalCharBuffer[0];
-                char decodedChar = miRotorDeMapeo.getMapeo(originalInputChar);
-                trama->procesar(&miListaDeCarga, &miRotorDeMapeo);
+    std::cout << std::endl;
+    std::cout << "Presiona Ctrl+C en cualquier momento para detener el programa y ver el mensaje." << std::endl;
+    std::cout << std::endl;
+    for (int i = 0; i < opciones.numSalidas; ++i) {
+        if (!salidas.agregar(opciones.formatosSalida[i], opciones.rutasSalida[i])) {
+            return 1;
+        }
+    }
 
-                // Mostrar el carácter de forma legible
-                if (originalInputChar == ' ') {
-                    std::cout << "Fragmento 'Space' decodificado como '";
-                } else {
-                    std::cout << "Fragmento '" << originalInputChar << "' decodificado como '";
+    fuenteActiva = fuente;
+    std::signal(SIGINT, manejarInterrupcion);
+
+    if (opciones.tuberia) {
+        TuberiaTramas tuberia(fuente, modoSalida, opciones.contrapresion, salidas.activa() ? &salidas : nullptr);
+        tuberia.ejecutar(&miListaDeCarga, &miRotorDeMapeo, &detenerSolicitado);
+        salidas.cerrar();
+        tramasRecibidas = tuberia.getLineasLeidas();
+        tuberia.imprimirMetricas();
+    } else {
+        VistaLinea linea;
+        ResultadoLinea resultado;
+        bool salidaPendiente = false;
+
+        while (!detenerSolicitado) {
+            // Cada 256 tramas (y en los ratos sin datos) ver si toca un punto de control; se
+            // toma aquí porque todo lo leído ya está procesado
+            bool puntoPendiente = puntoDeControl.estaActivo() && tramasRecibidas != tramasEnPunto;
+            if (puntoPendiente && (tramasRecibidas & 0xFF) == 0 && puntoDeControl.vencido()) {
+                uint64_t inicioPunto = comenzarIntervalo();
+                agrupador.vaciar();
+                if (reunirEstado(tramasRecibidas, capturaPunto, secuenciadaPunto, miRotorDeMapeo, pilaPunto, &estado) &&
+                    puntoDeControl.registrar(estado, miListaDeCarga)) {
+                    tramasEnPunto = tramasRecibidas;
                 }
-
-                if (decodedChar == ' ') {
-                    std::cout << "Space";
-                } else {
-                    std::cout << decodedChar;
+                terminarIntervalo(TRAZA_PUNTO_CONTROL, inicioPunto, (int64_t)tramasRecibidas);
+            }
+            if (!fuente->leerLinea(&linea)) {
+                if (fuente->agotada()) {
+                    break; // Fin de la captura o puerto desconectado
                 }
-                std::cout << "'. ";
-
-            } else if (dynamic_cast<TramaMap*>(trama) != nullptr) {
-                trama->procesar(&miListaDeCarga, &miRotorDeMapeo);
-                char buffer[10];
-                std::cout << "ROTANDO ROTOR " << itoa_custom(rotationAmount, buffer) << ". ";
-                std::cout << "(Ahora 'A' se mapea a '" << miRotorDeMapeo.getMapeo('A') << "') ";
+                // No hay datos disponibles: mostrar lo acumulado y dormir hasta que lleguen
+                agrupador.vaciar();
+                if (salidaPendiente) {
+                    uint64_t inicioVaciado = comenzarIntervalo();
+                    if (salidas.activa()) {
+                        salidas.vaciar();
+                    } else {
+                        std::cout.flush();
+                    }
+                    salidaPendiente = false;
+                    terminarIntervalo(TRAZA_SALIDA, inicioVaciado, (int64_t)tramasRecibidas, "flush", 5);
+                }
+                if (puntoPendiente && puntoDeControl.vencido() &&
+                    reunirEstado(tramasRecibidas, capturaPunto, secuenciadaPunto, miRotorDeMapeo, pilaPunto, &estado) &&
+                    puntoDeControl.registrar(estado, miListaDeCarga)) {
+                    tramasEnPunto = tramasRecibidas;
+                    puntoPendiente = false;
+                }
+                // Con un punto de control pendiente, despertar a tiempo para tomarlo
+                int plazo = puntoPendiente ? INTERVALO_PUNTO_CONTROL_MS : -1;
+                uint64_t inicioEspera = comenzarIntervalo();
+                fuente->esperarDatos(plazo);
+                terminarIntervalo(TRAZA_ESPERA, inicioEspera, plazo);
+                continue;
             }
-
-            // Imprimir el estado actual del mensaje ensamblado
-            std::cout << "Mensaje: [";
-            miListaDeCarga.imprimirMensaje();
-            std::cout << "]" << std::endl;
-
-            delete trama;
-        } else {
-            std::cerr << "Error: No se pudo parsear la trama: " << receivedLine << std::endl;
+            // La línea apunta al buffer de la fuente: es válida hasta la próxima lectura
+            marcarInicioTrama();
+            uint64_t inicioTrama = comenzarIntervalo();
+            tramasRecibidas++;
+
+            if (agrupar) {
+                TipoLinea tipo = agrupador.agregar(linea);
+                terminarIntervalo(TRAZA_TRAMA, inicioTrama, (int64_t)tramasRecibidas, linea.datos, linea.longitud);
+                if (tipo == LINEA_INVALIDA) {
+                    resultado.tipo = RESULTADO_INVALIDA;
+                    mostrarResultado(linea, resultado, modoSalida, &miListaDeCarga);
+                }
+                continue;
+            }
+            if (usarPila) {
+                procesarLinea(linea, &miListaDeCarga, &miPilaDeRotores, &resultado);
+            } else {
+                procesarLinea(linea, &miListaDeCarga, &miRotorDeMapeo, &resultado);
+            }
+            terminarIntervalo(TRAZA_TRAMA, inicioTrama, (int64_t)tramasRecibidas, linea.datos, linea.longitud);
+            uint64_t inicioSalida = comenzarIntervalo();
+            if (salidas.activa()) {
+                salidas.registrar(tramasRecibidas, linea, resultado, &miListaDeCarga);
+                salidaPendiente = true;
+            } else if (mostrarResultado(linea, resultado, modoSalida, &miListaDeCarga)) {
+                salidaPendiente = true;
+            }
+            terminarIntervalo(TRAZA_SALIDA, inicioSalida, (int64_t)tramasRecibidas);
+            marcarEtapa(ETAPA_SALIDA);
         }
-
-        free(receivedLine);
+        agrupador.vaciar();
+        salidas.cerrar();
+    }
+    if (puntoDeControl.estaActivo()) {
+        bool exacto = reunirEstado(tramasRecibidas, capturaPunto, secuenciadaPunto, miRotorDeMapeo, pilaPunto, &estado);
+        puntoDeControl.cerrar(exacto ? &estado : nullptr, miListaDeCarga);
     }
 
     std::cout << std::endl;
@@ -242,6 +829,23 @@ int main() {
     std::cout << "MENSAJE OCULTO ENSAMBLADO:" << std::endl;
     miListaDeCarga.imprimirMensaje();
     std::cout << std::endl;
+    if (serial.esBinario() || serial.getTramasBinarias() > 0) {
+        std::cout << "Tramas binarias: " << serial.getTramasBinarias() << " (descartes por ruido o CRC: "
+                  << serial.getDescartesBinarios() << ")." << std::endl;
+    }
+    if (opciones.secuencia) {
+        secuenciada.imprimirContadores();
+    }
+    if (opciones.rutaPuntoControl != nullptr) {
+        puntoDeControl.imprimirResumen();
+    }
+    salidas.imprimirResumen();
+    if (asignacionesInstrumentadas() && tramasRecibidas > 0) {
+        unsigned long asignaciones = getAsignaciones() - asignacionesIniciales;
+        std::cout << "Asignaciones de memoria: " << asignaciones << " en " << tramasRecibidas
+                  << " tramas (" << (double)asignaciones / tramasRecibidas << " por trama)." << std::endl;
+    }
+    cerrarInstrumentacion(&exportador, &traza, opciones.rutaTraza);
     std::cout << "Liberando memoria... Sistema apagado." << std::endl;
 
     return 0;
@@ -0,0 +1,1319 @@
+/**
+ * @file prt7_bench.cpp
+ * @brief Pruebas de rendimiento de los componentes del decodificador PRT-7 (objetivo `prt7_bench`).
+ *
+ * Genera un flujo sintético reproducible (ver GeneradorTramas) y mide cada componente
+ * por separado (rotor, rotores por alfabeto, pila de rotores, lista, parser, divisor, agrupador, formato
+ * binario, ventana de secuencia) y el recorrido completo (trama por trama, por rachas,
+ * por lotes, desde archivo, con la tubería de tres hilos, con sesiones en 1..N hilos,
+ * consulta con índice y, en Linux/macOS, un puerto serial sobre una pseudo-terminal, con
+ * la CPU que gasta en reposo por eventos y por sondeo). Los resultados salen en JSON para comparar corridas:
+ *
+ *     prt7_bench --bytes 16000000 --rotacion pequena:5 --fin crlf > antes.json
+ *
+ * Cada medición se repite (`--repeticiones`) después de una corrida de calentamiento y
+ * se informan el mínimo, la mediana, el percentil 99 y el máximo.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <thread>
+
+#include "GeneradorTramas.h"
+#include "ListaDeCarga.h"
+#include "RotorDeMapeo.h"
+#include "RotorAlfabeto.h"
+#include "PilaDeRotores.h"
+#include "ParserTramas.h"
+#include "TramaBase.h"
+#include "TramaCompacta.h"
+#include "DivisorTramas.h"
+#include "ProcesadorLineas.h"
+#include "AgrupadorTramas.h"
+#include "TramaBinaria.h"
+#include "FuenteSecuenciada.h"
+#include "FuenteArchivo.h"
+#include "DecodificadorLote.h"
+#include "IndiceCaptura.h"
+#include "TuberiaTramas.h"
+#include "GrupoSesiones.h"
+#include "SerialPort.h"
+
+#ifndef _WIN32
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+/**
+ * @brief Número máximo de resultados de una corrida.
+ */
+static const int MAXIMO_RESULTADOS = 96;
+
+/**
+ * @brief Muestras de latencia por medición (consulta con índice, pseudo-terminal).
+ */
+static const int MUESTRAS_LATENCIA = 2000;
+
+/**
+ * @brief Duración de cada ventana de `serial.pty.reposo.*`, en milisegundos.
+ */
+static const int VENTANA_REPOSO_MS = 250;
+
+/**
+ * @brief Sesiones de `e2e.sesiones.hN`, cada una con el flujo completo; el trabajo es
+ *        el mismo con cualquier número de hilos.
+ */
+static const int SESIONES_BANCO = 8;
+
+/**
+ * @struct ResultadoBanco
+ * @brief Resumen de una medición.
+ */
+struct ResultadoBanco {
+    char nombre[48];         /**< @brief Componente y operación, p. ej. `rotor.getMapeo`. */
+    const char* unidad;      /**< @brief `ns/op` (por operación) o `ns` (latencia por muestra). */
+    unsigned long long operaciones; /**< @brief Operaciones por repetición (o muestras de latencia). */
+    unsigned long long bytes; /**< @brief Bytes procesados por repetición (0 si no aplica). */
+    double minimo;           /**< @brief Valor mínimo. */
+    double mediana;          /**< @brief Mediana. */
+    double p99;              /**< @brief Percentil 99. */
+    double maximo;           /**< @brief Valor máximo. */
+    int hilos;               /**< @brief Hilos trabajadores de la medición (0 si no aplica). */
+};
+
+/**
+ * @struct Banco
+ * @brief Configuración y resultados de una corrida.
+ */
+struct Banco {
+    ConfiguracionGenerador configuracion; /**< @brief Parámetros del flujo sintético. */
+    int repeticiones;        /**< @brief Repeticiones de cada medición. */
+    const char* filtro;      /**< @brief Solo medir los nombres que contengan este texto, o `nullptr`. */
+    ResultadoBanco resultados[MAXIMO_RESULTADOS]; /**< @brief Resultados en orden de medición. */
+    int numResultados;       /**< @brief Resultados guardados. */
+    int hilosMedicion;       /**< @brief Hilos de la medición en curso, que se copian a su resultado (0 si no aplica). */
+    bool verificado;         /**< @brief Todos los recorridos completos dieron el mensaje esperado. */
+};
+
+/**
+ * @brief Evita que el compilador descarte el trabajo medido.
+ */
+static volatile unsigned long long sumidero = 0;
+
+/**
+ * @brief Compara dos doubles para qsort().
+ */
+static int compararDoubles(const void* a, const void* b) {
+    double x = *(const double*)a;
+    double y = *(const double*)b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+/**
+ * @brief Nanosegundos transcurridos desde un instante.
+ */
+static double nanosegundosDesde(std::chrono::steady_clock::time_point inicio) {
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - inicio).count();
+}
+
+/**
+ * @brief Indica si una medición pasa el filtro de la línea de comandos.
+ */
+static bool seleccionada(const Banco& banco, const char* nombre) {
+    return banco.filtro == nullptr || strstr(nombre, banco.filtro) != nullptr;
+}
+
+/**
+ * @brief Ordena las muestras y guarda su resumen.
+ */
+static void registrarResultado(Banco* banco, const char* nombre, const char* unidad, unsigned long long operaciones,
+                               unsigned long long bytes, double* muestras, int numMuestras) {
+    if (banco->numResultados == MAXIMO_RESULTADOS || numMuestras == 0) {
+        return;
+    }
+    qsort(muestras, (size_t)numMuestras, sizeof(double), compararDoubles);
+    ResultadoBanco& r = banco->resultados[banco->numResultados++];
+    snprintf(r.nombre, sizeof(r.nombre), "%s", nombre);
+    r.unidad = unidad;
+    r.operaciones = operaciones;
+    r.bytes = bytes;
+    r.minimo = muestras[0];
+    r.mediana = muestras[numMuestras / 2];
+    r.p99 = muestras[(numMuestras * 99) / 100 < numMuestras ? (numMuestras * 99) / 100 : numMuestras - 1];
+    r.maximo = muestras[numMuestras - 1];
+    r.hilos = banco->hilosMedicion;
+    fprintf(stderr, "  %-38s %12.2f %s\n", nombre, r.mediana, unidad);
+}
+
+/**
+ * @brief Mide una operación repetida: `cuerpo()` debe realizar `operaciones` operaciones.
+ * @param banco Corrida actual.
+ * @param nombre Nombre de la medición.
+ * @param operaciones Operaciones por llamada a `cuerpo`.
+ * @param bytes Bytes procesados por llamada (0 si no aplica).
+ * @param cuerpo Trabajo a medir; devuelve un valor que se acumula en el sumidero.
+ */
+template <class Cuerpo>
+static void medir(Banco* banco, const char* nombre, unsigned long long operaciones, unsigned long long bytes,
+                  Cuerpo cuerpo) {
+    if (!seleccionada(*banco, nombre) || operaciones == 0) {
+        return;
+    }
+    double* muestras = (double*)malloc(sizeof(double) * (size_t)banco->repeticiones);
+    sumidero = sumidero + (unsigned long long)cuerpo(); // Calentamiento
+    for (int i = 0; i < banco->repeticiones; ++i) {
+        auto inicio = std::chrono::steady_clock::now();
+        sumidero = sumidero + (unsigned long long)cuerpo();
+        muestras[i] = nanosegundosDesde(inicio) / (double)operaciones;
+    }
+    registrarResultado(banco, nombre, "ns/op", operaciones, bytes, muestras, banco->repeticiones);
+    free(muestras);
+}
+
+/**
+ * @class FuenteMemoria
+ * @brief Fuente de tramas sobre un buffer en memoria, para medir las fuentes decoradoras.
+ */
+class FuenteMemoria : public FuenteTramas {
+private:
+    DivisorTramas divisor; /**< @brief Separador de líneas del buffer. */
+    bool fin;              /**< @brief Ya se entregaron todas las líneas. */
+
+public:
+    FuenteMemoria(const char* datos, size_t longitud) : divisor(datos, longitud), fin(false) {}
+
+    bool leerLinea(VistaLinea* linea) override {
+        if (divisor.siguiente(linea)) {
+            return true;
+        }
+        fin = true;
+        return false;
+    }
+
+    bool agotada() const override {
+        return fin;
+    }
+};
+
+/**
+ * @brief Copia el mensaje de una lista a un buffer nuevo.
+ * @return El buffer (liberar con free()).
+ */
+static char* copiarMensaje(const ListaDeCarga& lista) {
+    char* mensaje = (char*)malloc(lista.getLongitud() + 1);
+    CursorCarga cursor;
+    size_t copiados = 0;
+    size_t n;
+    while ((n = lista.copiarNuevos(&cursor, mensaje + copiados, lista.getLongitud() - copiados)) > 0) {
+        copiados += n;
+    }
+    return mensaje;
+}
+
+/**
+ * @brief Comprueba que una lista tenga el mensaje esperado.
+ */
+static bool coincide(Banco* banco, const char* nombre, const ListaDeCarga& lista, const char* esperado, size_t longitud) {
+    bool igual = lista.getLongitud() == longitud;
+    if (igual) {
+        char* mensaje = copiarMensaje(lista);
+        igual = memcmp(mensaje, esperado, longitud) == 0;
+        free(mensaje);
+    }
+    if (!igual) {
+        fprintf(stderr, "ERROR: %s no produjo el mensaje esperado.\n", nombre);
+        banco->verificado = false;
+    }
+    return igual;
+}
+
+/**
+ * @brief Nombre de una distribución de rotaciones en la línea de comandos y en el JSON.
+ */
+static const char* nombreDistribucion(DistribucionRotacion distribucion) {
+    return distribucion == ROTACION_PEQUENA ? "pequena" : (distribucion == ROTACION_EXTREMA ? "extrema" : "uniforme");
+}
+
+/**
+ * @brief Nombre de un terminador de línea en la línea de comandos y en el JSON.
+ */
+static const char* nombreFinDeLinea(FinDeLinea fin) {
+    static const char* const NOMBRES[] = {"lf", "crlf", "cr", "mixto"};
+    return NOMBRES[fin];
+}
+
+/**
+ * @brief Muestra la forma de uso.
+ */
+static void mostrarUso(const char* programa) {
+    fprintf(stderr, "Uso: %s [opciones]\n", programa);
+    fprintf(stderr, "  --bytes <N>          Tamaño del flujo sintético en bytes (por defecto 8 MiB).\n");
+    fprintf(stderr, "  --semilla <S>        Semilla del generador (por defecto 1).\n");
+    fprintf(stderr, "  --cargas <F>         Fracción de tramas LOAD, de 0 a 1 (por defecto 0.9).\n");
+    fprintf(stderr, "  --rotacion <uniforme|pequena|extrema>[:max]  Distribución de las rotaciones MAP.\n");
+    fprintf(stderr, "  --fin <lf|crlf|cr|mixto>  Terminador de línea (por defecto lf).\n");
+    fprintf(stderr, "  --ruido <F>          Fracción de líneas informativas o mal formadas (por defecto 0).\n");
+    fprintf(stderr, "  --repeticiones <R>   Repeticiones de cada medición (por defecto 5).\n");
+    fprintf(stderr, "  --filtro <texto>     Solo las mediciones cuyo nombre contenga el texto.\n");
+    fprintf(stderr, "  --salida <ruta>      Escribe el JSON en un archivo en lugar de la salida estándar.\n");
+    fprintf(stderr, "  --generar <ruta>     Solo escribe el flujo sintético en un archivo y termina.\n");
+}
+
+/**
+ * @brief Lee las opciones de la línea de comandos.
+ * @return `true` si todas las opciones son válidas.
+ */
+static bool leerOpciones(int argc, char* argv[], Banco* banco, const char** rutaSalida, const char** rutaFlujo) {
+    for (int i = 1; i < argc; ++i) {
+        bool conValor = i + 1 < argc;
+        if (strcmp(argv[i], "--bytes") == 0 && conValor) {
+            banco->configuracion.bytes = (size_t)strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--semilla") == 0 && conValor) {
+            banco->configuracion.semilla = strtoull(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--cargas") == 0 && conValor) {
+            banco->configuracion.proporcionCargas = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--ruido") == 0 && conValor) {
+            banco->configuracion.proporcionRuido = atof(argv[++i]);
+        } else if (strcmp(argv[i], "--rotacion") == 0 && conValor) {
+            const char* valor = argv[++i];
+            const char* maximo = strchr(valor, ':');
+            size_t largo = maximo != nullptr ? (size_t)(maximo - valor) : strlen(valor);
+            if (strncmp(valor, "uniforme", largo) == 0 && largo == 8) {
+                banco->configuracion.distribucion = ROTACION_UNIFORME;
+            } else if (strncmp(valor, "pequena", largo) == 0 && largo == 7) {
+                banco->configuracion.distribucion = ROTACION_PEQUENA;
+            } else if (strncmp(valor, "extrema", largo) == 0 && largo == 7) {
+                banco->configuracion.distribucion = ROTACION_EXTREMA;
+            } else {
+                fprintf(stderr, "Distribución no reconocida: %s\n", valor);
+                return false;
+            }
+            if (maximo != nullptr) {
+                banco->configuracion.rotacionMaxima = atoi(maximo + 1);
+            }
+        } else if (strcmp(argv[i], "--fin") == 0 && conValor) {
+            const char* valor = argv[++i];
+            bool reconocido = false;
+            for (int f = FIN_LF; f <= FIN_MIXTO; ++f) {
+                if (strcmp(valor, nombreFinDeLinea((FinDeLinea)f)) == 0) {
+                    banco->configuracion.finDeLinea = (FinDeLinea)f;
+                    reconocido = true;
+                }
+            }
+            if (!reconocido) {
+                fprintf(stderr, "Terminador no reconocido: %s\n", valor);
+                return false;
+            }
+        } else if (strcmp(argv[i], "--repeticiones") == 0 && conValor) {
+            banco->repeticiones = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--filtro") == 0 && conValor) {
+            banco->filtro = argv[++i];
+        } else if (strcmp(argv[i], "--salida") == 0 && conValor) {
+            *rutaSalida = argv[++i];
+        } else if (strcmp(argv[i], "--generar") == 0 && conValor) {
+            *rutaFlujo = argv[++i];
+        } else {
+            fprintf(stderr, "Opción no reconocida: %s\n", argv[i]);
+            return false;
+        }
+    }
+    if (banco->repeticiones < 1 || banco->configuracion.bytes == 0) {
+        fprintf(stderr, "Se necesitan al menos una repetición y un byte de flujo.\n");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @struct TramasPreparadas
+ * @brief El flujo ya clasificado, para medir los componentes sin el costo del parser.
+ */
+struct TramasPreparadas {
+    const char* flujo;       /**< @brief Flujo sintético. */
+    size_t longitud;         /**< @brief Bytes del flujo. */
+    VistaLinea* lineas;      /**< @brief Líneas del flujo. */
+    size_t numLineas;        /**< @brief Cantidad de líneas. */
+    TramaCompacta* tramas;   /**< @brief Tramas válidas, ya parseadas. */
+    size_t numTramas;        /**< @brief Cantidad de tramas válidas. */
+    char* cargas;            /**< @brief Datos de las tramas LOAD, en orden. */
+    size_t numCargas;        /**< @brief Cantidad de tramas LOAD. */
+    int* rotaciones;         /**< @brief Rotaciones de las tramas MAP, en orden. */
+    size_t numRotaciones;    /**< @brief Cantidad de tramas MAP. */
+    char* esperado;          /**< @brief Mensaje decodificado de referencia. */
+    size_t longitudEsperado; /**< @brief Caracteres del mensaje de referencia. */
+};
+
+/**
+ * @brief Separa y clasifica el flujo una vez, y calcula el mensaje de referencia.
+ */
+static bool prepararTramas(const char* flujo, size_t longitud, TramasPreparadas* p) {
+    p->flujo = flujo;
+    p->longitud = longitud;
+    size_t capacidad = longitud / 4 + 16;
+    p->lineas = (VistaLinea*)malloc(sizeof(VistaLinea) * capacidad);
+    p->tramas = (TramaCompacta*)malloc(sizeof(TramaCompacta) * capacidad);
+    p->cargas = (char*)malloc(capacidad);
+    p->rotaciones = (int*)malloc(sizeof(int) * capacidad);
+    if (p->lineas == nullptr || p->tramas == nullptr || p->cargas == nullptr || p->rotaciones == nullptr) {
+        return false;
+    }
+    DivisorTramas divisor(flujo, longitud);
+    p->numLineas = 0;
+    p->numTramas = 0;
+    p->numCargas = 0;
+    p->numRotaciones = 0;
+    VistaLinea linea;
+    while (divisor.siguiente(&linea) && p->numLineas < capacidad) {
+        p->lineas[p->numLineas++] = linea;
+        TramaCompacta trama;
+        if (parsearTrama(linea.datos, linea.longitud, &trama)) {
+            p->tramas[p->numTramas++] = trama;
+            if (trama.tipo == TRAMA_CARGA) {
+                p->cargas[p->numCargas++] = trama.dato;
+            } else {
+                p->rotaciones[p->numRotaciones++] = trama.rotacion;
+            }
+        }
+    }
+
+    ListaDeCarga lista;
+    RotorDeMapeo rotor;
+    DecodificadorLote decodificador;
+    decodificador.decodificar(flujo, longitud, &lista, &rotor);
+    p->esperado = copiarMensaje(lista);
+    p->longitudEsperado = lista.getLongitud();
+    return true;
+}
+
+/**
+ * @brief Tramas MAP por medición del barrido de magnitudes (iguales para toda magnitud).
+ */
+static const size_t ROTACIONES_BARRIDO = 4096;
+
+/**
+ * @brief Pasos de lista que recorre como máximo cada llamada del rotor de referencia.
+ */
+static const unsigned long long PASOS_RECORRIDO = 1ULL << 22;
+
+/**
+ * @struct NodoRecorrido
+ * @brief Nodo de la lista circular del rotor de referencia (el recorrido original).
+ */
+struct NodoRecorrido {
+    NodoRecorrido* siguiente; /**< @brief Nodo siguiente. */
+    NodoRecorrido* previo;    /**< @brief Nodo anterior. */
+};
+
+/**
+ * @brief Rotación del rotor original: avanza o retrocede `n` nodos uno por uno.
+ * @return La nueva cabeza.
+ */
+static NodoRecorrido* recorrerNodos(NodoRecorrido* cabeza, int n) {
+    if (n > 0) {
+        for (int i = 0; i < n; ++i) {
+            cabeza = cabeza->siguiente;
+        }
+    } else {
+        for (int i = 0; i > n; --i) {
+            cabeza = cabeza->previo;
+        }
+    }
+    return cabeza;
+}
+
+/**
+ * @brief Barrido de `rotor.rotar` por magnitud de la rotación, junto al recorrido de la lista.
+ *
+ * Cada magnitud usa las mismas ROTACIONES_BARRIDO tramas (signos alternados), así que
+ * `rotor.rotar.n=*` debe dar el mismo costo por trama para 1 y para 2e9. El recorrido
+ * crece con la magnitud; para no tardar minutos usa menos tramas (hasta PASOS_RECORRIDO
+ * pasos por llamada) y se omite cuando una sola trama ya los supera.
+ */
+static void medirBarridoRotacion(Banco* banco) {
+    static const int MAGNITUDES[] = {1, 1000, 1000000, 2000000000};
+    static const char* const ETIQUETAS[] = {"1", "1e3", "1e6", "2e9"};
+
+    NodoRecorrido* nodos = new NodoRecorrido[RotorDeMapeo::TAMANO_ALFABETO];
+    for (int i = 0; i < RotorDeMapeo::TAMANO_ALFABETO; ++i) {
+        nodos[i].siguiente = &nodos[(i + 1) % RotorDeMapeo::TAMANO_ALFABETO];
+        nodos[i].previo = &nodos[(i + RotorDeMapeo::TAMANO_ALFABETO - 1) % RotorDeMapeo::TAMANO_ALFABETO];
+    }
+    int* rotaciones = (int*)malloc(sizeof(int) * ROTACIONES_BARRIDO);
+
+    for (size_t m = 0; m < sizeof(MAGNITUDES) / sizeof(MAGNITUDES[0]); ++m) {
+        for (size_t i = 0; i < ROTACIONES_BARRIDO; ++i) {
+            rotaciones[i] = (i & 1) ? -MAGNITUDES[m] : MAGNITUDES[m];
+        }
+
+        RotorDeMapeo rotor;
+        char nombre[48];
+        snprintf(nombre, sizeof(nombre), "rotor.rotar.n=%s", ETIQUETAS[m]);
+        medir(banco, nombre, ROTACIONES_BARRIDO, 0, [&]() {
+            for (size_t i = 0; i < ROTACIONES_BARRIDO; ++i) {
+                rotor.rotar(rotaciones[i]);
+            }
+            return (unsigned long long)rotor.getDesplazamiento();
+        });
+
+        unsigned long long tramas = PASOS_RECORRIDO / (unsigned long long)MAGNITUDES[m];
+        snprintf(nombre, sizeof(nombre), "rotor.recorrido.n=%s", ETIQUETAS[m]);
+        if (tramas == 0) {
+            if (seleccionada(*banco, nombre)) {
+                fprintf(stderr, "  (se omite %s: una trama recorre más de %llu nodos)\n", nombre, PASOS_RECORRIDO);
+            }
+            continue;
+        }
+        if (tramas > ROTACIONES_BARRIDO) {
+            tramas = ROTACIONES_BARRIDO;
+        }
+        NodoRecorrido* cabeza = nodos;
+        medir(banco, nombre, tramas, 0, [&]() {
+            for (size_t i = 0; i < (size_t)tramas; ++i) {
+                cabeza = recorrerNodos(cabeza, rotaciones[i]);
+            }
+            return (unsigned long long)(cabeza - nodos);
+        });
+    }
+    free(rotaciones);
+    delete[] nodos;
+}
+
+/**
+ * @brief Mediciones del rotor, la pila de rotores y la lista.
+ */
+static void medirComponentes(Banco* banco, const TramasPreparadas& p) {
+    RotorDeMapeo rotor;
+    medir(banco, "rotor.getMapeo", p.numCargas, 0, [&]() {
+        unsigned long long suma = 0;
+        for (size_t i = 0; i < p.numCargas; ++i) {
+            suma += (unsigned char)rotor.getMapeo(p.cargas[i]);
+        }
+        return suma;
+    });
+    medir(banco, "rotor.rotar", p.numRotaciones, 0, [&]() {
+        for (size_t i = 0; i < p.numRotaciones; ++i) {
+            rotor.rotar(p.rotaciones[i]);
+        }
+        return (unsigned long long)rotor.getDesplazamiento();
+    });
+    medirBarridoRotacion(banco);
+    medir(banco, "rotor.mapearConDesplazamiento", p.numCargas, 0, [&]() {
+        unsigned long long suma = 0;
+        for (size_t i = 0; i < p.numCargas; ++i) {
+            suma += (unsigned char)rotor.mapearConDesplazamiento(p.cargas[i], (int)(i % 27));
+        }
+        return suma;
+    });
+    char* bloque = (char*)malloc(p.numCargas + 1);
+    medir(banco, "rotor.mapearBloque", p.numCargas, p.numCargas, [&]() {
+        rotor.mapearBloque(p.cargas, bloque, p.numCargas);
+        return (unsigned long long)(unsigned char)bloque[p.numCargas / 2];
+    });
+    free(bloque);
+
+    // Pila: K rotores, tramas MAP repartidas entre ellos
+    for (int k = 1; k <= PilaDeRotores::MAXIMO_ROTORES; k *= 2) {
+        for (int avance = 0; avance <= 1; ++avance) {
+            char nombre[48];
+            snprintf(nombre, sizeof(nombre), "pila.decodificar.k%d%s", k, avance ? ".avance" : "");
+            medir(banco, nombre, p.numTramas, 0, [&]() {
+                PilaDeRotores pila(k, avance != 0);
+                unsigned long long suma = 0;
+                for (size_t i = 0; i < p.numTramas; ++i) {
+                    const TramaCompacta& t = p.tramas[i];
+                    if (t.tipo == TRAMA_CARGA) {
+                        suma += (unsigned char)pila.decodificar(t.dato);
+                    } else {
+                        pila.rotar((int)(i % (size_t)k), t.rotacion);
+                    }
+                }
+                return suma + pila.getCompilaciones();
+            });
+        }
+    }
+
+    medir(banco, "lista.insertarAlFinal", p.numCargas, 0, [&]() {
+        ListaDeCarga lista;
+        for (size_t i = 0; i < p.numCargas; ++i) {
+            lista.insertarAlFinal(p.cargas[i]);
+        }
+        return (unsigned long long)lista.getLongitud();
+    });
+    medir(banco, "lista.insertarBloque", p.numCargas, p.numCargas, [&]() {
+        ListaDeCarga lista;
+        for (size_t i = 0; i < p.numCargas; i += 64) {
+            lista.insertarBloque(p.cargas + i, p.numCargas - i < 64 ? p.numCargas - i : 64);
+        }
+        return (unsigned long long)lista.getLongitud();
+    });
+    ListaDeCarga llena;
+    llena.insertarBloque(p.cargas, p.numCargas);
+    char* destino = (char*)malloc(4096);
+    medir(banco, "lista.copiarNuevos", p.numCargas, p.numCargas, [&]() {
+        CursorCarga cursor;
+        unsigned long long copiados = 0;
+        size_t n;
+        while ((n = llena.copiarNuevos(&cursor, destino, 4096)) > 0) {
+            copiados += n;
+        }
+        return copiados;
+    });
+    free(destino);
+}
+
+/**
+ * @brief Mediciones de RotorAlfabeto frente a RotorDeMapeo con el mismo alfabeto.
+ *
+ * Las cargas del flujo se convierten a símbolos del alfabeto para que todas las
+ * consultas acierten; las rotaciones son las de las tramas MAP del flujo.
+ */
+template <class Alfabeto>
+static void medirAlfabeto(Banco* banco, const TramasPreparadas& p, TipoAlfabeto tipo) {
+    typedef TablasAlfabeto<Alfabeto> Tablas;
+    const char* alfabeto = describirAlfabeto(tipo).nombre;
+    char* entrada = (char*)malloc(p.numCargas + 1);
+    char* salida = (char*)malloc(p.numCargas + 1);
+    char* salidaRotor = (char*)malloc(p.numCargas + 1);
+    for (size_t i = 0; i < p.numCargas; ++i) {
+        entrada[i] = Tablas::SIMBOLOS.valor[(unsigned char)p.cargas[i] % Tablas::TAMANO];
+    }
+    RotorAlfabeto<Alfabeto> rotor;
+    RotorDeMapeo elegido(tipo);
+
+    char nombre[48];
+    snprintf(nombre, sizeof(nombre), "alfabeto.%s.getMapeo", alfabeto);
+    medir(banco, nombre, p.numCargas, 0, [&]() {
+        unsigned long long suma = 0;
+        for (size_t i = 0; i < p.numCargas; ++i) {
+            suma += (unsigned char)rotor.getMapeo(entrada[i]);
+        }
+        return suma;
+    });
+    snprintf(nombre, sizeof(nombre), "rotor.%s.getMapeo", alfabeto);
+    medir(banco, nombre, p.numCargas, 0, [&]() {
+        unsigned long long suma = 0;
+        for (size_t i = 0; i < p.numCargas; ++i) {
+            suma += (unsigned char)elegido.getMapeo(entrada[i]);
+        }
+        return suma;
+    });
+    snprintf(nombre, sizeof(nombre), "alfabeto.%s.rotar", alfabeto);
+    medir(banco, nombre, p.numRotaciones, 0, [&]() {
+        for (size_t i = 0; i < p.numRotaciones; ++i) {
+            rotor.rotar(p.rotaciones[i]);
+        }
+        return (unsigned long long)rotor.getDesplazamiento();
+    });
+    snprintf(nombre, sizeof(nombre), "rotor.%s.rotar", alfabeto);
+    medir(banco, nombre, p.numRotaciones, 0, [&]() {
+        for (size_t i = 0; i < p.numRotaciones; ++i) {
+            elegido.rotar(p.rotaciones[i]);
+        }
+        return (unsigned long long)elegido.getDesplazamiento();
+    });
+    snprintf(nombre, sizeof(nombre), "alfabeto.%s.mapearBloque", alfabeto);
+    medir(banco, nombre, p.numCargas, p.numCargas, [&]() {
+        rotor.mapearBloque(entrada, salida, p.numCargas);
+        return (unsigned long long)(unsigned char)salida[p.numCargas / 2];
+    });
+    snprintf(nombre, sizeof(nombre), "rotor.%s.mapearBloque", alfabeto);
+    medir(banco, nombre, p.numCargas, p.numCargas, [&]() {
+        elegido.mapearBloque(entrada, salidaRotor, p.numCargas);
+        return (unsigned long long)(unsigned char)salidaRotor[p.numCargas / 2];
+    });
+
+    // Con las mismas rotaciones (aunque --filtro haya omitido mediciones), las tablas
+    // deben mapear como la lista circular y como RotorAlfabeto, byte por byte
+    RotorAlfabeto<Alfabeto> referencia;
+    RotorDeMapeo comprobado(tipo);
+    size_t paso = p.numRotaciones / 64 + 1;
+    bool iguales = true;
+    for (size_t i = 0; iguales && i < p.numRotaciones; ++i) {
+        referencia.rotar(p.rotaciones[i]);
+        comprobado.rotar(p.rotaciones[i]);
+        if (i % paso != 0 && i + 1 != p.numRotaciones) {
+            continue;
+        }
+        iguales = referencia.getDesplazamiento() == comprobado.getDesplazamiento();
+        for (int b = 0; iguales && b < 256; ++b) {
+            char c = (char)b;
+            char esperado = referencia.getMapeo(c);
+            iguales = comprobado.getMapeo(c) == esperado && comprobado.getMapeoRecorrido(c) == esperado &&
+                      comprobado.mapearConDesplazamiento(c, comprobado.getDesplazamiento()) == esperado;
+        }
+    }
+    referencia.mapearBloque(p.cargas, salida, p.numCargas);
+    comprobado.mapearBloque(p.cargas, salidaRotor, p.numCargas);
+    if (!iguales || memcmp(salida, salidaRotor, p.numCargas) != 0) {
+        fprintf(stderr, "ERROR: RotorAlfabeto y RotorDeMapeo (%s) no mapean igual.\n", alfabeto);
+        banco->verificado = false;
+    }
+    free(entrada);
+    free(salida);
+    free(salidaRotor);
+}
+
+/**
+ * @brief Mediciones de los rotores por alfabeto.
+ */
+static void medirAlfabetos(Banco* banco, const TramasPreparadas& p) {
+    medirAlfabeto<AlfabetoLatino>(banco, p, ALFABETO_LATINO);
+    medirAlfabeto<AlfabetoDigitos>(banco, p, ALFABETO_DIGITOS);
+    medirAlfabeto<AlfabetoImprimible>(banco, p, ALFABETO_IMPRIMIBLE);
+    medirAlfabeto<AlfabetoBytes>(banco, p, ALFABETO_BYTES);
+}
+
+/**
+ * @brief Mediciones del separador de líneas, el parser y el agrupador.
+ */
+static void medirParser(Banco* banco, const TramasPreparadas& p) {
+    medir(banco, "divisor.lineas", p.numLineas, p.longitud, [&]() {
+        DivisorTramas divisor(p.flujo, p.longitud);
+        VistaLinea linea;
+        unsigned long long lineas = 0;
+        while (divisor.siguiente(&linea)) {
+            lineas++;
+        }
+        return lineas;
+    });
+    medir(banco, "parser.separarLinea", p.numLineas, p.longitud, [&]() {
+        size_t posicion = 0;
+        unsigned long long lineas = 0;
+        size_t inicio, longitud, consumidos;
+        while (separarLinea(p.flujo + posicion, p.longitud - posicion, true, &inicio, &longitud, &consumidos)) {
+            posicion += consumidos;
+            lineas++;
+        }
+        return lineas;
+    });
+    medir(banco, "parser.clasificarLinea", p.numLineas, 0, [&]() {
+        unsigned long long suma = 0;
+        for (size_t i = 0; i < p.numLineas; ++i) {
+            char dato;
+            int rotacion;
+            suma += (unsigned long long)clasificarLinea(p.lineas[i].datos, p.lineas[i].longitud, &dato, &rotacion);
+        }
+        return suma;
+    });
+    medir(banco, "parser.parsearTrama", p.numLineas, 0, [&]() {
+        unsigned long long validas = 0;
+        for (size_t i = 0; i < p.numLineas; ++i) {
+            TramaCompacta trama;
+            validas += parsearTrama(p.lineas[i].datos, p.lineas[i].longitud, &trama) ? 1 : 0;
+        }
+        return validas;
+    });
+    medir(banco, "parser.parseLine", p.numLineas, 0, [&]() {
+        unsigned long long validas = 0;
+        for (size_t i = 0; i < p.numLineas; ++i) {
+            char original[2];
+            int rotacion;
+            TramaBase* trama = parseLine(p.lineas[i].datos, p.lineas[i].longitud, original, &rotacion);
+            if (trama != nullptr) {
+                validas++;
+                delete trama;
+            }
+        }
+        return validas;
+    });
+    medir(banco, "agrupador.agregar", p.numLineas, 0, [&]() {
+        ListaDeCarga lista;
+        RotorDeMapeo rotor;
+        AgrupadorTramas agrupador(&lista, &rotor);
+        for (size_t i = 0; i < p.numLineas; ++i) {
+            agrupador.agregar(p.lineas[i]);
+        }
+        agrupador.vaciar();
+        return (unsigned long long)lista.getLongitud();
+    });
+}
+
+/**
+ * @brief Mediciones del formato binario y de la ventana de tramas secuenciadas.
+ */
+static void medirEnlace(Banco* banco, const TramasPreparadas& p) {
+    // Formato binario: rachas de LOAD de hasta 64 caracteres y tramas MAP sueltas
+    unsigned char* binario = (unsigned char*)malloc(p.numTramas * 8 + MAXIMO_TRAMA_BINARIA);
+    size_t longitudBinario = 0;
+    auto codificar = [&]() {
+        size_t n = 0;
+        size_t i = 0;
+        char racha[MAXIMO_RACHA_BINARIA];
+        while (i < p.numTramas) {
+            if (p.tramas[i].tipo == TRAMA_MAPA) {
+                n += codificarMapaBinario(0, p.tramas[i].rotacion, binario + n);
+                i++;
+                continue;
+            }
+            size_t largo = 0;
+            while (i < p.numTramas && p.tramas[i].tipo == TRAMA_CARGA && largo < MAXIMO_RACHA_BINARIA) {
+                racha[largo++] = p.tramas[i++].dato;
+            }
+            n += codificarCargasBinarias(racha, largo, binario + n);
+        }
+        longitudBinario = n;
+        return (unsigned long long)n;
+    };
+    medir(banco, "binario.codificar", p.numTramas, p.longitud, codificar);
+    if (longitudBinario == 0) {
+        codificar();
+    }
+    medir(banco, "binario.extraer", p.numTramas, longitudBinario, [&]() {
+        size_t posicion = 0;
+        unsigned long long caracteres = 0;
+        TramaBinaria trama;
+        size_t consumidos;
+        while (posicion < longitudBinario) {
+            EstadoExtraccion estado = extraerTramaBinaria(binario + posicion, longitudBinario - posicion, &trama, &consumidos);
+            if (estado == EXTRACCION_INCOMPLETA) {
+                break;
+            }
+            posicion += consumidos;
+            if (estado == EXTRACCION_TRAMA && trama.tipo == TRAMA_CARGA) {
+                caracteres += trama.longitud;
+            }
+        }
+        return caracteres;
+    });
+    free(binario);
+
+    // Tramas F,<seq>,<cuerpo>,<crc>: en orden y con un 5 % de pares intercambiados
+    size_t capacidad = p.numLineas * (MAXIMO_CUERPO_SECUENCIADO + 13);
+    char* enOrden = (char*)malloc(capacidad);
+    char* desorden = (char*)malloc(capacidad);
+    size_t* inicios = (size_t*)malloc(sizeof(size_t) * (p.numLineas + 1));
+    size_t longitudSecuencia = 0;
+    size_t numSecuenciadas = 0;
+    for (size_t i = 0; i < p.numLineas; ++i) {
+        if (p.lineas[i].longitud > MAXIMO_CUERPO_SECUENCIADO) {
+            continue;
+        }
+        inicios[numSecuenciadas++] = longitudSecuencia;
+        longitudSecuencia += codificarTramaSecuenciada((uint16_t)numSecuenciadas - 1, p.lineas[i].datos,
+                                                       p.lineas[i].longitud, enOrden + longitudSecuencia);
+        enOrden[longitudSecuencia++] = '\n';
+    }
+    inicios[numSecuenciadas] = longitudSecuencia;
+    GeneradorTramas azar(banco->configuracion.semilla);
+    size_t escrito = 0;
+    for (size_t i = 0; i < numSecuenciadas; ++i) {
+        size_t elegida = i;
+        if (i + 1 < numSecuenciadas && azar.siguienteMenorQue(20) == 0) {
+            elegida = i + 1; // Intercambiar con la siguiente
+        }
+        memcpy(desorden + escrito, enOrden + inicios[elegida], inicios[elegida + 1] - inicios[elegida]);
+        escrito += inicios[elegida + 1] - inicios[elegida];
+        if (elegida != i) {
+            memcpy(desorden + escrito, enOrden + inicios[i], inicios[i + 1] - inicios[i]);
+            escrito += inicios[i + 1] - inicios[i];
+            i++;
+        }
+    }
+
+    medir(banco, "secuencia.validar", numSecuenciadas, longitudSecuencia, [&]() {
+        DivisorTramas divisor(enOrden, longitudSecuencia);
+        VistaLinea linea;
+        VistaLinea cuerpo;
+        uint16_t secuencia;
+        unsigned long long validas = 0;
+        while (divisor.siguiente(&linea)) {
+            validas += validarTramaSecuenciada(linea, &secuencia, &cuerpo) ? 1 : 0;
+        }
+        return validas;
+    });
+    const char* variantes[2] = {enOrden, desorden};
+    const char* nombres[2] = {"secuencia.enOrden", "secuencia.desorden"};
+    for (int v = 0; v < 2; ++v) {
+        medir(banco, nombres[v], numSecuenciadas, longitudSecuencia, [&]() {
+            FuenteMemoria memoria(variantes[v], longitudSecuencia);
+            FuenteSecuenciada secuenciada(&memoria, false);
+            VistaLinea linea;
+            unsigned long long entregadas = 0;
+            while (secuenciada.leerLinea(&linea)) {
+                entregadas++;
+            }
+            return entregadas;
+        });
+    }
+    free(inicios);
+    free(desorden);
+    free(enOrden);
+}
+
+/**
+ * @brief Recorridos completos del flujo, comprobando el mensaje obtenido.
+ */
+static void medirRecorridos(Banco* banco, const TramasPreparadas& p) {
+    bool verificar;
+    verificar = true;
+    medir(banco, "e2e.procesarLinea", p.numLineas, p.longitud, [&]() {
+        ListaDeCarga lista;
+        RotorDeMapeo rotor;
+        DivisorTramas divisor(p.flujo, p.longitud);
+        VistaLinea linea;
+        ResultadoLinea resultado;
+        while (divisor.siguiente(&linea)) {
+            procesarLinea(linea, &lista, &rotor, &resultado);
+        }
+        if (verificar) {
+            coincide(banco, "e2e.procesarLinea", lista, p.esperado, p.longitudEsperado);
+            verificar = false; // Solo en el calentamiento, fuera de las repeticiones medidas
+        }
+        return (unsigned long long)lista.getLongitud();
+    });
+    verificar = true;
+    medir(banco, "e2e.agrupador", p.numLineas, p.longitud, [&]() {
+        ListaDeCarga lista;
+        RotorDeMapeo rotor;
+        AgrupadorTramas agrupador(&lista, &rotor);
+        DivisorTramas divisor(p.flujo, p.longitud);
+        VistaLinea linea;
+        while (divisor.siguiente(&linea)) {
+            agrupador.agregar(linea);
+        }
+        agrupador.vaciar();
+        if (verificar) {
+            coincide(banco, "e2e.agrupador", lista, p.esperado, p.longitudEsperado);
+            verificar = false; // Solo en el calentamiento, fuera de las repeticiones medidas
+        }
+        return (unsigned long long)lista.getLongitud();
+    });
+    medir(banco, "e2e.lote", p.numLineas, p.longitud, [&]() {
+        ListaDeCarga lista;
+        RotorDeMapeo rotor;
+        DecodificadorLote decodificador;
+        decodificador.decodificar(p.flujo, p.longitud, &lista, &rotor);
+        return (unsigned long long)lista.getLongitud();
+    });
+
+    // Tubería de tres hilos en modo silencioso, como `--pipeline --quiet`
+    if (banco->configuracion.proporcionRuido > 0) {
+        fprintf(stderr, "  (se omite e2e.tuberia con --ruido: los errores de parseo irían a la consola)\n");
+    } else {
+        verificar = true;
+        medir(banco, "e2e.tuberia", p.numLineas, p.longitud, [&]() {
+            FuenteMemoria fuente(p.flujo, p.longitud);
+            ListaDeCarga lista;
+            RotorDeMapeo rotor;
+            TuberiaTramas tuberia(&fuente, SALIDA_SILENCIOSA, CONTRAPRESION_ESPERAR);
+            tuberia.ejecutar(&lista, &rotor, nullptr);
+            if (verificar) {
+                coincide(banco, "e2e.tuberia", lista, p.esperado, p.longitudEsperado);
+                verificar = false; // Solo en el calentamiento, fuera de las repeticiones medidas
+            }
+            return (unsigned long long)lista.getLongitud();
+        });
+    }
+
+    // Sesiones independientes repartidas entre 1, 2, 4... hilos, hasta los núcleos disponibles
+    int maximoHilos = (int)std::thread::hardware_concurrency();
+    if (maximoHilos < 1) {
+        maximoHilos = 1;
+    } else if (maximoHilos > SESIONES_BANCO) {
+        maximoHilos = SESIONES_BANCO;
+    }
+    int cuentasHilos[SESIONES_BANCO];
+    int numCuentas = 0;
+    for (int hilos = 1; hilos < maximoHilos; hilos *= 2) {
+        cuentasHilos[numCuentas++] = hilos;
+    }
+    cuentasHilos[numCuentas++] = maximoHilos;
+    for (int c = 0; c < numCuentas; ++c) {
+        int hilos = cuentasHilos[c];
+        char nombre[48];
+        snprintf(nombre, sizeof(nombre), "e2e.sesiones.h%d", hilos);
+        verificar = true;
+        banco->hilosMedicion = hilos;
+        medir(banco, nombre, p.numLineas * SESIONES_BANCO, p.longitud * SESIONES_BANCO, [&]() {
+            GrupoSesiones grupo(hilos);
+            for (int i = 0; i < SESIONES_BANCO; ++i) {
+                grupo.agregar(new SesionDecodificacion("memoria", new FuenteMemoria(p.flujo, p.longitud)));
+            }
+            grupo.ejecutar(nullptr);
+            unsigned long long caracteres = 0;
+            for (size_t i = 0; i < grupo.getNumSesiones(); ++i) {
+                ListaDeCarga* lista = grupo.getSesion(i)->getCarga();
+                if (verificar && !coincide(banco, nombre, *lista, p.esperado, p.longitudEsperado)) {
+                    verificar = false;
+                }
+                caracteres += lista->getLongitud();
+            }
+            verificar = false; // Solo en el calentamiento, fuera de las repeticiones medidas
+            return caracteres;
+        });
+        banco->hilosMedicion = 0;
+    }
+
+    // Desde un archivo proyectado en memoria, como `--archivo <captura> --quiet`
+    char rutaCaptura[64];
+    char rutaIndice[72];
+    snprintf(rutaCaptura, sizeof(rutaCaptura), "prt7_bench_%llu.txt", (unsigned long long)banco->configuracion.semilla);
+    snprintf(rutaIndice, sizeof(rutaIndice), "%s.idx", rutaCaptura);
+    FILE* archivo = fopen(rutaCaptura, "wb");
+    bool escrito = archivo != nullptr && fwrite(p.flujo, 1, p.longitud, archivo) == p.longitud;
+    if (archivo != nullptr) {
+        escrito = fclose(archivo) == 0 && escrito;
+    }
+    if (!escrito) {
+        fprintf(stderr, "ERROR: No se pudo escribir %s; se omiten e2e.fuenteArchivo e indice.*\n", rutaCaptura);
+        return;
+    }
+    verificar = true;
+    medir(banco, "e2e.fuenteArchivo", p.numLineas, p.longitud, [&]() {
+        FuenteArchivo fuente;
+        fuente.abrir(rutaCaptura);
+        ListaDeCarga lista;
+        RotorDeMapeo rotor;
+        AgrupadorTramas agrupador(&lista, &rotor);
+        VistaLinea linea;
+        while (fuente.leerLinea(&linea)) {
+            agrupador.agregar(linea);
+        }
+        agrupador.vaciar();
+        if (verificar) {
+            coincide(banco, "e2e.fuenteArchivo", lista, p.esperado, p.longitudEsperado);
+            verificar = false; // Solo en el calentamiento, fuera de las repeticiones medidas
+        }
+        return (unsigned long long)lista.getLongitud();
+    });
+
+    medir(banco, "indice.construir", p.numLineas, p.longitud, [&]() {
+        return (unsigned long long)IndiceCaptura::construir(p.flujo, p.longitud, rutaIndice);
+    });
+    IndiceCaptura indice;
+    if (seleccionada(*banco, "indice.consultar") && p.longitudEsperado > 1000 &&
+        (IndiceCaptura::construir(p.flujo, p.longitud, rutaIndice) && indice.abrir(rutaIndice, p.longitud))) {
+        // Latencia de leer 1000 caracteres en posiciones al azar del mensaje
+        double* muestras = (double*)malloc(sizeof(double) * MUESTRAS_LATENCIA);
+        char rango[1000];
+        GeneradorTramas azar(banco->configuracion.semilla + 1);
+        for (int i = 0; i < MUESTRAS_LATENCIA; ++i) {
+            uint64_t desde = azar.siguiente() % (p.longitudEsperado - 1000);
+            auto inicio = std::chrono::steady_clock::now();
+            size_t n = indice.consultar(p.flujo, desde, desde + 1000, rango);
+            muestras[i] = nanosegundosDesde(inicio);
+            if (n != 1000 || memcmp(rango, p.esperado + desde, 1000) != 0) {
+                fprintf(stderr, "ERROR: indice.consultar no coincide en %llu.\n", (unsigned long long)desde);
+                banco->verificado = false;
+                break;
+            }
+        }
+        registrarResultado(banco, "indice.consultar", "ns", MUESTRAS_LATENCIA, 1000, muestras, MUESTRAS_LATENCIA);
+        free(muestras);
+    }
+    remove(rutaIndice);
+    remove(rutaCaptura);
+}
+
+#ifndef _WIN32
+/**
+ * @brief Abre una pseudo-terminal y conecta un SerialPort a su lado esclavo.
+ * @return El descriptor del lado maestro, o -1 si no se pudo.
+ */
+static int abrirPuertoSimulado(SerialPort* puerto) {
+    int maestro = posix_openpt(O_RDWR | O_NOCTTY);
+    if (maestro < 0) {
+        return -1;
+    }
+    if (grantpt(maestro) != 0 || unlockpt(maestro) != 0 || ptsname(maestro) == nullptr ||
+        !puerto->open(ptsname(maestro), 115200, false)) {
+        close(maestro);
+        return -1;
+    }
+    return maestro;
+}
+
+/**
+ * @brief Escribe un buffer completo en un descriptor.
+ */
+static bool escribirTodo(int fd, const char* datos, size_t longitud) {
+    while (longitud > 0) {
+        ssize_t n = write(fd, datos, longitud);
+        if (n <= 0) {
+            return false;
+        }
+        datos += n;
+        longitud -= (size_t)n;
+    }
+    return true;
+}
+
+/**
+ * @brief Mediciones de SerialPort sobre una pseudo-terminal: rendimiento y latencia por línea.
+ */
+static void medirPuertoSerial(Banco* banco, const TramasPreparadas& p) {
+    bool rendimiento = seleccionada(*banco, "serial.pty.leerLinea");
+    bool latencia = seleccionada(*banco, "serial.pty.latencia");
+    if (!rendimiento && !latencia) {
+        return;
+    }
+    // SerialPort informa la conexión por std::cout, que aquí lleva el JSON
+    std::cout.setstate(std::ios::failbit);
+    SerialPort puerto;
+    int maestro = abrirPuertoSimulado(&puerto);
+    if (maestro < 0) {
+        std::cout.clear();
+        fprintf(stderr, "No se pudo abrir una pseudo-terminal; se omiten serial.pty.*\n");
+        return;
+    }
+
+    // Rendimiento: bloques de 4 KB, leyendo hasta que el puerto los recibió enteros
+    size_t enviar = p.longitud < (size_t)4 * 1024 * 1024 ? p.longitud : (size_t)4 * 1024 * 1024;
+    size_t lineasEnviadas = 0;
+    while (lineasEnviadas < p.numLineas && p.lineas[lineasEnviadas].datos + p.lineas[lineasEnviadas].longitud <= p.flujo + enviar) {
+        lineasEnviadas++;
+    }
+    medir(banco, "serial.pty.leerLinea", lineasEnviadas, enviar, [&]() {
+        unsigned long long lineas = 0;
+        unsigned long base = puerto.getBytesLeidos();
+        VistaLinea linea;
+        for (size_t enviado = 0; enviado < enviar;) {
+            size_t bloque = enviar - enviado < 4096 ? enviar - enviado : 4096;
+            if (!escribirTodo(maestro, p.flujo + enviado, bloque)) {
+                return lineas;
+            }
+            enviado += bloque;
+            while (puerto.getBytesLeidos() - base < enviado) {
+                if (puerto.leerLinea(&linea)) {
+                    lineas++;
+                } else if (!puerto.esperarDatos(1000)) {
+                    return lineas; // El puerto dejó de entregar datos
+                }
+            }
+        }
+        while (puerto.leerLinea(&linea)) {
+            lineas++;
+        }
+        return lineas;
+    });
+    // Terminar la línea parcial que pudo quedar en el buffer del puerto
+    VistaLinea linea;
+    escribirTodo(maestro, "\n", 1);
+    puerto.esperarDatos(100);
+    while (puerto.leerLinea(&linea)) {
+    }
+
+    if (latencia) {
+        // Latencia: del write() en el maestro a que leerLinea() entrega la línea
+        double* muestras = (double*)malloc(sizeof(double) * MUESTRAS_LATENCIA);
+        int tomadas = 0;
+        char trama[LONGITUD_MAXIMA_LINEA + 2];
+        for (int i = 0; i < MUESTRAS_LATENCIA && p.numLineas > 0; ++i) {
+            const VistaLinea& original = p.lineas[(size_t)i % p.numLineas];
+            memcpy(trama, original.datos, original.longitud);
+            trama[original.longitud] = '\n';
+            auto inicio = std::chrono::steady_clock::now();
+            if (!escribirTodo(maestro, trama, original.longitud + 1)) {
+                break;
+            }
+            bool recibida = false;
+            while (!(recibida = puerto.leerLinea(&linea)) && puerto.esperarDatos(1000)) {
+            }
+            if (!recibida) {
+                break;
+            }
+            muestras[tomadas++] = nanosegundosDesde(inicio);
+        }
+        registrarResultado(banco, "serial.pty.latencia", "ns", (unsigned long long)tomadas, 0, muestras, tomadas);
+        free(muestras);
+    }
+    puerto.close();
+    close(maestro);
+    std::cout.clear();
+}
+
+/**
+ * @brief Tiempo de CPU del hilo actual (usuario y sistema), en nanosegundos.
+ */
+static double nanosegundosCpuHilo() {
+    struct timespec t;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t);
+    return (double)t.tv_sec * 1e9 + (double)t.tv_nsec;
+}
+
+/**
+ * @brief Mide la CPU que gasta el bucle de lectura con el puerto en reposo.
+ *
+ * Por cada repetición, deja el bucle de main() (leerLinea() y, si no hay línea,
+ * esperarDatos(-1)) esperando VENTANA_REPOSO_MS sin que llegue nada, y registra la
+ * CPU del hilo lector en nanosegundos por segundo de reposo. Un hilo aparte termina la
+ * ventana con despertar(); en el modo de sondeo la lectura ya vuelve cada VTIME.
+ *
+ * @param eventos `true` para esperar con poll(), `false` para sondear con VTIME.
+ */
+static void medirReposoSerial(Banco* banco, bool eventos) {
+    const char* nombre = eventos ? "serial.pty.reposo.eventos" : "serial.pty.reposo.sondeo";
+    if (!seleccionada(*banco, nombre)) {
+        return;
+    }
+    std::cout.setstate(std::ios::failbit);
+    SerialPort puerto;
+    puerto.setModoEventos(eventos);
+    int maestro = abrirPuertoSimulado(&puerto);
+    if (maestro < 0) {
+        std::cout.clear();
+        fprintf(stderr, "No se pudo abrir una pseudo-terminal; se omite %s\n", nombre);
+        return;
+    }
+
+    double* muestras = (double*)malloc(sizeof(double) * (size_t)banco->repeticiones);
+    for (int i = 0; i < banco->repeticiones; ++i) {
+        std::atomic<bool> terminar(false);
+        std::thread alarma([&]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(VENTANA_REPOSO_MS));
+            terminar.store(true);
+            puerto.despertar();
+        });
+        auto inicio = std::chrono::steady_clock::now();
+        double cpuInicial = nanosegundosCpuHilo();
+        VistaLinea linea;
+        while (!terminar.load()) {
+            if (!puerto.leerLinea(&linea)) {
+                puerto.esperarDatos(-1);
+            }
+        }
+        double cpu = nanosegundosCpuHilo() - cpuInicial;
+        double segundos = nanosegundosDesde(inicio) / 1e9;
+        alarma.join();
+        muestras[i] = cpu / segundos;
+    }
+    registrarResultado(banco, nombre, "ns/s", (unsigned long long)banco->repeticiones, 0, muestras,
+                       banco->repeticiones);
+    free(muestras);
+    fprintf(stderr, "    (%lu lecturas del puerto en %d ventanas de %d ms)\n", puerto.getLecturas(),
+            banco->repeticiones, VENTANA_REPOSO_MS);
+    puerto.close();
+    close(maestro);
+    std::cout.clear();
+}
+#endif
+
+/**
+ * @brief Escribe los resultados en JSON.
+ */
+static void escribirJson(FILE* salida, const Banco& banco, const TramasPreparadas& p) {
+    const ConfiguracionGenerador& c = banco.configuracion;
+    fprintf(salida, "{\n");
+    fprintf(salida, "  \"banco\": \"prt7_bench\",\n");
+    fprintf(salida, "  \"version\": 1,\n");
+    fprintf(salida, "  \"configuracion\": {\"semilla\": %llu, \"bytes\": %llu, \"cargas\": %.4f, "
+                    "\"rotacion\": \"%s\", \"rotacion_maxima\": %d, \"fin_de_linea\": \"%s\", "
+                    "\"ruido\": %.4f, \"repeticiones\": %d},\n",
+            (unsigned long long)c.semilla, (unsigned long long)c.bytes, c.proporcionCargas,
+            nombreDistribucion(c.distribucion), c.rotacionMaxima, nombreFinDeLinea(c.finDeLinea), c.proporcionRuido,
+            banco.repeticiones);
+    fprintf(salida, "  \"entorno\": {\"rotor\": \"%s\", \"divisor\": \"%s\", \"hilos\": %u},\n",
+            implementacionRotor(), implementacionDivisor(), std::thread::hardware_concurrency());
+    fprintf(salida, "  \"flujo\": {\"bytes\": %llu, \"lineas\": %llu, \"tramas\": %llu, \"caracteres\": %llu},\n",
+            (unsigned long long)p.longitud, (unsigned long long)p.numLineas, (unsigned long long)p.numTramas,
+            (unsigned long long)p.longitudEsperado);
+    fprintf(salida, "  \"verificado\": %s,\n", banco.verificado ? "true" : "false");
+    fprintf(salida, "  \"resultados\": [");
+    for (int i = 0; i < banco.numResultados; ++i) {
+        const ResultadoBanco& r = banco.resultados[i];
+        fprintf(salida, "%s\n    {\"nombre\": \"%s\", \"unidad\": \"%s\", \"operaciones\": %llu, "
+                        "\"minimo\": %.3f, \"mediana\": %.3f, \"p99\": %.3f, \"maximo\": %.3f",
+                i > 0 ? "," : "", r.nombre, r.unidad, r.operaciones, r.minimo, r.mediana, r.p99, r.maximo);
+        if (r.hilos > 0) {
+            fprintf(salida, ", \"hilos\": %d", r.hilos);
+        }
+        if (r.bytes > 0 && strcmp(r.unidad, "ns") != 0) {
+            // Rendimiento de la mediana: bytes de una repetición sobre su duración
+            double nanosegundos = r.mediana * (double)r.operaciones;
+            fprintf(salida, ", \"mb_s\": %.2f", nanosegundos > 0 ? (double)r.bytes * 1000.0 / nanosegundos : 0.0);
+        }
+        fprintf(salida, "}");
+    }
+    fprintf(salida, "\n  ]\n}\n");
+}
+
+/**
+ * @brief Punto de entrada de `prt7_bench`.
+ */
+int main(int argc, char* argv[]) {
+    Banco* banco = new Banco();
+    banco->repeticiones = 5;
+    banco->filtro = nullptr;
+    banco->numResultados = 0;
+    banco->hilosMedicion = 0;
+    banco->verificado = true;
+    const char* rutaSalida = nullptr;
+    const char* rutaFlujo = nullptr;
+    if (!leerOpciones(argc, argv, banco, &rutaSalida, &rutaFlujo)) {
+        mostrarUso(argv[0]);
+        delete banco;
+        return 1;
+    }
+
+    auto inicioGenerador = std::chrono::steady_clock::now();
+    size_t longitud = 0;
+    char* flujo = GeneradorTramas::generar(banco->configuracion, &longitud);
+    if (flujo == nullptr) {
+        fprintf(stderr, "ERROR: No hay memoria para un flujo de %llu bytes.\n", (unsigned long long)banco->configuracion.bytes);
+        delete banco;
+        return 1;
+    }
+    double msGenerador = nanosegundosDesde(inicioGenerador) / 1e6;
+    if (rutaFlujo != nullptr) {
+        FILE* archivo = fopen(rutaFlujo, "wb");
+        bool correcto = archivo != nullptr && fwrite(flujo, 1, longitud, archivo) == longitud;
+        correcto = archivo != nullptr && fclose(archivo) == 0 && correcto;
+        fprintf(stderr, "%s: %llu bytes generados en %.1f ms.\n", rutaFlujo, (unsigned long long)longitud, msGenerador);
+        free(flujo);
+        delete banco;
+        return correcto ? 0 : 1;
+    }
+
+    TramasPreparadas preparadas;
+    if (!prepararTramas(flujo, longitud, &preparadas)) {
+        fprintf(stderr, "ERROR: No hay memoria para clasificar el flujo.\n");
+        free(flujo);
+        delete banco;
+        return 1;
+    }
+    fprintf(stderr, "Flujo sintético: %llu bytes, %llu líneas, %llu caracteres (semilla %llu, %.1f ms).\n",
+            (unsigned long long)longitud, (unsigned long long)preparadas.numLineas,
+            (unsigned long long)preparadas.longitudEsperado, (unsigned long long)banco->configuracion.semilla, msGenerador);
+
+    medir(banco, "generador.generar", longitud, longitud, [&]() {
+        size_t n = 0;
+        char* otro = GeneradorTramas::generar(banco->configuracion, &n);
+        free(otro);
+        return (unsigned long long)n;
+    });
+    medirComponentes(banco, preparadas);
+    medirAlfabetos(banco, preparadas);
+    medirParser(banco, preparadas);
+    medirEnlace(banco, preparadas);
+    medirRecorridos(banco, preparadas);
+#ifndef _WIN32
+    medirPuertoSerial(banco, preparadas);
+    medirReposoSerial(banco, true);
+    medirReposoSerial(banco, false);
+#endif
+
+    FILE* salida = rutaSalida != nullptr ? fopen(rutaSalida, "w") : stdout;
+    if (salida == nullptr) {
+        fprintf(stderr, "ERROR: No se pudo crear %s\n", rutaSalida);
+    } else {
+        escribirJson(salida, *banco, preparadas);
+        if (salida != stdout) {
+            fclose(salida);
+        }
+    }
+    bool verificado = banco->verificado;
+
+    free(preparadas.esperado);
+    free(preparadas.cargas);
+    free(preparadas.rotaciones);
+    free(preparadas.tramas);
+    free(preparadas.lineas);
+    free(flujo);
+    delete banco;
+    return (salida != nullptr && verificado) ? 0 : 1;
+}
@@ -14,18 +14,182 @@ const char* tramas[] = {
     nullptr
 };
 
+// Formato binario (ver TramaBinaria.h en el decodificador):
+//   A5 | encabezado | carga útil | CRC-8 (polinomio 0x07) de encabezado y carga útil
+// Se activa solo si el decodificador envía la línea "H,B,<baudios>"; si no, se usa ASCII.
+const long BAUDIOS_ASCII = 9600;
+const unsigned long ESPERA_SALUDO_MS = 3000;
+const unsigned long PAUSA_TRAMA_MS = 1000;
+const uint8_t SINCRONIA = 0xA5;
+const uint8_t MAXIMO_RACHA = 64;
+
+// En ASCII, enviar cada trama como "F,<seq>,<trama>,<crc>" (decodificar con --secuencia).
+const bool TRAMAS_SECUENCIADAS = false;
+
+bool modoBinario = false;
+uint16_t secuencia = 0;
+char lineaSaludo[24];
+uint8_t longitudSaludo = 0;
+
+uint8_t crc8(const uint8_t* datos, uint8_t longitud) {
+    uint8_t crc = 0;
+    for (uint8_t i = 0; i < longitud; i++) {
+        crc ^= datos[i];
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// Agrega la sincronía y el CRC a una trama con el encabezado en trama[1] y la envía.
+void enviarTrama(uint8_t* trama, uint8_t cargaUtil) {
+    trama[0] = SINCRONIA;
+    trama[2 + cargaUtil] = crc8(trama + 1, 1 + cargaUtil);
+    Serial.write(trama, 3 + cargaUtil);
+}
+
+// Racha de tramas LOAD: 5 bits por carácter si todos son A-Z o espacio; si no, un byte por carácter.
+void enviarCargas(const char* datos, uint8_t longitud) {
+    uint8_t trama[3 + MAXIMO_RACHA];
+    bool empacable = true;
+    for (uint8_t i = 0; i < longitud; i++) {
+        if (!((datos[i] >= 'A' && datos[i] <= 'Z') || datos[i] == ' ')) {
+            empacable = false;
+        }
+    }
+
+    if (!empacable) {
+        trama[1] = (uint8_t)(0x80 | (longitud - 1));
+        memcpy(trama + 2, datos, longitud);
+        enviarTrama(trama, longitud);
+        return;
+    }
+
+    trama[1] = (uint8_t)(longitud - 1);
+    uint16_t acumulador = 0;
+    uint8_t bits = 0;
+    uint8_t escrito = 0;
+    for (uint8_t i = 0; i < longitud; i++) {
+        uint8_t simbolo = datos[i] == ' ' ? 26 : (uint8_t)(datos[i] - 'A');
+        acumulador |= (uint16_t)simbolo << bits;
+        bits += 5;
+        while (bits >= 8) {
+            trama[2 + escrito++] = (uint8_t)(acumulador & 0xFF);
+            acumulador >>= 8;
+            bits -= 8;
+        }
+    }
+    if (bits > 0) {
+        trama[2 + escrito++] = (uint8_t)acumulador;
+    }
+    enviarTrama(trama, escrito);
+}
+
+// Trama MAP para el rotor 0: rotación de 1 byte si cabe, de 4 bytes si no.
+void enviarMapa(long rotacion) {
+    uint8_t trama[7];
+    if (rotacion >= -128 && rotacion <= 127) {
+        trama[1] = 0x40;
+        trama[2] = (uint8_t)(int8_t)rotacion;
+        enviarTrama(trama, 1);
+        return;
+    }
+    trama[1] = 0x60;
+    for (uint8_t i = 0; i < 4; i++) {
+        trama[2 + i] = (uint8_t)((unsigned long)rotacion >> (8 * i));
+    }
+    enviarTrama(trama, 4);
+}
+
+// Trama ASCII, con número de secuencia y CRC (en hexadecimal) si TRAMAS_SECUENCIADAS.
+void enviarLinea(const char* trama) {
+    if (!TRAMAS_SECUENCIADAS) {
+        Serial.println(trama);
+        return;
+    }
+    char linea[40];
+    int longitud = snprintf(linea, sizeof(linea), "F,%u,%s", (unsigned int)secuencia++, trama);
+    uint8_t crc = crc8((const uint8_t*)linea, (uint8_t)longitud);
+    snprintf(linea + longitud, sizeof(linea) - longitud, ",%02X", crc);
+    Serial.println(linea);
+}
+
+// Lee sin bloquear lo que haya llegado; al completar "H,B,<baudios>" responde y cambia de velocidad.
+bool atenderSaludo() {
+    while (Serial.available() > 0) {
+        char c = (char)Serial.read();
+        if (c == '\r') {
+            continue;
+        }
+        if (c != '\n') {
+            if (longitudSaludo < sizeof(lineaSaludo) - 1) {
+                lineaSaludo[longitudSaludo++] = c;
+            }
+            continue;
+        }
+        lineaSaludo[longitudSaludo] = '\0';
+        longitudSaludo = 0;
+        if (strncmp(lineaSaludo, "H,B,", 4) != 0) {
+            continue;
+        }
+        long baudios = atol(lineaSaludo + 4);
+        if (baudios <= 0) {
+            continue;
+        }
+        Serial.print("H,OK,");
+        Serial.println(baudios);
+        Serial.flush();       // Terminar de enviar la respuesta a la velocidad vieja
+        Serial.end();
+        Serial.begin(baudios);
+        delay(100);           // Dar tiempo al decodificador para cambiar su velocidad
+        modoBinario = true;
+        return true;
+    }
+    return false;
+}
+
 void setup() {
-    Serial.begin(9600);
+    Serial.begin(BAUDIOS_ASCII);
     while (!Serial) {
         ;
     }
-    delay(1000);
+    // Esperar un posible saludo antes de empezar a enviar (el decodificador lo manda al conectarse)
+    unsigned long inicio = millis();
+    while (millis() - inicio < ESPERA_SALUDO_MS && !atenderSaludo()) {
+        ;
+    }
 }
 
 void loop() {
+    if (!modoBinario) {
+        for (int i = 0; tramas[i] != nullptr; i++) {
+            enviarLinea(tramas[i]);
+            delay(PAUSA_TRAMA_MS);
+            if (atenderSaludo()) {
+                return; // Seguir en binario desde el principio del mensaje
+            }
+        }
+        delay(5000);
+        return;
+    }
+
+    // En binario, cada racha de tramas LOAD consecutivas viaja en una sola trama
+    char racha[MAXIMO_RACHA];
+    uint8_t longitud = 0;
     for (int i = 0; tramas[i] != nullptr; i++) {
-        Serial.println(tramas[i]);
-        delay(1000);
+        if (tramas[i][0] == 'L') {
+            racha[longitud++] = tramas[i][2];
+            bool terminaRacha = tramas[i + 1] == nullptr || tramas[i + 1][0] != 'L' || longitud == MAXIMO_RACHA;
+            if (terminaRacha) {
+                enviarCargas(racha, longitud);
+                longitud = 0;
+                delay(PAUSA_TRAMA_MS);
+            }
+        } else if (tramas[i][0] == 'M') {
+            enviarMapa(atol(tramas[i] + 2));
+            delay(PAUSA_TRAMA_MS);
+        }
     }
     delay(5000);
-}
\ No newline at end of file
+}